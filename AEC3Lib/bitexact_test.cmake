@@ -0,0 +1,20 @@
+# Processes echo2.wav/rec2.wav with the AEC3Lib demo and compares the result
+# with the checked-in output.wav.
+#
+# Usage: cmake -DAEC3LIB=<exe> -DSOURCE_DIR=<AEC3Lib dir> -P bitexact_test.cmake
+
+file(REMOVE output.wav)
+execute_process(
+  COMMAND ${AEC3LIB} ${SOURCE_DIR}/echo2.wav ${SOURCE_DIR}/rec2.wav
+  RESULT_VARIABLE result
+  OUTPUT_QUIET)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "AEC3Lib exited with ${result}")
+endif()
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compare_files output.wav ${SOURCE_DIR}/output.wav
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "output.wav differs from ${SOURCE_DIR}/output.wav")
+endif()
@@ -8,8 +8,18 @@
 
 #include "wave_file.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 void print_progress(int current, int total) {
@@ -29,19 +39,34 @@ void print_progress(int current, int total) {
     std::cout << "\r";
 }
 
-int main(int argc, char* argv[]) {
-    //const char* audio_file_1 = "echo2.wav";
-    //const char* audio_file_2 = "rec2.wav";
+// One (render, capture, output) triple of the batch manifest.
+struct BatchJob {
+    std::string render_file;
+    std::string capture_file;
+    std::string output_file;
+};
+
+// Result of processing one file pair.
+struct FileStats {
+    bool ok = false;
+    double audio_seconds = 0.0;
+    double processing_seconds = 0.0;
+};
 
-   char* audio_file_1 = argv[1];
-   char* audio_file_2 = argv[2];
+// Runs the echo canceller over a far-end/near-end file pair and writes the
+// processed near-end signal to `output_file`. Each call uses its own
+// EchoCanceller3 instance, so calls may run concurrently.
+FileStats process_file(const char* render_file, const char* capture_file,
+                       const char* output_file, bool show_progress) {
+    FileStats stats;
+    const auto start_time = std::chrono::steady_clock::now();
 
     WavReader wav_reader1;
     WavReader wav_reader2;
 
-    if (!wav_reader1.Open(audio_file_1) || !wav_reader2.Open(audio_file_2)) {
-        std::cerr << "Error opening audio files." << std::endl;
-        return 1;
+    if (!wav_reader1.Open(render_file) || !wav_reader2.Open(capture_file)) {
+        std::cerr << "Error opening " << render_file << " or " << capture_file << "." << std::endl;
+        return stats;
     }
 
     int sample_rate1 = wav_reader1.SampleRate();
@@ -56,13 +81,13 @@ int main(int argc, char* argv[]) {
 
     if (num_channels1 != num_channels2 || sample_rate1 != sample_rate2 || bits_per_sample1 != bits_per_sample2) {
         std::cerr << "ref file format != rec file format" << std::endl;
-        return -1;
+        return stats;
     }
 
     int audio1_samples = num_samples1;
     int audio2_samples = num_samples2;
     int samples_per_frame = sample_rate1 * num_channels1 / 100;
-    int total = audio1_samples > audio2_samples ? audio2_samples / samples_per_frame: 
+    int total = audio1_samples > audio2_samples ? audio2_samples / samples_per_frame:
         audio1_samples / samples_per_frame;
 
     webrtc::EchoCanceller3Config config;
@@ -87,17 +112,24 @@ int main(int argc, char* argv[]) {
         kLinearOutputRateHz, stream_config.num_channels());
     webrtc::StreamConfig output_config(sample_rate1, num_channels1);
 
-    WavWriter output_file;
-    output_file.Open("output.wav", sample_rate1, num_channels1, bits_per_sample1, FormatTag_PCM);
+    WavWriter output_wav;
+    if (!output_wav.Open(output_file, sample_rate1, num_channels1, bits_per_sample1, FormatTag_PCM)) {
+        std::cerr << "Error opening " << output_file << "." << std::endl;
+        return stats;
+    }
 
-    short* audio_data1 = new short[samples_per_frame];
-    short* audio_data2 = new short[samples_per_frame];
+    // The input frames are read directly from the mapped files.
+    const short* audio_data1 = nullptr;
+    const short* audio_data2 = nullptr;
+    std::vector<short> output_data(samples_per_frame);
 
     int current = 0;
     while (current++ < total) {
-        print_progress(current, total);
-        wav_reader1.Read(audio_data1, samples_per_frame);
-        wav_reader2.Read(audio_data2, samples_per_frame);
+        if (show_progress) {
+            print_progress(current, total);
+        }
+        wav_reader1.NextFrame(&audio_data1, samples_per_frame);
+        wav_reader2.NextFrame(&audio_data2, samples_per_frame);
 
         audio_buffer1->CopyFrom(audio_data1, stream_config);
         audio_buffer2->CopyFrom(audio_data2, stream_config);
@@ -113,16 +145,131 @@ int main(int argc, char* argv[]) {
         aec3->ProcessCapture(audio_buffer2.get(), aec_linear_audio.get(), false);
         audio_buffer2->MergeFrequencyBands();
 
-        audio_buffer2->CopyTo(output_config, audio_data2);
-        output_file.Write(audio_data2, samples_per_frame);
+        audio_buffer2->CopyTo(output_config, output_data.data());
+        output_wav.Write(output_data.data(), samples_per_frame);
 
     }
 
-    output_file.Close();
+    output_wav.Close();
     wav_reader1.Close();
     wav_reader2.Close();
-    delete[] audio_data1;
-    delete[] audio_data2;
 
-    return 0;
+    stats.ok = true;
+    stats.audio_seconds = total * 0.01;
+    stats.processing_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    return stats;
+}
+
+// Reads a manifest with one "render capture output" triple per line. Empty
+// lines and lines starting with '#' are ignored.
+bool read_manifest(const char* manifest_file, std::vector<BatchJob>* jobs) {
+    std::ifstream manifest(manifest_file);
+    if (!manifest) {
+        std::cerr << "Error opening manifest " << manifest_file << "." << std::endl;
+        return false;
+    }
+    std::string line;
+    int line_number = 0;
+    while (std::getline(manifest, line)) {
+        ++line_number;
+        std::istringstream fields(line);
+        BatchJob job;
+        if (!(fields >> job.render_file) || job.render_file[0] == '#') {
+            continue;
+        }
+        if (!(fields >> job.capture_file >> job.output_file)) {
+            std::cerr << manifest_file << ":" << line_number
+                      << ": expected render, capture and output files." << std::endl;
+            return false;
+        }
+        jobs->push_back(job);
+    }
+    return true;
+}
+
+// Processes the manifest entries concurrently, each on its own
+// EchoCanceller3 instance, and reports the per-file real-time factor and the
+// aggregate throughput.
+int run_batch(const char* manifest_file, int num_threads) {
+    std::vector<BatchJob> jobs;
+    if (!read_manifest(manifest_file, &jobs)) {
+        return 1;
+    }
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::max(1, std::min(num_threads, static_cast<int>(jobs.size())));
+
+    std::vector<FileStats> stats(jobs.size());
+    std::atomic<size_t> next_job(0);
+    std::mutex output_mutex;
+    const auto start_time = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+            const BatchJob& job = jobs[i];
+            stats[i] = process_file(job.render_file.c_str(), job.capture_file.c_str(),
+                                    job.output_file.c_str(), false);
+            std::lock_guard<std::mutex> lock(output_mutex);
+            if (!stats[i].ok) {
+                std::cout << "FAILED " << job.output_file << std::endl;
+                continue;
+            }
+            std::cout << job.output_file << ": " << stats[i].audio_seconds << " s audio, "
+                      << stats[i].processing_seconds << " s, RTF "
+                      << stats[i].processing_seconds / std::max(stats[i].audio_seconds, 1e-9)
+                      << std::endl;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const double wall_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    int num_failed = 0;
+    double audio_seconds = 0.0;
+    for (const FileStats& file_stats : stats) {
+        num_failed += file_stats.ok ? 0 : 1;
+        audio_seconds += file_stats.audio_seconds;
+    }
+    std::cout << "Processed " << jobs.size() - num_failed << "/" << jobs.size()
+              << " files on " << num_threads << " threads in " << wall_seconds << " s: "
+              << audio_seconds << " s audio, "
+              << audio_seconds / std::max(wall_seconds, 1e-9) << "x real time, "
+              << (jobs.size() - num_failed) / std::max(wall_seconds, 1e-9) << " files/s"
+              << std::endl;
+    return num_failed == 0 ? 0 : 1;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " render.wav capture.wav [output.wav]" << std::endl
+              << "       " << program << " --batch manifest.txt [--threads N]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--batch") == 0) {
+        int num_threads = 0;
+        if (argc == 5 && strcmp(argv[3], "--threads") == 0) {
+            num_threads = atoi(argv[4]);
+        } else if (argc != 3) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return run_batch(argv[2], num_threads);
+    }
+    if (argc != 3 && argc != 4) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* output_file = argc == 4 ? argv[3] : "output.wav";
+    FileStats stats = process_file(argv[1], argv[2], output_file, true);
+    return stats.ok ? 0 : 1;
 }
@@ -1,16 +1,120 @@
 #include "wave_file.h"
 #include <cassert>
+#include <cstring>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-#define MakeFourCc(inChar0, inChar1, inChar2, inChar3)                  \
-  ((uint32_t)(uint8_t)(inChar3) | ((uint32_t)(uint8_t)(inChar2) << 8) | \
-   ((uint32_t)(uint8_t)(inChar1) << 16) |                               \
-   ((uint32_t)(uint8_t)(inChar0) << 24))
+namespace {
+
+const size_t kWavHeaderSize = 44;
+
+uint32_t readUint32(const uint8_t* inData)
+{
+    return (uint32_t)inData[0] | ((uint32_t)inData[1] << 8) |
+        ((uint32_t)inData[2] << 16) | ((uint32_t)inData[3] << 24);
+}
+
+uint16_t readUint16(const uint8_t* inData)
+{
+    return (uint16_t)(inData[0] | (inData[1] << 8));
+}
+
+bool isFourCc(const uint8_t* inData, const char* inStr)
+{
+    return 0 == memcmp(inData, inStr, 4);
+}
+
+uint8_t* writeString(uint8_t* outData, const char* inStr)
+{
+    memcpy(outData, inStr, 4);
+    return outData + 4;
+}
+
+uint8_t* writeInt32(uint8_t* outData, uint32_t inValue)
+{
+    outData[0] = (inValue >> 0) & 0xff;
+    outData[1] = (inValue >> 8) & 0xff;
+    outData[2] = (inValue >> 16) & 0xff;
+    outData[3] = (inValue >> 24) & 0xff;
+    return outData + 4;
+}
+
+uint8_t* writeInt16(uint8_t* outData, int inValue)
+{
+    outData[0] = (inValue >> 0) & 0xff;
+    outData[1] = (inValue >> 8) & 0xff;
+    return outData + 2;
+}
+
+// Maps the whole file read-only. Returns nullptr on failure.
+const uint8_t* mapFile(const char* inFileName, size_t* outSize)
+{
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(inFileName, GENERIC_READ, FILE_SHARE_READ,
+        NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (INVALID_HANDLE_VALUE == hFile) return nullptr;
+    LARGE_INTEGER nSize;
+    if (!GetFileSizeEx(hFile, &nSize) || 0 == nSize.QuadPart)
+    {
+        CloseHandle(hFile);
+        return nullptr;
+    }
+    HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0,
+        NULL);
+    CloseHandle(hFile);
+    if (NULL == hMapping) return nullptr;
+    // The view keeps the mapping alive after the handle is closed.
+    void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping);
+    if (NULL == pView) return nullptr;
+    *outSize = (size_t)nSize.QuadPart;
+    return (const uint8_t*)pView;
+#else
+    int fd = open(inFileName, O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (0 != fstat(fd, &st) || 0 == st.st_size)
+    {
+        close(fd);
+        return nullptr;
+    }
+    void* pView = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+        fd, 0);
+    close(fd);
+    if (MAP_FAILED == pView) return nullptr;
+    // The samples are read front to back.
+    madvise(pView, (size_t)st.st_size, MADV_SEQUENTIAL);
+    *outSize = (size_t)st.st_size;
+    return (const uint8_t*)pView;
+#endif
+}
+
+void unmapFile(const uint8_t* inData, size_t inSize)
+{
+#ifdef _WIN32
+    (void)inSize;
+    UnmapViewOfFile(inData);
+#else
+    munmap((void*)inData, inSize);
+#endif
+}
+
+}  // namespace
 
 WavReader::WavReader()
-    : m_pFile(0)
+    : m_pMapping(nullptr)
+    , m_nMappingSize(0)
+    , m_pSamples(nullptr)
+    , m_nPosition(0)
     , m_nLength(0)
-    , m_nStart(0)
+    , m_nFactLength(0)
     , m_nFormatTag(0)
     , m_nChannels(0)
     , m_nSampleRate(0)
@@ -27,115 +131,159 @@ WavReader::~WavReader()
 
 bool WavReader::Open(const char* inFileName)
 {
-    m_pFile = fopen(inFileName, "rb");
-    if (!m_pFile) return false;
-    fseek(m_pFile, 0, SEEK_END);
-    int nTotal = ftell(m_pFile);
-    assert(0 != nTotal);
-    fseek(m_pFile, 0, SEEK_SET);
+    Close();
+    m_pMapping = mapFile(inFileName, &m_nMappingSize);
+    if (!m_pMapping) return false;
 
-    if (MakeFourCc('R', 'I', 'F', 'F') != readString())
+    if (!parseChunks(m_pMapping, m_nMappingSize))
     {
+        Close();
         return false;
     }
-    uint32_t nFmtLen = readInt32();
+    return true;
+}
 
-    if (MakeFourCc('W', 'A', 'V', 'E') != readString())
+bool WavReader::parseChunks(const uint8_t* inData, size_t inSize)
+{
+    if (inSize < 12 || !isFourCc(inData, "RIFF") ||
+        !isFourCc(inData + 8, "WAVE"))
     {
         return false;
     }
 
-    int nRet = fseek(m_pFile, 16, SEEK_SET);
-    assert(0 == nRet);
-    if (0 != nRet)
+    // Walk the chunks up to the data chunk. Chunks that are not needed, such
+    // as LIST, are skipped.
+    bool bHasFormat = false;
+    size_t nOffset = 12;
+    while (nOffset + 8 <= inSize)
     {
-        Close();
-        return false;
-    }
-    nFmtLen = readInt32();
-    m_nFormatTag = readInt16();
-    m_nChannels = readInt16();
-    m_nSampleRate = readInt32();
-    m_nAvgBytesPerSec = readInt32();
-    m_nBlockAlign = readInt16();
-    m_nBitsPerSample = readInt16();
-
-    uint32_t data_flags = MakeFourCc('d', 'a', 't', 'a');
-    while (nTotal > 0)
-    {
-        if (data_flags == readString())
+        const uint8_t* pChunk = inData + nOffset;
+        uint32_t nChunkSize = readUint32(pChunk + 4);
+        size_t nAvailable = inSize - nOffset - 8;
+        if (isFourCc(pChunk, "data"))
+        {
+            if (!bHasFormat || m_nBitsPerSample < 8) return false;
+            // Files that were not closed properly may have a chunk size that
+            // exceeds the file.
+            size_t nBytes = nChunkSize < nAvailable ? nChunkSize : nAvailable;
+            m_pSamples = pChunk + 8;
+            m_nLength = (uint32_t)(nBytes / (m_nBitsPerSample / 8));
+            // The sample views require natural alignment, which padded
+            // chunks give for 16-bit samples but not always for 32-bit ones.
+            size_t nAlign = m_nBitsPerSample >= 32 ? 4 : 2;
+            if (0 != (uintptr_t)m_pSamples % nAlign)
+            {
+                m_alignedSamples.resize((nBytes + 3) / 4);
+                memcpy(m_alignedSamples.data(), m_pSamples, nBytes);
+                m_pSamples = (const uint8_t*)m_alignedSamples.data();
+            }
+            return true;
+        }
+        if (nChunkSize > nAvailable) return false;
+        if (isFourCc(pChunk, "fmt "))
         {
-            break;
+            if (!parseFormat(pChunk + 8, nChunkSize)) return false;
+            bHasFormat = true;
         }
-        nRet = fseek(m_pFile, -3, SEEK_CUR);
-        assert(0 == nRet);
-        if (0 != nRet)
+        else if (isFourCc(pChunk, "fact") && nChunkSize >= 4)
         {
-            Close();
-            return false;
+            m_nFactLength = readUint32(pChunk + 8);
         }
-        nTotal--;
+        // Chunks are padded to an even size.
+        nOffset += 8 + (size_t)nChunkSize + (nChunkSize & 1);
+    }
+    return false;
+}
+
+bool WavReader::parseFormat(const uint8_t* inChunk, uint32_t inSize)
+{
+    if (inSize < 16) return false;
+    m_nFormatTag = readUint16(inChunk);
+    m_nChannels = readUint16(inChunk + 2);
+    m_nSampleRate = readUint32(inChunk + 4);
+    m_nAvgBytesPerSec = readUint32(inChunk + 8);
+    m_nBlockAlign = readUint16(inChunk + 12);
+    m_nBitsPerSample = readUint16(inChunk + 14);
+    // WAVE_FORMAT_EXTENSIBLE stores the actual format tag in the first two
+    // bytes of the sub format GUID.
+    if (FormatTag_Extensible == m_nFormatTag && inSize >= 26)
+    {
+        m_nFormatTag = readUint16(inChunk + 24);
     }
-    m_nLength = readInt32() / (m_nBitsPerSample / 8);
-    m_nStart = ftell(m_pFile);
     return true;
 }
 
 void WavReader::Close()
 {
-    if (m_pFile)
+    if (m_pMapping)
     {
-        fclose(m_pFile);
-        m_pFile = 0;
+        unmapFile(m_pMapping, m_nMappingSize);
+        m_pMapping = nullptr;
     }
+    m_nMappingSize = 0;
+    m_pSamples = nullptr;
+    std::vector<uint32_t>().swap(m_alignedSamples);
+    m_nPosition = 0;
+    m_nLength = 0;
+    m_nFactLength = 0;
 }
 
 bool WavReader::IsOpen() {
-    return m_pFile != nullptr;
+    return m_pMapping != nullptr;
 }
 
 bool WavReader::Reset()
 {
-    assert(0 != m_pFile);
-    if (!m_pFile) return false;
+    assert(0 != m_pMapping);
+    if (!m_pMapping) return false;
 
-    return (0 == fseek(m_pFile, m_nStart, SEEK_SET));
+    m_nPosition = 0;
+    return true;
 }
 
-int WavReader::Read(short* ioData, int inLen)
+const uint8_t* WavReader::nextSamples(int inLen, int* outLen)
 {
-    assert(0 != m_pFile);
-    assert(16 == m_nBitsPerSample);
-    return fread(ioData, 2, inLen, m_pFile);
+    assert(0 != m_pMapping);
+    uint32_t nRemaining = m_nLength - m_nPosition;
+    uint32_t nLen = inLen < 0 ? 0 : (uint32_t)inLen;
+    if (nLen > nRemaining) nLen = nRemaining;
+    const uint8_t* pData =
+        m_pSamples + (size_t)m_nPosition * (m_nBitsPerSample / 8);
+    m_nPosition += nLen;
+    *outLen = (int)nLen;
+    return pData;
 }
 
-int WavReader::Read(float* ioData, int inLen)
+int WavReader::NextFrame(const short** outData, int inLen)
 {
-    assert(32 == m_nBitsPerSample);
-
-    fread(ioData, 4, inLen, m_pFile);
-    return inLen;
+    assert(16 == m_nBitsPerSample);
+    int nLen = 0;
+    *outData = (const short*)nextSamples(inLen, &nLen);
+    return nLen;
 }
 
-uint32_t WavReader::readString()
+int WavReader::NextFrame(const float** outData, int inLen)
 {
-    uint8_t nBytes[4];
-    fread(nBytes, 1, 4, m_pFile);
-    return ((nBytes[0] << 24) | (nBytes[1] << 16) | (nBytes[2] << 8) | nBytes[3]);
+    assert(32 == m_nBitsPerSample);
+    int nLen = 0;
+    *outData = (const float*)nextSamples(inLen, &nLen);
+    return nLen;
 }
 
-int WavReader::readInt32()
+int WavReader::Read(short* ioData, int inLen)
 {
-    uint32_t nBytes = 0;
-    fread(&nBytes, 4, 1, m_pFile);
-    return nBytes;
+    const short* pData = nullptr;
+    int nLen = NextFrame(&pData, inLen);
+    memcpy(ioData, pData, nLen * sizeof(short));
+    return nLen;
 }
 
-short WavReader::readInt16()
+int WavReader::Read(float* ioData, int inLen)
 {
-    uint16_t nBytes = 0;
-    fread(&nBytes, 2, 1, m_pFile);
-    return nBytes;
+    const float* pData = nullptr;
+    int nLen = NextFrame(&pData, inLen);
+    memcpy(ioData, pData, nLen * sizeof(float));
+    return nLen;
 }
 
 WavWriter::WavWriter()
@@ -159,8 +307,12 @@ bool WavWriter::Open(const char* inFileName,
     short inBitsPerSamples,
     short inFormatTag)
 {
+    Close();
     m_pFile = fopen(inFileName, "wb");
     if (m_pFile == NULL) return false;
+    // The buffer must be set before the first write and outlive the file.
+    if (!m_pBuffer) m_pBuffer.reset(new char[kWriteBufferSize]);
+    setvbuf(m_pFile, m_pBuffer.get(), _IOFBF, kWriteBufferSize);
     m_nDataLen = 0;
 
     m_nSampleRate = inSampleRate;
@@ -188,18 +340,18 @@ bool WavWriter::IsOpen() {
     return m_pFile != NULL;
 }
 
-void WavWriter::Write(short* inData, int inLen)
+void WavWriter::Write(const short* inData, int inLen)
 {
     assert(0 != m_pFile);
     assert(16 == m_nBitsPerSamples);
     assert(FormatTag_PCM == m_nFormatTag);
 
     if (m_pFile == NULL) return;
-    fwrite(inData, inLen, 2, m_pFile);
+    fwrite(inData, 2, inLen, m_pFile);
     m_nDataLen += inLen * 2;
 }
 
-void WavWriter::Write(float* inData, int inLen)
+void WavWriter::Write(const float* inData, int inLen)
 {
     assert(0 != m_pFile);
     assert(32 == m_nBitsPerSamples);
@@ -210,46 +362,28 @@ void WavWriter::Write(float* inData, int inLen)
     m_nDataLen += inLen * 4;
 }
 
-void WavWriter::writeString(const char* inStr)
-{
-    fputc(inStr[0], m_pFile);
-    fputc(inStr[1], m_pFile);
-    fputc(inStr[2], m_pFile);
-    fputc(inStr[3], m_pFile);
-}
-
-void WavWriter::writeInt32(int inValue)
+void WavWriter::writeHeader(uint32_t inLen)
 {
-    fputc((inValue >> 0) & 0xff, m_pFile);
-    fputc((inValue >> 8) & 0xff, m_pFile);
-    fputc((inValue >> 16) & 0xff, m_pFile);
-    fputc((inValue >> 24) & 0xff, m_pFile);
-}
+    uint8_t header[kWavHeaderSize];
+    uint8_t* p = header;
+    p = writeString(p, "RIFF");
+    p = writeInt32(p, 4 + 8 + 16 + 8 + inLen);
+    p = writeString(p, "WAVE");
 
-void WavWriter::writeInt16(int inValue)
-{
-    fputc((inValue >> 0) & 0xff, m_pFile);
-    fputc((inValue >> 8) & 0xff, m_pFile);
-}
-
-void WavWriter::writeHeader(int inLen)
-{
-    writeString("RIFF");
-    writeInt32(4 + 8 + 16 + 8 + inLen);
-    writeString("WAVE");
-
-    writeString("fmt ");
-    writeInt32(16);
+    p = writeString(p, "fmt ");
+    p = writeInt32(p, 16);
 
     int nBytesPerFrame = m_nBitsPerSamples / 8 * m_nChannels;
 
-    writeInt16(m_nFormatTag);                   // Format
-    writeInt16(m_nChannels);                    // Channels
-    writeInt32(m_nSampleRate);                  // Samplerate
-    writeInt32(nBytesPerFrame * m_nSampleRate);   // Bytes per sec
-    writeInt16(nBytesPerFrame);                 // Bytes per frame
-    writeInt16(m_nBitsPerSamples);              // Bits per sample
-
-    writeString("data");
-    writeInt32(inLen);
+    p = writeInt16(p, m_nFormatTag);                   // Format
+    p = writeInt16(p, m_nChannels);                    // Channels
+    p = writeInt32(p, m_nSampleRate);                  // Samplerate
+    p = writeInt32(p, nBytesPerFrame * m_nSampleRate); // Bytes per sec
+    p = writeInt16(p, nBytesPerFrame);                 // Bytes per frame
+    p = writeInt16(p, m_nBitsPerSamples);              // Bits per sample
+
+    p = writeString(p, "data");
+    p = writeInt32(p, inLen);
+    assert(p == header + kWavHeaderSize);
+    fwrite(header, 1, kWavHeaderSize, m_pFile);
 }
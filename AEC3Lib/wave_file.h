@@ -1,5 +1,8 @@
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
+#include <vector>
 #ifndef WAVFILE_H
 #define WAVFILE_H
 
@@ -37,11 +40,16 @@ typedef enum {
     FormatTag_IBM_u_Law = 0x101,    // IBM u-Law
     FormatTag_IBM_a_Law = 0x102,    // IBM a-Law
     FormatTag_IBM_ADPCM = 0x103,    // IBM ADPCM
+    FormatTag_Extensible = 0xfffe,   // WAVE_FORMAT_EXTENSIBLE
     FormatTag_Dev = 0xffff,   // Development
 } WavFormatTag;
 
 /**
  * @brief   Wavļȡ
+ *
+ * The file is memory mapped on Open(), which parses the RIFF chunks. The
+ * samples of the data chunk are read either by copying, using Read(), or
+ * without copies, using NextFrame(), which returns views into the mapping.
  */
 class WavReader
 {
@@ -56,19 +64,31 @@ public:
     int Read(short* ioData, int inLen);
     int Read(float* ioData, int inLen);
 
+    // Sets outData to a view of the next inLen samples and advances the read
+    // position. Returns the number of samples in the view, which is less than
+    // inLen at the end of the data. The view is valid until Close().
+    int NextFrame(const short** outData, int inLen);
+    int NextFrame(const float** outData, int inLen);
+
     uint16_t FormatTag() { return m_nFormatTag; }
     uint32_t SampleRate() { return m_nSampleRate; }
     uint16_t Channels() { return m_nChannels; }
     uint16_t BitsPerSample() { return m_nBitsPerSample; }
     uint32_t Length() { return m_nLength; }
+    // Number of samples per channel given by the fact chunk, 0 if absent.
+    uint32_t FactLength() { return m_nFactLength; }
 private:
-    uint32_t readString();
-    int readInt32();
-    short readInt16();
+    bool parseChunks(const uint8_t* inData, size_t inSize);
+    bool parseFormat(const uint8_t* inChunk, uint32_t inSize);
+    const uint8_t* nextSamples(int inLen, int* outLen);
 private:
-    FILE* m_pFile;
+    const uint8_t* m_pMapping;  // ļӳ
+    size_t      m_nMappingSize;
+    const uint8_t* m_pSamples;  // data chunk
+    std::vector<uint32_t> m_alignedSamples;  // used if m_pSamples is unaligned
+    uint32_t    m_nPosition;    // ѶȡĲĿ
     uint32_t    m_nLength;      // ļĿ
-    uint32_t    m_nStart;       // ļʼλ
+    uint32_t    m_nFactLength;
     uint16_t    m_nFormatTag;   // format type
     uint16_t    m_nChannels;
     uint32_t    m_nSampleRate;
@@ -79,10 +99,15 @@ private:
 
 /**
  * @brief   Wavļ
+ *
+ * The output is buffered in blocks of kWriteBufferSize bytes, and the header
+ * is written with a single call.
  */
 class WavWriter
 {
 public:
+    static const size_t kWriteBufferSize = 1 << 20;
+
     WavWriter();
     ~WavWriter();
 
@@ -93,19 +118,17 @@ public:
         short inFormatTag = FormatTag_PCM);
     void Close();
     bool IsOpen();
-    void Write(short* inData, int inLen);
-    void Write(float* inData, int inLen);
+    void Write(const short* inData, int inLen);
+    void Write(const float* inData, int inLen);
 
     uint32_t SampleRate() { return m_nSampleRate; }
     uint16_t Channels() { return m_nChannels; }
 private:
-    void writeString(const char* inStr);
-    void writeInt32(int inValue);
-    void writeInt16(int inValue);
-    void writeHeader(int inLength);
+    void writeHeader(uint32_t inLength);
 
     FILE* m_pFile;
-    int m_nDataLen;
+    std::unique_ptr<char[]> m_pBuffer;
+    uint32_t m_nDataLen;
     int m_nSampleRate;
     short m_nBitsPerSamples;
     int m_nChannels;
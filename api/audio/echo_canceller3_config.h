@@ -60,6 +60,17 @@ struct RTC_EXPORT EchoCanceller3Config {
     AlignmentMixing render_alignment_mixing = {false, true, 10000.f, true};
     AlignmentMixing capture_alignment_mixing = {false, true, 10000.f, false};
     bool detect_pre_echo = true;
+    // Uses an FFT cross-correlation over the full delay range to select which
+    // matched filters to update. Once the correlation has a stable peak, only
+    // the filters around it are updated, so that the complexity grows with the
+    // logarithm of the delay range rather than linearly.
+    bool use_fft_matched_filter = false;
+    // Once a reliable delay has been found, only updates the matched filters
+    // around that delay on every sub-block and the remaining filters at a low
+    // rate, or the filters around the candidate lag when
+    // use_fft_matched_filter is set. All filters are updated for a while after
+    // a change of the delay.
+    bool use_matched_filter_tracking = false;
   } delay;
 
   struct Filter {
@@ -221,6 +221,10 @@ void Aec3ConfigFromJsonString(absl::string_view json_string,
     ReadParam(section, "capture_alignment_mixing",
               &cfg.delay.capture_alignment_mixing);
     ReadParam(section, "detect_pre_echo", &cfg.delay.detect_pre_echo);
+    ReadParam(section, "use_fft_matched_filter",
+              &cfg.delay.use_fft_matched_filter);
+    ReadParam(section, "use_matched_filter_tracking",
+              &cfg.delay.use_matched_filter_tracking);
   }
 
   if (rtc::GetValueFromJsonObject(aec3_root, "filter", &section)) {
@@ -508,7 +512,11 @@ std::string Aec3ConfigToJsonString(const EchoCanceller3Config& config) {
               : "false");
   ost << "},";
   ost << "\"detect_pre_echo\": "
-      << (config.delay.detect_pre_echo ? "true" : "false");
+      << (config.delay.detect_pre_echo ? "true" : "false") << ",";
+  ost << "\"use_fft_matched_filter\": "
+      << (config.delay.use_fft_matched_filter ? "true" : "false") << ",";
+  ost << "\"use_matched_filter_tracking\": "
+      << (config.delay.use_matched_filter_tracking ? "true" : "false");
   ost << "},";
 
   ost << "\"filter\": {";
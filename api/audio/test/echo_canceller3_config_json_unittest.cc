@@ -19,6 +19,8 @@ TEST(EchoCanceller3JsonHelpers, ToStringAndParseJson) {
   EchoCanceller3Config cfg;
   cfg.delay.down_sampling_factor = 1u;
   cfg.delay.log_warning_on_delay_changes = true;
+  cfg.delay.use_fft_matched_filter = true;
+  cfg.delay.use_matched_filter_tracking = true;
   cfg.filter.refined.error_floor = 2.f;
   cfg.filter.coarse_initial.length_blocks = 3u;
   cfg.filter.high_pass_filter_echo_reference =
@@ -52,6 +54,10 @@ TEST(EchoCanceller3JsonHelpers, ToStringAndParseJson) {
             cfg_transformed.delay.down_sampling_factor);
   EXPECT_EQ(cfg.delay.log_warning_on_delay_changes,
             cfg_transformed.delay.log_warning_on_delay_changes);
+  EXPECT_EQ(cfg.delay.use_fft_matched_filter,
+            cfg_transformed.delay.use_fft_matched_filter);
+  EXPECT_EQ(cfg.delay.use_matched_filter_tracking,
+            cfg_transformed.delay.use_matched_filter_tracking);
   EXPECT_EQ(cfg.filter.coarse_initial.length_blocks,
             cfg_transformed.filter.coarse_initial.length_blocks);
   EXPECT_EQ(cfg.filter.refined.error_floor,
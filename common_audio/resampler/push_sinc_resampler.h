@@ -49,6 +49,14 @@ class PushSincResampler : public SincResamplerCallback {
                   float* destination,
                   size_t destination_capacity);
 
+  // Lets the resampler use kernels precomputed for the exact sub-sample
+  // offsets of the output samples instead of interpolated kernels, for ratios
+  // like 16 kHz to 48 kHz and 44.1 kHz to 48 kHz. See
+  // SincResampler::SetExactPolyphaseKernels().
+  void SetExactPolyphaseKernels(bool enabled) {
+    resampler_->SetExactPolyphaseKernels(enabled);
+  }
+
   // Delay due to the filter kernel. Essentially, the time after which an input
   // sample will appear in the resampled output.
   static float AlgorithmicDelaySeconds(int source_rate_hz) {
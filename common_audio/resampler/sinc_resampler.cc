@@ -101,6 +101,16 @@ namespace webrtc {
 
 namespace {
 
+// Blackman window parameters.
+constexpr double kAlpha = 0.16;
+constexpr double kA0 = 0.5 * (1.0 - kAlpha);
+constexpr double kA1 = 0.5;
+constexpr double kA2 = 0.5 * kAlpha;
+
+// Largest deviation from an integer of the source advance over the output
+// phases for which the ratio is treated as a fraction.
+constexpr double kMaxPhaseStepError = 1e-6;
+
 double SincScaleFactor(double io_ratio) {
   // `sinc_scale_factor` is basically the normalized cutoff frequency of the
   // low-pass filter.
@@ -120,22 +130,29 @@ double SincScaleFactor(double io_ratio) {
 }  // namespace
 
 const size_t SincResampler::kKernelSize;
+const size_t SincResampler::kMaxNumPhases;
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
 void SincResampler::InitializeCPUSpecificFeatures() {
 #if defined(WEBRTC_HAS_NEON)
   convolve_proc_ = Convolve_NEON;
+  convolve_phase_proc_ = ConvolvePhase_NEON;
 #elif defined(WEBRTC_ARCH_X86_FAMILY)
   // Using AVX2 instead of SSE2 when AVX2/FMA3 supported.
-  if (GetCPUInfo(kAVX2) && GetCPUInfo(kFMA3))
+  if (GetCPUInfo(kAVX2) && GetCPUInfo(kFMA3)) {
     convolve_proc_ = Convolve_AVX2;
-  else if (GetCPUInfo(kSSE2))
+    convolve_phase_proc_ = ConvolvePhase_AVX2;
+  } else if (GetCPUInfo(kSSE2)) {
     convolve_proc_ = Convolve_SSE;
-  else
+    convolve_phase_proc_ = ConvolvePhase_SSE;
+  } else {
     convolve_proc_ = Convolve_C;
+    convolve_phase_proc_ = ConvolvePhase_C;
+  }
 #else
   // Unknown architecture.
   convolve_proc_ = Convolve_C;
+  convolve_phase_proc_ = ConvolvePhase_C;
 #endif
 }
 
@@ -156,6 +173,7 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
       input_buffer_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * input_buffer_size_, 32))),
       convolve_proc_(nullptr),
+      convolve_phase_proc_(nullptr),
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
   InitializeCPUSpecificFeatures();
@@ -172,6 +190,7 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
          sizeof(*kernel_window_storage_.get()) * kKernelStorageSize);
 
   InitializeKernel();
+  ConfigurePolyphase();
 }
 
 SincResampler::~SincResampler() {}
@@ -193,12 +212,6 @@ void SincResampler::UpdateRegions(bool second_load) {
 }
 
 void SincResampler::InitializeKernel() {
-  // Blackman window parameters.
-  static const double kAlpha = 0.16;
-  static const double kA0 = 0.5 * (1.0 - kAlpha);
-  static const double kA1 = 0.5;
-  static const double kA2 = 0.5 * kAlpha;
-
   // Generates a set of windowed sinc() kernels.
   // We generate a range of sub-sample offsets from 0.0 to 1.0.
   const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
@@ -252,6 +265,67 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
                         : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
     }
   }
+  ConfigurePolyphase();
+}
+
+void SincResampler::SetExactPolyphaseKernels(bool enabled) {
+  exact_polyphase_kernels_ = enabled;
+  ConfigurePolyphase();
+}
+
+void SincResampler::ConfigurePolyphase() {
+  num_phases_ = 0;
+  for (size_t num_phases = 1; num_phases <= kMaxNumPhases; ++num_phases) {
+    const double step = io_sample_rate_ratio_ * num_phases;
+    const double rounded_step = round(step);
+    if (rounded_step < 1.0 || fabs(step - rounded_step) > kMaxPhaseStepError) {
+      continue;
+    }
+
+    if (kKernelOffsetCount % num_phases == 0 && step == rounded_step) {
+      // The output samples fall on kernel offsets, for which Resample() would
+      // use a zero interpolation factor.
+      polyphase_kernels_ = kernel_storage_.get();
+      polyphase_kernel_stride_ =
+          kKernelSize * (kKernelOffsetCount / num_phases);
+    } else if (exact_polyphase_kernels_) {
+      if (!polyphase_kernel_storage_) {
+        polyphase_kernel_storage_.reset(static_cast<float*>(
+            AlignedMalloc(sizeof(float) * kKernelSize * kMaxNumPhases, 32)));
+      }
+      // Computes the windowed sinc() kernels as in InitializeKernel(), for the
+      // sub-sample offsets of the output phases.
+      const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
+      for (size_t phase = 0; phase < num_phases; ++phase) {
+        const float subsample_offset =
+            static_cast<float>(phase) / static_cast<float>(num_phases);
+        for (size_t i = 0; i < kKernelSize; ++i) {
+          const float pre_sinc = static_cast<float>(
+              M_PI * (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
+                      subsample_offset));
+          const float x = (i - subsample_offset) / kKernelSize;
+          const float window = static_cast<float>(
+              kA0 - kA1 * cos(2.0 * M_PI * x) + kA2 * cos(4.0 * M_PI * x));
+          polyphase_kernel_storage_[phase * kKernelSize + i] =
+              static_cast<float>(
+                  window *
+                  ((pre_sinc == 0)
+                       ? sinc_scale_factor
+                       : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+        }
+      }
+      polyphase_kernels_ = polyphase_kernel_storage_.get();
+      polyphase_kernel_stride_ = kKernelSize;
+    } else {
+      return;
+    }
+
+    const size_t phases_per_output = static_cast<size_t>(rounded_step);
+    num_phases_ = num_phases;
+    source_step_ = phases_per_output / num_phases;
+    phase_step_ = phases_per_output % num_phases;
+    return;
+  }
 }
 
 void SincResampler::Resample(size_t frames, float* destination) {
@@ -263,6 +337,11 @@ void SincResampler::Resample(size_t frames, float* destination) {
     buffer_primed_ = true;
   }
 
+  if (num_phases_ > 0) {
+    ResamplePolyphase(remaining_frames, destination);
+    return;
+  }
+
   // Step (2) -- Resample!  const what we can outside of the loop for speed.  It
   // actually has an impact on ARM performance.  See inner loop comment below.
   const double current_io_ratio = io_sample_rate_ratio_;
@@ -315,20 +394,61 @@ void SincResampler::Resample(size_t frames, float* destination) {
 
     // Wrap back around to the start.
     virtual_source_idx_ -= block_size_;
+    ReadNextRequest();
+  }
+}
 
-    // Step (3) -- Copy r3_, r4_ to r1_, r2_.
-    // This wraps the last input frames back to the start of the buffer.
-    memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
-
-    // Step (4) -- Reinitialize regions if necessary.
-    if (r0_ == r2_)
-      UpdateRegions(true);
+void SincResampler::ResamplePolyphase(size_t frames, float* destination) {
+  const size_t num_phases = num_phases_;
+  const float* const kernels = polyphase_kernels_;
+  const size_t kernel_stride = polyphase_kernel_stride_;
+
+  // Track the position with integers, which is exact where the
+  // `virtual_source_idx_` arithmetic is exact and otherwise avoids the drift
+  // of the latter. Rounding snaps `virtual_source_idx_` to the nearest phase.
+  const uint64_t position =
+      static_cast<uint64_t>(llround(virtual_source_idx_ * num_phases));
+  size_t source_idx = static_cast<size_t>(position / num_phases);
+  size_t phase = static_cast<size_t>(position % num_phases);
+  while (frames) {
+    while (source_idx < block_size_) {
+      RTC_DCHECK_EQ(
+          0, reinterpret_cast<uintptr_t>(kernels + phase * kernel_stride) % 32);
+      *destination++ = convolve_phase_proc_(r1_ + source_idx,
+                                            kernels + phase * kernel_stride);
+
+      source_idx += source_step_;
+      phase += phase_step_;
+      if (phase >= num_phases) {
+        phase -= num_phases;
+        ++source_idx;
+      }
+
+      if (!--frames) {
+        virtual_source_idx_ =
+            source_idx + static_cast<double>(phase) / num_phases;
+        return;
+      }
+    }
 
-    // Step (5) -- Refresh the buffer with more input.
-    read_cb_->Run(request_frames_, r0_);
+    source_idx -= block_size_;
+    ReadNextRequest();
   }
 }
 
+void SincResampler::ReadNextRequest() {
+  // Step (3) -- Copy r3_, r4_ to r1_, r2_.
+  // This wraps the last input frames back to the start of the buffer.
+  memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
+
+  // Step (4) -- Reinitialize regions if necessary.
+  if (r0_ == r2_)
+    UpdateRegions(true);
+
+  // Step (5) -- Refresh the buffer with more input.
+  read_cb_->Run(request_frames_, r0_);
+}
+
 #undef CONVOLVE_FUNC
 
 size_t SincResampler::ChunkSize() const {
@@ -363,4 +483,13 @@ float SincResampler::Convolve_C(const float* input_ptr,
                             kernel_interpolation_factor * sum2);
 }
 
+float SincResampler::ConvolvePhase_C(const float* input_ptr, const float* k) {
+  float sum = 0;
+  size_t n = kKernelSize;
+  while (n--) {
+    sum += *input_ptr++ * *k++;
+  }
+  return sum;
+}
+
 }  // namespace webrtc
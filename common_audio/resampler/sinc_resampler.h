@@ -52,6 +52,11 @@ class SincResampler {
   static const size_t kKernelStorageSize =
       kKernelSize * (kKernelOffsetCount + 1);
 
+  // Largest number of output phases for which a polyphase kernel bank is
+  // used. Covers the ratios between 8, 16, 32, 44.1 and 48 kHz, e.g., 147:160
+  // for 44.1 kHz to 48 kHz.
+  static const size_t kMaxNumPhases = 160;
+
   // Constructs a SincResampler with the specified `read_cb`, which is used to
   // acquire audio data for resampling.  `io_sample_rate_ratio` is the ratio
   // of input / output sample rates.  `request_frames` controls the size in
@@ -87,15 +92,43 @@ class SincResampler {
   // SincResampler.  We would also need a way to update `request_frames_`.
   void SetRatio(double io_sample_rate_ratio);
 
+  // When the sample rate ratio is a fraction whose output samples fall on
+  // kernel offsets, e.g., 3:1, 2:1 and 3:2, each output sample is computed
+  // with a single kernel instead of interpolating between two kernels. The
+  // output is the same as with the interpolation. When enabled, the same is
+  // done for the other fractions with at most kMaxNumPhases output phases,
+  // e.g., 1:3 and 147:160, with a bank of kernels that is precomputed for the
+  // exact sub-sample offsets. This changes the output slightly and is
+  // disabled by default. Not thread safe, do not call while Resample() is in
+  // progress.
+  void SetExactPolyphaseKernels(bool enabled);
+
+  // Returns the number of output phases when each output sample is computed
+  // with a single kernel, and zero when the kernels are interpolated.
+  size_t num_phases() const { return num_phases_; }
+
   float* get_kernel_for_testing() { return kernel_storage_.get(); }
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolvePhase);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, PolyphaseMatchesInterpolation);
 
   void InitializeKernel();
   void UpdateRegions(bool second_load);
 
+  // Selects whether, and with which kernels, each output sample is computed
+  // with a single kernel for the current ratio.
+  void ConfigurePolyphase();
+
+  // Resamples with one kernel per output phase; used instead of the kernel
+  // interpolation in Resample() when `num_phases_` is non-zero.
+  void ResamplePolyphase(size_t frames, float* destination);
+
+  // Wraps the end of the buffer to its start and reads the next request.
+  void ReadNextRequest();
+
   // Selects runtime specific CPU features like SSE.  Must be called before
   // using SincResampler.
   // TODO(ajm): Currently managed by the class internally. See the note with
@@ -125,6 +158,17 @@ class SincResampler {
                              double kernel_interpolation_factor);
 #endif
 
+  // Compute the convolution of the single kernel `k` over `input_ptr`. The
+  // sums are accumulated in the same order as in the Convolve functions above,
+  // so that the result equals theirs for a zero interpolation factor.
+  static float ConvolvePhase_C(const float* input_ptr, const float* k);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static float ConvolvePhase_SSE(const float* input_ptr, const float* k);
+  static float ConvolvePhase_AVX2(const float* input_ptr, const float* k);
+#elif defined(WEBRTC_HAS_NEON)
+  static float ConvolvePhase_NEON(const float* input_ptr, const float* k);
+#endif
+
   // The ratio of input / output sample rates.
   double io_sample_rate_ratio_;
 
@@ -166,6 +210,27 @@ class SincResampler {
                                 const float*,
                                 double);
   ConvolveProc convolve_proc_;
+  typedef float (*ConvolvePhaseProc)(const float*, const float*);
+  ConvolvePhaseProc convolve_phase_proc_;
+
+  // Whether a kernel bank is computed for the ratios whose output samples do
+  // not fall on kernel offsets.
+  bool exact_polyphase_kernels_ = false;
+
+  // Number of output phases when each output sample is computed with a single
+  // kernel, or zero when the kernels are interpolated.
+  size_t num_phases_ = 0;
+
+  // Source advance per output sample, in whole samples and in phases.
+  size_t source_step_ = 0;
+  size_t phase_step_ = 0;
+
+  // The kernel of phase p starts at polyphase_kernels_ +
+  // p * polyphase_kernel_stride_, either in `kernel_storage_` or in
+  // `polyphase_kernel_storage_`.
+  const float* polyphase_kernels_ = nullptr;
+  size_t polyphase_kernel_stride_ = 0;
+  std::unique_ptr<float[], AlignedFreeDeleter> polyphase_kernel_storage_;
 
   // Pointers to the various regions inside `input_buffer_`.  See the diagram at
   // the top of the .cc file for more information.
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 #include "common_audio/resampler/sinusoidal_linear_chirp_source.h"
 #include "rtc_base/system/arch.h"
@@ -154,6 +155,104 @@ TEST(SincResamplerTest, Convolve) {
   EXPECT_NEAR(result2, result, kEpsilon);
 }
 
+// Ensure the single kernel Convolve methods return the same value as the
+// interpolating ones with a zero interpolation factor.
+TEST(SincResamplerTest, ConvolvePhase) {
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  const float* kernel = resampler.kernel_storage_.get();
+  const float* k2 = kernel + SincResampler::kKernelSize;
+
+  for (int offset = 0; offset < 2; ++offset) {
+    EXPECT_EQ(resampler.ConvolvePhase_C(kernel + offset, kernel),
+              resampler.Convolve_C(kernel + offset, kernel, k2, 0.0));
+    EXPECT_EQ(resampler.convolve_phase_proc_(kernel + offset, kernel),
+              resampler.convolve_proc_(kernel + offset, kernel, k2, 0.0));
+  }
+}
+
+// Verifies that the ratios whose output samples fall on kernel offsets use
+// single kernels and produce the same output as the kernel interpolation.
+TEST(SincResamplerTest, PolyphaseMatchesInterpolation) {
+  constexpr int kRates[][2] = {{48000, 16000}, {32000, 16000}, {48000, 32000},
+                               {16000, 32000}, {8000, 32000},  {44100, 22050}};
+  for (const auto& rates : kRates) {
+    const int input_rate = rates[0];
+    const int output_rate = rates[1];
+    SCOPED_TRACE(input_rate);
+    SCOPED_TRACE(output_rate);
+    const size_t input_samples = input_rate / 2;
+    const size_t output_samples = output_rate / 2;
+    const double io_ratio = input_rate / static_cast<double>(output_rate);
+
+    SinusoidalLinearChirpSource source(input_rate, input_samples,
+                                       0.5 * input_rate, 0);
+    SincResampler resampler(io_ratio, SincResampler::kDefaultRequestSize,
+                            &source);
+    EXPECT_GT(resampler.num_phases(), 0u);
+    std::vector<float> polyphase_output(output_samples);
+    // Resample in uneven chunks to exercise the state kept between calls.
+    for (size_t i = 0; i < output_samples; i += 97) {
+      resampler.Resample(std::min<size_t>(97, output_samples - i),
+                         &polyphase_output[i]);
+    }
+
+    SinusoidalLinearChirpSource reference_source(input_rate, input_samples,
+                                                 0.5 * input_rate, 0);
+    SincResampler reference(io_ratio, SincResampler::kDefaultRequestSize,
+                            &reference_source);
+    reference.num_phases_ = 0;
+    std::vector<float> reference_output(output_samples);
+    reference.Resample(output_samples, reference_output.data());
+
+    EXPECT_EQ(polyphase_output, reference_output);
+  }
+}
+
+// Verifies that the exact polyphase kernels are only used when enabled, and
+// that they produce nearly the same output as the kernel interpolation.
+TEST(SincResamplerTest, ExactPolyphaseKernels) {
+  constexpr int kRates[][3] = {
+      {16000, 48000, 3}, {44100, 48000, 160}, {48000, 44100, 147}};
+  for (const auto& rates : kRates) {
+    const int input_rate = rates[0];
+    const int output_rate = rates[1];
+    SCOPED_TRACE(input_rate);
+    SCOPED_TRACE(output_rate);
+    const size_t input_samples = input_rate / 2;
+    const size_t output_samples = output_rate / 2;
+    const double io_ratio = input_rate / static_cast<double>(output_rate);
+
+    SinusoidalLinearChirpSource source(input_rate, input_samples,
+                                       0.5 * input_rate, 0);
+    SincResampler resampler(io_ratio, SincResampler::kDefaultRequestSize,
+                            &source);
+    EXPECT_EQ(resampler.num_phases(), 0u);
+    resampler.SetExactPolyphaseKernels(true);
+    EXPECT_EQ(resampler.num_phases(), static_cast<size_t>(rates[2]));
+    std::vector<float> polyphase_output(output_samples);
+    resampler.Resample(output_samples, polyphase_output.data());
+
+    SinusoidalLinearChirpSource reference_source(input_rate, input_samples,
+                                                 0.5 * input_rate, 0);
+    SincResampler reference(io_ratio, SincResampler::kDefaultRequestSize,
+                            &reference_source);
+    std::vector<float> reference_output(output_samples);
+    reference.Resample(output_samples, reference_output.data());
+
+    float max_difference = 0.f;
+    for (size_t i = 0; i < output_samples; ++i) {
+      max_difference = std::max(
+          max_difference, fabsf(polyphase_output[i] - reference_output[i]));
+    }
+    EXPECT_LT(max_difference, 1e-3f);
+
+    resampler.SetExactPolyphaseKernels(false);
+    EXPECT_EQ(resampler.num_phases(), 0u);
+  }
+}
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that RTC_DCHECKs are compiled out when benchmarking.
 // Original benchmarks were run with --convolve-iterations=50000000.
@@ -78,10 +78,8 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
     FftData S_Neon;
     FftData G;
     Aec3Fft fft;
-    std::vector<std::vector<FftData>> H_C(
-        num_partitions, std::vector<FftData>(num_render_channels));
-    std::vector<std::vector<FftData>> H_Neon(
-        num_partitions, std::vector<FftData>(num_render_channels));
+    FftDataArray H_C(num_partitions, num_render_channels);
+    FftDataArray H_Neon(num_partitions, num_render_channels);
     for (size_t p = 0; p < num_partitions; ++p) {
       for (size_t ch = 0; ch < num_render_channels; ++ch) {
         H_C[p][ch].Clear();
@@ -141,14 +139,13 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
        ComputeFrequencyResponseNeonOptimization) {
   const size_t num_render_channels = GetParam();
   for (size_t num_partitions : {2, 5, 12, 30, 50}) {
-    std::vector<std::vector<FftData>> H(
-        num_partitions, std::vector<FftData>(num_render_channels));
+    FftDataArray H(num_partitions, num_render_channels);
     std::vector<std::array<float, kFftLengthBy2Plus1>> H2(num_partitions);
     std::vector<std::array<float, kFftLengthBy2Plus1>> H2_Neon(num_partitions);
 
     for (size_t p = 0; p < num_partitions; ++p) {
       for (size_t ch = 0; ch < num_render_channels; ++ch) {
-        for (size_t k = 0; k < H[p][ch].re.size(); ++k) {
+        for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
           H[p][ch].re[k] = k + p / 3.f + ch;
           H[p][ch].im[k] = p + k / 7.f - ch;
         }
@@ -188,10 +185,8 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
       FftData S_Sse2;
       FftData G;
       Aec3Fft fft;
-      std::vector<std::vector<FftData>> H_C(
-          num_partitions, std::vector<FftData>(num_render_channels));
-      std::vector<std::vector<FftData>> H_Sse2(
-          num_partitions, std::vector<FftData>(num_render_channels));
+      FftDataArray H_C(num_partitions, num_render_channels);
+      FftDataArray H_Sse2(num_partitions, num_render_channels);
       for (size_t p = 0; p < num_partitions; ++p) {
         for (size_t ch = 0; ch < num_render_channels; ++ch) {
           H_C[p][ch].Clear();
@@ -260,10 +255,8 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
       FftData S_Avx2;
       FftData G;
       Aec3Fft fft;
-      std::vector<std::vector<FftData>> H_C(
-          num_partitions, std::vector<FftData>(num_render_channels));
-      std::vector<std::vector<FftData>> H_Avx2(
-          num_partitions, std::vector<FftData>(num_render_channels));
+      FftDataArray H_C(num_partitions, num_render_channels);
+      FftDataArray H_Avx2(num_partitions, num_render_channels);
       for (size_t p = 0; p < num_partitions; ++p) {
         for (size_t ch = 0; ch < num_render_channels; ++ch) {
           H_C[p][ch].Clear();
@@ -320,15 +313,14 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
   bool use_sse2 = (GetCPUInfo(kSSE2) != 0);
   if (use_sse2) {
     for (size_t num_partitions : {2, 5, 12, 30, 50}) {
-      std::vector<std::vector<FftData>> H(
-          num_partitions, std::vector<FftData>(num_render_channels));
+      FftDataArray H(num_partitions, num_render_channels);
       std::vector<std::array<float, kFftLengthBy2Plus1>> H2(num_partitions);
       std::vector<std::array<float, kFftLengthBy2Plus1>> H2_Sse2(
           num_partitions);
 
       for (size_t p = 0; p < num_partitions; ++p) {
         for (size_t ch = 0; ch < num_render_channels; ++ch) {
-          for (size_t k = 0; k < H[p][ch].re.size(); ++k) {
+          for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
             H[p][ch].re[k] = k + p / 3.f + ch;
             H[p][ch].im[k] = p + k / 7.f - ch;
           }
@@ -355,15 +347,14 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
   bool use_avx2 = (GetCPUInfo(kAVX2) != 0);
   if (use_avx2) {
     for (size_t num_partitions : {2, 5, 12, 30, 50}) {
-      std::vector<std::vector<FftData>> H(
-          num_partitions, std::vector<FftData>(num_render_channels));
+      FftDataArray H(num_partitions, num_render_channels);
       std::vector<std::array<float, kFftLengthBy2Plus1>> H2(num_partitions);
       std::vector<std::array<float, kFftLengthBy2Plus1>> H2_Avx2(
           num_partitions);
 
       for (size_t p = 0; p < num_partitions; ++p) {
         for (size_t ch = 0; ch < num_render_channels; ++ch) {
-          for (size_t k = 0; k < H[p][ch].re.size(); ++k) {
+          for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
             H[p][ch].re[k] = k + p / 3.f + ch;
             H[p][ch].im[k] = p + k / 7.f - ch;
           }
@@ -382,6 +373,105 @@ TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
   }
 }
 
+// Verifies that the AVX-512 methods for filter adaptation are bitexact to their
+// AVX2 counterparts.
+TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
+       FilterAdaptationAvx512Optimizations) {
+  const size_t num_render_channels = GetParam();
+  constexpr int kSampleRateHz = 48000;
+  constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
+
+  bool use_avx512 = (GetCPUInfo(kAVX512) != 0);
+  if (use_avx512) {
+    for (size_t num_partitions : {2, 5, 12, 30, 50}) {
+      std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+          RenderDelayBuffer::Create(EchoCanceller3Config(), kSampleRateHz,
+                                    num_render_channels));
+      Random random_generator(42U);
+      Block x(kNumBands, num_render_channels);
+      FftData S_Avx2;
+      FftData S_Avx512;
+      FftData G;
+      FftDataArray H_Avx2(num_partitions, num_render_channels);
+      FftDataArray H_Avx512(num_partitions, num_render_channels);
+
+      for (size_t k = 0; k < 500; ++k) {
+        for (int band = 0; band < x.NumBands(); ++band) {
+          for (int ch = 0; ch < x.NumChannels(); ++ch) {
+            RandomizeSampleVector(&random_generator, x.View(band, ch));
+          }
+        }
+        render_delay_buffer->Insert(x);
+        if (k == 0) {
+          render_delay_buffer->Reset();
+        }
+        render_delay_buffer->PrepareCaptureProcessing();
+        auto* const render_buffer = render_delay_buffer->GetRenderBuffer();
+
+        ApplyFilter_Avx512(*render_buffer, num_partitions, H_Avx512,
+                           &S_Avx512);
+        ApplyFilter_Avx2(*render_buffer, num_partitions, H_Avx2, &S_Avx2);
+        for (size_t j = 0; j < S_Avx2.re.size(); ++j) {
+          EXPECT_EQ(S_Avx2.re[j], S_Avx512.re[j]);
+          EXPECT_EQ(S_Avx2.im[j], S_Avx512.im[j]);
+        }
+
+        std::for_each(G.re.begin(), G.re.end(),
+                      [&](float& a) { a = random_generator.Rand<float>(); });
+        std::for_each(G.im.begin(), G.im.end(),
+                      [&](float& a) { a = random_generator.Rand<float>(); });
+
+        AdaptPartitions_Avx512(*render_buffer, G, num_partitions, &H_Avx512);
+        AdaptPartitions_Avx2(*render_buffer, G, num_partitions, &H_Avx2);
+
+        for (size_t p = 0; p < num_partitions; ++p) {
+          for (size_t ch = 0; ch < num_render_channels; ++ch) {
+            for (size_t j = 0; j < H_Avx2[p][ch].re.size(); ++j) {
+              EXPECT_EQ(H_Avx2[p][ch].re[j], H_Avx512[p][ch].re[j]);
+              EXPECT_EQ(H_Avx2[p][ch].im[j], H_Avx512[p][ch].im[j]);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Verifies that the AVX-512 method for frequency response computation is
+// bitexact to the AVX2 counterpart.
+TEST_P(AdaptiveFirFilterOneTwoFourEightRenderChannels,
+       ComputeFrequencyResponseAvx512Optimization) {
+  const size_t num_render_channels = GetParam();
+  bool use_avx512 = (GetCPUInfo(kAVX512) != 0);
+  if (use_avx512) {
+    for (size_t num_partitions : {2, 5, 12, 30, 50}) {
+      FftDataArray H(num_partitions, num_render_channels);
+      std::vector<std::array<float, kFftLengthBy2Plus1>> H2_Avx2(
+          num_partitions);
+      std::vector<std::array<float, kFftLengthBy2Plus1>> H2_Avx512(
+          num_partitions);
+
+      for (size_t p = 0; p < num_partitions; ++p) {
+        for (size_t ch = 0; ch < num_render_channels; ++ch) {
+          for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
+            H[p][ch].re[k] = k + p / 3.f + ch;
+            H[p][ch].im[k] = p + k / 7.f - ch;
+          }
+        }
+      }
+
+      ComputeFrequencyResponse_Avx2(num_partitions, H, &H2_Avx2);
+      ComputeFrequencyResponse_Avx512(num_partitions, H, &H2_Avx512);
+
+      for (size_t p = 0; p < num_partitions; ++p) {
+        for (size_t k = 0; k < H2_Avx2[p].size(); ++k) {
+          EXPECT_EQ(H2_Avx2[p][k], H2_Avx512[p][k]);
+        }
+      }
+    }
+  }
+}
+
 #endif
 
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/aec3_arena.h"
+
+#include <string.h>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// The arena bound to the current thread.
+thread_local Aec3Arena* bound_arena = nullptr;
+
+size_t RoundUpToAlignment(size_t size_bytes) {
+  return (size_bytes + Aec3Arena::kAlignment - 1) &
+         ~(Aec3Arena::kAlignment - 1);
+}
+
+}  // namespace
+
+Aec3Arena::Aec3Arena() = default;
+
+Aec3Arena::~Aec3Arena() {
+  RTC_DCHECK_EQ(0, num_live_allocations_);
+}
+
+void* Aec3Arena::Allocate(size_t size_bytes) {
+  const size_t aligned_size = RoundUpToAlignment(size_bytes);
+  if (aligned_size > capacity_bytes_ - used_bytes_) {
+    overflow_bytes_ += size_bytes;
+    return nullptr;
+  }
+  void* allocation = data_.get() + used_bytes_;
+  used_bytes_ += aligned_size;
+  ++num_live_allocations_;
+  return allocation;
+}
+
+void Aec3Arena::Release() {
+  RTC_DCHECK_LT(0, num_live_allocations_);
+  --num_live_allocations_;
+}
+
+void Aec3Arena::Reset(size_t capacity_bytes) {
+  RTC_DCHECK_EQ(0, num_live_allocations_);
+  capacity_bytes = RoundUpToAlignment(capacity_bytes);
+  if (capacity_bytes > capacity_bytes_) {
+    data_.reset(AlignedMalloc<char>(capacity_bytes, kAlignment));
+    RTC_CHECK(data_);
+    capacity_bytes_ = capacity_bytes;
+  }
+  // Touching all the pages here places them close to the resetting thread.
+  if (capacity_bytes_ > 0) {
+    memset(data_.get(), 0, capacity_bytes_);
+  }
+  used_bytes_ = 0;
+  overflow_bytes_ = 0;
+}
+
+Aec3ArenaStats Aec3Arena::GetStats() const {
+  Aec3ArenaStats stats;
+  stats.capacity_bytes = capacity_bytes_;
+  stats.used_bytes = used_bytes_;
+  stats.overflow_bytes = overflow_bytes_;
+  return stats;
+}
+
+ScopedAec3ArenaBinding::ScopedAec3ArenaBinding(Aec3Arena* arena)
+    : previous_(bound_arena) {
+  bound_arena = arena;
+}
+
+ScopedAec3ArenaBinding::~ScopedAec3ArenaBinding() {
+  bound_arena = previous_;
+}
+
+Aec3Arena* ScopedAec3ArenaBinding::Current() {
+  return bound_arena;
+}
+
+}  // namespace webrtc
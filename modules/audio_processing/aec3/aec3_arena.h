@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_AEC3_ARENA_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_AEC3_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "rtc_base/memory/aligned_malloc.h"
+
+namespace webrtc {
+
+// Memory footprint of an arena.
+struct Aec3ArenaStats {
+  // Size of the contiguous allocation of the arena.
+  size_t capacity_bytes = 0;
+  // Bytes handed out from the arena.
+  size_t used_bytes = 0;
+  // Bytes that did not fit in the arena and were allocated on the heap
+  // instead.
+  size_t overflow_bytes = 0;
+};
+
+// Monotonic allocator that carves the large, long-lived arrays of an echo
+// canceller out of one contiguous, cache line aligned allocation. The memory
+// is zeroed by the thread that sizes the arena, which on systems with a
+// first-touch page placement policy makes it local to the NUMA node of that
+// thread. Individual allocations are only counted when released; the memory
+// is reclaimed all at once by Reset() or on destruction.
+//
+// The arena is used by the arrays that are constructed on a thread to which
+// it is bound with a ScopedAec3ArenaBinding.
+class Aec3Arena {
+ public:
+  static constexpr size_t kAlignment = 64;
+
+  Aec3Arena();
+  ~Aec3Arena();
+
+  Aec3Arena(const Aec3Arena&) = delete;
+  Aec3Arena& operator=(const Aec3Arena&) = delete;
+
+  // Returns `size_bytes` bytes of kAlignment aligned memory, or nullptr if
+  // the request does not fit in the remaining capacity.
+  void* Allocate(size_t size_bytes);
+
+  // Marks an allocation as no longer in use.
+  void Release();
+
+  // Reclaims all the memory and makes sure that at least `capacity_bytes`
+  // bytes are available. Must only be called when no allocation is in use.
+  void Reset(size_t capacity_bytes);
+
+  // Returns the memory footprint of the arena.
+  Aec3ArenaStats GetStats() const;
+
+ private:
+  std::unique_ptr<char[], AlignedFreeDeleter> data_;
+  size_t capacity_bytes_ = 0;
+  size_t used_bytes_ = 0;
+  size_t overflow_bytes_ = 0;
+  int num_live_allocations_ = 0;
+};
+
+// Binds an arena to the current thread for the lifetime of the object.
+class ScopedAec3ArenaBinding {
+ public:
+  explicit ScopedAec3ArenaBinding(Aec3Arena* arena);
+  ~ScopedAec3ArenaBinding();
+  ScopedAec3ArenaBinding(const ScopedAec3ArenaBinding&) = delete;
+  ScopedAec3ArenaBinding& operator=(const ScopedAec3ArenaBinding&) = delete;
+
+  // Returns the arena bound to the current thread, if any.
+  static Aec3Arena* Current();
+
+ private:
+  Aec3Arena* const previous_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_AEC3_ARENA_H_
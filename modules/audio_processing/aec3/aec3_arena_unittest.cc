@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/aec3_arena.h"
+
+#include <stdint.h>
+
+#include "modules/audio_processing/aec3/echo_canceller3.h"
+#include "modules/audio_processing/aec3/fft_data_array.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(Aec3Arena, AllocationsAreAlignedAndBounded) {
+  Aec3Arena arena;
+  arena.Reset(1000);
+  const Aec3ArenaStats initial_stats = arena.GetStats();
+  EXPECT_EQ(1024u, initial_stats.capacity_bytes);
+  EXPECT_EQ(0u, initial_stats.used_bytes);
+
+  void* a = arena.Allocate(10);
+  void* b = arena.Allocate(100);
+  ASSERT_TRUE(a);
+  ASSERT_TRUE(b);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a) % Aec3Arena::kAlignment);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b) % Aec3Arena::kAlignment);
+  EXPECT_EQ(192u, arena.GetStats().used_bytes);
+
+  EXPECT_FALSE(arena.Allocate(1000));
+  EXPECT_EQ(1000u, arena.GetStats().overflow_bytes);
+
+  arena.Release();
+  arena.Release();
+  arena.Reset(100);
+  EXPECT_EQ(1024u, arena.GetStats().capacity_bytes);
+  EXPECT_EQ(0u, arena.GetStats().used_bytes);
+  EXPECT_EQ(0u, arena.GetStats().overflow_bytes);
+}
+
+// Verifies that arrays use the arena that is bound to the thread, and fall
+// back to the heap when it is full.
+TEST(Aec3Arena, FftDataArraysUseBoundArena) {
+  Aec3Arena arena;
+  arena.Reset(2 * sizeof(AlignedFftData));
+  {
+    ScopedAec3ArenaBinding binding(&arena);
+    FftDataArray in_arena(1, 2);
+    FftDataArray on_heap(1, 2);
+    FftDataArray copy_on_heap(in_arena);
+    EXPECT_EQ(2 * sizeof(AlignedFftData), arena.GetStats().used_bytes);
+    EXPECT_EQ(4 * sizeof(AlignedFftData), arena.GetStats().overflow_bytes);
+  }
+  FftDataArray unbound(1, 2);
+  EXPECT_EQ(4 * sizeof(AlignedFftData), arena.GetStats().overflow_bytes);
+}
+
+// Verifies that the arena of an echo canceller is sized to hold all its
+// arrays.
+TEST(Aec3Arena, EchoCancellerArenaFitsState) {
+  for (size_t num_render_channels : {1, 2}) {
+    for (size_t num_capture_channels : {1, 3}) {
+      EchoCanceller3 aec3(EchoCanceller3Config(),
+                          /*multichannel_config=*/absl::nullopt, 48000,
+                          num_render_channels, num_capture_channels);
+      const Aec3ArenaStats stats = aec3.GetArenaStats();
+      EXPECT_LT(0u, stats.used_bytes);
+      EXPECT_EQ(stats.capacity_bytes, stats.used_bytes);
+      EXPECT_EQ(0u, stats.overflow_bytes);
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -23,7 +23,24 @@ namespace webrtc {
 #define ALIGN16_END __attribute__((aligned(16)))
 #endif
 
-enum class Aec3Optimization { kNone, kSse2, kAvx2, kNeon };
+enum class Aec3Optimization { kNone, kSse2, kAvx2, kAvx512, kNeon };
+
+// Levels of reduced computational complexity that are used when the processing
+// exceeds its CPU budget, in the order of increasing degradation. Each tier
+// includes the reductions of the tiers before it.
+enum class Aec3ComputeTier {
+  // Full processing.
+  kFull = 0,
+  // Only the matched filters around the detected delay are updated on every
+  // block once the delay is reliable. With the FFT lag correlator, the filters
+  // are no longer all updated when the correlator has no candidate lag.
+  kReducedDelayEstimation,
+  // The coarse filter is adapted every other block.
+  kReducedCoarseAdaptation,
+  // The refined filter is shortened to half of its configured length.
+  kReducedFilterLength,
+  kNumTiers
+};
 
 constexpr int kNumBlocksPerSecond = 250;
 
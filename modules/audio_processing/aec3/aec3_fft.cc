@@ -16,6 +16,7 @@
 
 #include "rtc_base/checks.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
@@ -79,9 +80,79 @@ bool IsSse2Available() {
 #endif
 }
 
+Aec3Fft::Backend BackendFromFieldTrials() {
+  if (field_trial::IsEnabled("WebRTC-Aec3Avx2FftBackend")) {
+    return Aec3Fft::Backend::kAvx2;
+  }
+  if (field_trial::IsEnabled("WebRTC-Aec3PffftBackend")) {
+    return Aec3Fft::Backend::kPffft;
+  }
+  return Aec3Fft::Backend::kOoura;
+}
+
+Aec3Fft::Backend AvailableBackend(Aec3Fft::Backend backend) {
+  if (backend == Aec3Fft::Backend::kAvx2) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (GetCPUInfo(kAVX2) != 0 && GetCPUInfo(kFMA3) != 0) {
+      return backend;
+    }
+#endif
+    return Aec3Fft::Backend::kOoura;
+  }
+  return backend;
+}
+
 }  // namespace
 
-Aec3Fft::Aec3Fft() : ooura_fft_(IsSse2Available()) {}
+Aec3Fft::Aec3Fft() : Aec3Fft(BackendFromFieldTrials()) {}
+
+Aec3Fft::Aec3Fft(Backend backend)
+    : backend_(AvailableBackend(backend)), ooura_fft_(IsSse2Available()) {
+  if (backend_ == Backend::kPffft) {
+    pffft_ = std::make_unique<Pffft>(kFftLength, Pffft::FftType::kReal);
+    pffft_time_data_ = pffft_->CreateBuffer();
+    pffft_frequency_data_ = pffft_->CreateBuffer();
+  }
+}
+
+Aec3Fft::~Aec3Fft() = default;
+
+// PFFFT uses the same packed format as the Ooura FFT, but with the opposite
+// sign of the exponent. Its inverse transform is scaled by kFftLength rather
+// than by kFftLengthBy2.
+void Aec3Fft::FftPffft(const std::array<float, kFftLength>& x,
+                       FftData* X) const {
+  RTC_DCHECK(pffft_);
+  rtc::ArrayView<float> time_data = pffft_time_data_->GetView();
+  std::copy(x.begin(), x.end(), time_data.begin());
+  pffft_->ForwardTransform(*pffft_time_data_, pffft_frequency_data_.get(),
+                           /*ordered=*/true);
+  rtc::ArrayView<const float> v = pffft_frequency_data_->GetConstView();
+  X->re[0] = v[0];
+  X->re[kFftLengthBy2] = v[1];
+  X->im[0] = X->im[kFftLengthBy2] = 0.f;
+  for (size_t k = 1, j = 2; k < kFftLengthBy2; ++k, j += 2) {
+    X->re[k] = v[j];
+    X->im[k] = -v[j + 1];
+  }
+}
+
+void Aec3Fft::IfftPffft(const FftData& X,
+                        std::array<float, kFftLength>* x) const {
+  RTC_DCHECK(pffft_);
+  rtc::ArrayView<float> v = pffft_frequency_data_->GetView();
+  v[0] = X.re[0];
+  v[1] = X.re[kFftLengthBy2];
+  for (size_t k = 1, j = 2; k < kFftLengthBy2; ++k, j += 2) {
+    v[j] = X.re[k];
+    v[j + 1] = -X.im[k];
+  }
+  pffft_->BackwardTransform(*pffft_frequency_data_, pffft_time_data_.get(),
+                            /*ordered=*/true);
+  rtc::ArrayView<const float> time_data = pffft_time_data_->GetConstView();
+  std::transform(time_data.begin(), time_data.end(), x->begin(),
+                 [](float a) { return 0.5f * a; });
+}
 
 // TODO(peah): Change x to be std::array once the rest of the code allows this.
 void Aec3Fft::ZeroPaddedFft(rtc::ArrayView<const float> x,
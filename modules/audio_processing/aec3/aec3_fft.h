@@ -12,12 +12,16 @@
 #define MODULES_AUDIO_PROCESSING_AEC3_AEC3_FFT_H_
 
 #include <array>
+#include <memory>
 
 #include "api/array_view.h"
 #include "common_audio/third_party/ooura/fft_size_128/ooura_fft.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/fft_data.h"
+#include "modules/audio_processing/utility/pffft_wrapper.h"
 #include "rtc_base/checks.h"
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
@@ -27,25 +31,75 @@ class Aec3Fft {
  public:
   enum class Window { kRectangular, kHanning, kSqrtHanning };
 
+  // FFT implementations. The Ooura FFT is the reference; the others produce
+  // the same transforms up to floating point rounding.
+  enum class Backend {
+    // Ooura FFT operating on the packed array format.
+    kOoura,
+    // PFFFT, using SSE/NEON when available.
+    kPffft,
+    // AVX2 FFT writing directly into the FftData format. Falls back to kOoura
+    // if AVX2 is not available.
+    kAvx2
+  };
+
+  // Uses the Ooura backend unless another one is selected using the
+  // WebRTC-Aec3PffftBackend or WebRTC-Aec3Avx2FftBackend field trials.
   Aec3Fft();
+  explicit Aec3Fft(Backend backend);
+  ~Aec3Fft();
 
   Aec3Fft(const Aec3Fft&) = delete;
   Aec3Fft& operator=(const Aec3Fft&) = delete;
 
+  // Returns the backend in use.
+  Backend backend() const { return backend_; }
+
   // Computes the FFT. Note that both the input and output are modified.
   void Fft(std::array<float, kFftLength>* x, FftData* X) const {
     RTC_DCHECK(x);
     RTC_DCHECK(X);
-    ooura_fft_.Fft(x->data());
-    X->CopyFromPackedArray(*x);
+    switch (backend_) {
+      case Backend::kPffft:
+        FftPffft(*x, X);
+        break;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Backend::kAvx2:
+        FftAVX2(*x, X);
+        break;
+#endif
+      default:
+        ooura_fft_.Fft(x->data());
+        X->CopyFromPackedArray(*x);
+    }
   }
   // Computes the inverse Fft.
   void Ifft(const FftData& X, std::array<float, kFftLength>* x) const {
     RTC_DCHECK(x);
-    X.CopyToPackedArray(x);
-    ooura_fft_.InverseFft(x->data());
+    switch (backend_) {
+      case Backend::kPffft:
+        IfftPffft(X, x);
+        break;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Backend::kAvx2:
+        IfftAVX2(X, x);
+        break;
+#endif
+      default:
+        X.CopyToPackedArray(x);
+        ooura_fft_.InverseFft(x->data());
+    }
   }
 
+  // Backend specific transforms with the same conventions as Fft and Ifft.
+  // Exposed for testing.
+  void FftPffft(const std::array<float, kFftLength>& x, FftData* X) const;
+  void IfftPffft(const FftData& X, std::array<float, kFftLength>* x) const;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void FftAVX2(const std::array<float, kFftLength>& x, FftData* X);
+  static void IfftAVX2(const FftData& X, std::array<float, kFftLength>* x);
+#endif
+
   // Windows the input using a Hanning window, and then adds padding of
   // kFftLengthBy2 initial zeros before computing the Fft.
   void ZeroPaddedFft(rtc::ArrayView<const float> x,
@@ -67,7 +121,12 @@ class Aec3Fft {
                  FftData* X) const;
 
  private:
+  const Backend backend_;
   const OouraFft ooura_fft_;
+  // Only allocated for the PFFFT backend.
+  std::unique_ptr<Pffft> pffft_;
+  std::unique_ptr<Pffft::FloatBuffer> pffft_time_data_;
+  std::unique_ptr<Pffft::FloatBuffer> pffft_frequency_data_;
 };
 
 }  // namespace webrtc
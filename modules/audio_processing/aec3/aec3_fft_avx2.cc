@@ -0,0 +1,285 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/aec3_fft.h"
+
+#include <immintrin.h>
+#include <math.h>
+
+namespace webrtc {
+namespace {
+
+// The 128 point real FFT is computed as a 64 point complex FFT of the even
+// and odd samples, followed by a split into the spectrum of the real signal.
+// The 64 point FFT uses an 8x8 decomposition: 8 point DFTs over the rows of
+// an 8x8 matrix, a twiddle multiplication, a transpose and another set of 8
+// point DFTs. With one matrix row per AVX2 register, all DFTs operate on
+// whole registers and the output is produced in natural order.
+constexpr int kRows = 8;
+constexpr double kPi = 3.14159265358979323846;
+
+struct FftTables {
+  FftTables() {
+    for (int k = 0; k < kRows; ++k) {
+      for (int n = 0; n < kRows; ++n) {
+        const double angle = 2. * kPi * k * n / 64.;
+        twiddle_re[k][n] = static_cast<float>(cos(angle));
+        twiddle_im[k][n] = static_cast<float>(-sin(angle));
+      }
+    }
+    for (size_t k = 0; k < kFftLengthBy2; ++k) {
+      const double angle = 2. * kPi * k / kFftLength;
+      split_cos[k] = static_cast<float>(cos(angle));
+      split_sin[k] = static_cast<float>(sin(angle));
+    }
+  }
+
+  // W64^(k * n), with k being the row and n the column.
+  float twiddle_re[kRows][kRows];
+  float twiddle_im[kRows][kRows];
+  // cos and sin of 2 * pi * k / kFftLength.
+  float split_cos[kFftLengthBy2];
+  float split_sin[kFftLengthBy2];
+};
+
+const FftTables& GetFftTables() {
+  static const FftTables tables;
+  return tables;
+}
+
+struct ComplexVector {
+  __m256 re;
+  __m256 im;
+};
+
+inline ComplexVector Add(const ComplexVector& a, const ComplexVector& b) {
+  return {_mm256_add_ps(a.re, b.re), _mm256_add_ps(a.im, b.im)};
+}
+
+inline ComplexVector Sub(const ComplexVector& a, const ComplexVector& b) {
+  return {_mm256_sub_ps(a.re, b.re), _mm256_sub_ps(a.im, b.im)};
+}
+
+// Returns -j * a.
+inline ComplexVector MulMinusJ(const ComplexVector& a) {
+  return {a.im, _mm256_sub_ps(_mm256_setzero_ps(), a.re)};
+}
+
+inline ComplexVector Mul(const ComplexVector& a, const ComplexVector& b) {
+  return {_mm256_sub_ps(_mm256_mul_ps(a.re, b.re), _mm256_mul_ps(a.im, b.im)),
+          _mm256_add_ps(_mm256_mul_ps(a.re, b.im), _mm256_mul_ps(a.im, b.re))};
+}
+
+inline __m256 Reverse(__m256 a) {
+  return _mm256_permutevar8x32_ps(a, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// Computes the 8 point DFTs, with a negative exponent, of the sequences formed
+// by the lanes of the eight vectors. The DFT is split into radix-4 butterflies
+// of the even and odd samples followed by radix-2 butterflies.
+void Dft8(ComplexVector a[kRows]) {
+  const __m256 kSqrtHalf = _mm256_set1_ps(0.70710678118654752f);
+  const ComplexVector t0 = Add(a[0], a[4]);
+  const ComplexVector t1 = Sub(a[0], a[4]);
+  const ComplexVector t2 = Add(a[2], a[6]);
+  const ComplexVector t3 = MulMinusJ(Sub(a[2], a[6]));
+  const ComplexVector t4 = Add(a[1], a[5]);
+  const ComplexVector t5 = Sub(a[1], a[5]);
+  const ComplexVector t6 = Add(a[3], a[7]);
+  const ComplexVector t7 = MulMinusJ(Sub(a[3], a[7]));
+
+  const ComplexVector e0 = Add(t0, t2);
+  const ComplexVector e1 = Add(t1, t3);
+  const ComplexVector e2 = Sub(t0, t2);
+  const ComplexVector e3 = Sub(t1, t3);
+  const ComplexVector o0 = Add(t4, t6);
+  const ComplexVector o1 = Add(t5, t7);
+  const ComplexVector o2 = Sub(t4, t6);
+  const ComplexVector o3 = Sub(t5, t7);
+
+  // Multiplications by W8^1, W8^2 and W8^3.
+  const ComplexVector w1 = {
+      _mm256_mul_ps(kSqrtHalf, _mm256_add_ps(o1.re, o1.im)),
+      _mm256_mul_ps(kSqrtHalf, _mm256_sub_ps(o1.im, o1.re))};
+  const ComplexVector w2 = MulMinusJ(o2);
+  const ComplexVector w3 = {
+      _mm256_mul_ps(kSqrtHalf, _mm256_sub_ps(o3.im, o3.re)),
+      _mm256_mul_ps(kSqrtHalf,
+                    _mm256_sub_ps(_mm256_setzero_ps(),
+                                  _mm256_add_ps(o3.im, o3.re)))};
+
+  a[0] = Add(e0, o0);
+  a[4] = Sub(e0, o0);
+  a[1] = Add(e1, w1);
+  a[5] = Sub(e1, w1);
+  a[2] = Add(e2, w2);
+  a[6] = Sub(e2, w2);
+  a[3] = Add(e3, w3);
+  a[7] = Sub(e3, w3);
+}
+
+void Transpose8x8(__m256 r[kRows]) {
+  const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+  const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+  const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+  const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+  const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+  const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+  const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+  const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+  const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+  r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+  r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+  r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+  r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+  r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+  r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+  r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// Computes the 64 point DFT, with a negative exponent, of the sequence whose
+// element 8 * n1 + n2 is held in lane n2 of z[n1]. The output is stored in the
+// same order.
+void Dft64(const FftTables& tables, ComplexVector z[kRows]) {
+  Dft8(z);
+  __m256 re[kRows];
+  __m256 im[kRows];
+  for (int k = 0; k < kRows; ++k) {
+    const ComplexVector w = {_mm256_loadu_ps(tables.twiddle_re[k]),
+                             _mm256_loadu_ps(tables.twiddle_im[k])};
+    const ComplexVector y = Mul(z[k], w);
+    re[k] = y.re;
+    im[k] = y.im;
+  }
+  Transpose8x8(re);
+  Transpose8x8(im);
+  for (int k = 0; k < kRows; ++k) {
+    z[k] = {re[k], im[k]};
+  }
+  Dft8(z);
+}
+
+}  // namespace
+
+// The FftData format holds the spectrum with a positive exponent, i.e., the
+// complex conjugate of the DFT computed here.
+void Aec3Fft::FftAVX2(const std::array<float, kFftLength>& x, FftData* X) {
+  const FftTables& tables = GetFftTables();
+
+  // Form the complex sequence of the even and odd samples.
+  ComplexVector z[kRows];
+  for (int k = 0; k < kRows; ++k) {
+    const __m256 a = _mm256_loadu_ps(&x[16 * k]);
+    const __m256 b = _mm256_loadu_ps(&x[16 * k + 8]);
+    const __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    z[k].re = _mm256_castpd_ps(_mm256_permute4x64_pd(
+        _mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+    z[k].im = _mm256_castpd_ps(_mm256_permute4x64_pd(
+        _mm256_castps_pd(odd), _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+
+  Dft64(tables, z);
+
+  // Z[64] = Z[0] is appended for the reversed loads of Z[64 - k].
+  float z_re[kFftLengthBy2 + 8];
+  float z_im[kFftLengthBy2 + 8];
+  for (int k = 0; k < kRows; ++k) {
+    _mm256_storeu_ps(&z_re[8 * k], z[k].re);
+    _mm256_storeu_ps(&z_im[8 * k], z[k].im);
+  }
+  z_re[kFftLengthBy2] = z_re[0];
+  z_im[kFftLengthBy2] = z_im[0];
+
+  // Split into the spectrum of the real signal using
+  // X[k] = E[k] + W128^k * O[k], where E[k] = (Z[k] + conj(Z[64 - k])) / 2 and
+  // O[k] = (Z[k] - conj(Z[64 - k])) / 2j are the spectra of the even and odd
+  // samples.
+  const __m256 kHalf = _mm256_set1_ps(0.5f);
+  for (size_t k = 0; k < kFftLengthBy2; k += 8) {
+    const __m256 zk_re = _mm256_loadu_ps(&z_re[k]);
+    const __m256 zk_im = _mm256_loadu_ps(&z_im[k]);
+    const __m256 zm_re = Reverse(_mm256_loadu_ps(&z_re[kFftLengthBy2 - 7 - k]));
+    const __m256 zm_im = Reverse(_mm256_loadu_ps(&z_im[kFftLengthBy2 - 7 - k]));
+    const __m256 e_re = _mm256_mul_ps(kHalf, _mm256_add_ps(zk_re, zm_re));
+    const __m256 e_im = _mm256_mul_ps(kHalf, _mm256_sub_ps(zk_im, zm_im));
+    const __m256 o_re = _mm256_mul_ps(kHalf, _mm256_add_ps(zk_im, zm_im));
+    const __m256 o_im = _mm256_mul_ps(kHalf, _mm256_sub_ps(zm_re, zk_re));
+    const __m256 c = _mm256_loadu_ps(&tables.split_cos[k]);
+    const __m256 s = _mm256_loadu_ps(&tables.split_sin[k]);
+    const __m256 x_re = _mm256_add_ps(
+        e_re, _mm256_add_ps(_mm256_mul_ps(c, o_re), _mm256_mul_ps(s, o_im)));
+    const __m256 x_im_conj = _mm256_sub_ps(
+        _mm256_sub_ps(_mm256_mul_ps(s, o_re), _mm256_mul_ps(c, o_im)), e_im);
+    _mm256_storeu_ps(&X->re[k], x_re);
+    _mm256_storeu_ps(&X->im[k], x_im_conj);
+  }
+  X->re[kFftLengthBy2] = z_re[0] - z_im[0];
+  X->im[0] = X->im[kFftLengthBy2] = 0.f;
+}
+
+// Inverts the split of FftAVX2 to get the spectrum of the complex sequence of
+// the even and odd samples, and computes its inverse DFT as the conjugate of
+// the DFT of the conjugate. As for the Ooura FFT, the output is scaled by
+// kFftLengthBy2.
+void Aec3Fft::IfftAVX2(const FftData& X, std::array<float, kFftLength>* x) {
+  const FftTables& tables = GetFftTables();
+  const __m256 kHalf = _mm256_set1_ps(0.5f);
+  const __m256 kMinusHalf = _mm256_set1_ps(-0.5f);
+
+  // The imaginary parts of the DC and Nyquist bins are ignored.
+  ComplexVector z[kRows];
+  for (size_t k = 0; k < kFftLengthBy2; k += 8) {
+    const __m256 xk_re = _mm256_loadu_ps(&X.re[k]);
+    __m256 xk_im = _mm256_loadu_ps(&X.im[k]);
+    const __m256 xm_re = Reverse(_mm256_loadu_ps(&X.re[kFftLengthBy2 - 7 - k]));
+    __m256 xm_im = Reverse(_mm256_loadu_ps(&X.im[kFftLengthBy2 - 7 - k]));
+    if (k == 0) {
+      xk_im = _mm256_blend_ps(xk_im, _mm256_setzero_ps(), 1);
+      xm_im = _mm256_blend_ps(xm_im, _mm256_setzero_ps(), 1);
+    }
+    const __m256 e_re = _mm256_mul_ps(kHalf, _mm256_add_ps(xk_re, xm_re));
+    const __m256 e_im = _mm256_mul_ps(kHalf, _mm256_sub_ps(xm_im, xk_im));
+    const __m256 d_re = _mm256_mul_ps(kHalf, _mm256_sub_ps(xk_re, xm_re));
+    const __m256 d_im = _mm256_mul_ps(kMinusHalf, _mm256_add_ps(xk_im, xm_im));
+    const __m256 c = _mm256_loadu_ps(&tables.split_cos[k]);
+    const __m256 s = _mm256_loadu_ps(&tables.split_sin[k]);
+    const __m256 o_re =
+        _mm256_sub_ps(_mm256_mul_ps(d_re, c), _mm256_mul_ps(d_im, s));
+    const __m256 o_im =
+        _mm256_add_ps(_mm256_mul_ps(d_re, s), _mm256_mul_ps(d_im, c));
+    // Z[k] = E[k] + j * O[k], conjugated.
+    z[k / 8].re = _mm256_sub_ps(e_re, o_im);
+    z[k / 8].im = _mm256_sub_ps(_mm256_sub_ps(_mm256_setzero_ps(), e_im), o_re);
+  }
+
+  Dft64(tables, z);
+
+  // Interleave the real and negated imaginary parts into the even and odd
+  // samples.
+  for (int k = 0; k < kRows; ++k) {
+    const __m256 re = z[k].re;
+    const __m256 im = _mm256_sub_ps(_mm256_setzero_ps(), z[k].im);
+    const __m256 lo = _mm256_unpacklo_ps(re, im);
+    const __m256 hi = _mm256_unpackhi_ps(re, im);
+    _mm256_storeu_ps(&(*x)[16 * k], _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(&(*x)[16 * k + 8], _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+}
+
+}  // namespace webrtc
@@ -11,7 +11,10 @@
 #include "modules/audio_processing/aec3/aec3_fft.h"
 
 #include <algorithm>
+#include <vector>
 
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -210,4 +213,49 @@ TEST(Aec3Fft, PaddedFft) {
   }
 }
 
+// Verifies that the FFT backends compute the same transforms as the Ooura
+// backend.
+TEST(Aec3Fft, BackendsMatchOoura) {
+  std::vector<Aec3Fft::Backend> backends = {Aec3Fft::Backend::kPffft};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kAVX2) != 0 && GetCPUInfo(kFMA3) != 0) {
+    backends.push_back(Aec3Fft::Backend::kAvx2);
+  }
+#endif
+  Aec3Fft ooura_fft(Aec3Fft::Backend::kOoura);
+  Random random_generator(42U);
+  for (Aec3Fft::Backend backend : backends) {
+    Aec3Fft fft(backend);
+    EXPECT_EQ(backend, fft.backend());
+    for (int k = 0; k < 100; ++k) {
+      std::array<float, kFftLength> x;
+      for (float& x_j : x) {
+        x_j = 32767.f * (2.f * random_generator.Rand<float>() - 1.f);
+      }
+      std::array<float, kFftLength> x_ref = x;
+      std::array<float, kFftLength> x_copy = x;
+      FftData X;
+      FftData X_ref;
+      fft.Fft(&x_copy, &X);
+      ooura_fft.Fft(&x_ref, &X_ref);
+      for (size_t j = 0; j < X.re.size(); ++j) {
+        EXPECT_NEAR(X_ref.re[j], X.re[j], 1.f);
+        EXPECT_NEAR(X_ref.im[j], X.im[j], 1.f);
+      }
+
+      // Non-zero imaginary parts of the DC and Nyquist bins must be ignored.
+      X_ref.im[0] = X.im[0] = 1000.f;
+      X_ref.im[kFftLengthBy2] = X.im[kFftLengthBy2] = -1000.f;
+      std::array<float, kFftLength> y;
+      std::array<float, kFftLength> y_ref;
+      fft.Ifft(X, &y);
+      ooura_fft.Ifft(X_ref, &y_ref);
+      for (size_t j = 0; j < x.size(); ++j) {
+        EXPECT_NEAR(y_ref[j], y[j], 32.f);
+        EXPECT_NEAR(kFftLengthBy2 * x[j], y[j], 32.f);
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -0,0 +1,538 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Microbenchmarks for the per-block AEC3 kernels. Every kernel that has
+// Aec3Optimization specific implementations is registered once per variant so
+// that per-ISA regressions show up as separate entries.
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "api/audio/echo_canceller3_config.h"
+#include "benchmark/benchmark.h"
+#include "modules/audio_processing/aec3/adaptive_fir_filter.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/aec3_fft.h"
+#include "modules/audio_processing/aec3/block.h"
+#include "modules/audio_processing/aec3/downsampled_render_buffer.h"
+#include "modules/audio_processing/aec3/fft_data.h"
+#include "modules/audio_processing/aec3/fft_data_array.h"
+#include "modules/audio_processing/aec3/matched_filter.h"
+#include "modules/audio_processing/aec3/matched_filter_fft.h"
+#include "modules/audio_processing/aec3/render_delay_buffer.h"
+#include "modules/audio_processing/aec3/vector_math.h"
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
+
+// Returns whether the running CPU can execute code for `optimization`.
+bool IsSupported(Aec3Optimization optimization) {
+  switch (optimization) {
+    case Aec3Optimization::kNone:
+      return true;
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__GNUC__)
+    case Aec3Optimization::kSse2:
+      return __builtin_cpu_supports("sse2");
+    case Aec3Optimization::kAvx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case Aec3Optimization::kAvx512:
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    default:
+      return false;
+  }
+}
+
+bool SkipIfUnsupported(benchmark::State& state,
+                       Aec3Optimization optimization) {
+  if (!IsSupported(optimization)) {
+    state.SkipWithError("Optimization not supported on this CPU");
+    return true;
+  }
+  return false;
+}
+
+void RandomizeFftData(std::mt19937* rng, float scale, FftData* X) {
+  std::uniform_real_distribution<float> dist(-scale, scale);
+  for (auto& v : X->re) {
+    v = dist(*rng);
+  }
+  for (auto& v : X->im) {
+    v = dist(*rng);
+  }
+  X->im[0] = X->im[kFftLengthBy2] = 0.f;
+}
+
+// Render side state shared by the adaptive filter benchmarks.
+class RenderFixture {
+ public:
+  RenderFixture(size_t num_render_channels, size_t num_partitions)
+      : render_delay_buffer_(RenderDelayBuffer::Create(EchoCanceller3Config(),
+                                                       kSampleRateHz,
+                                                       num_render_channels)),
+        H_(num_partitions, num_render_channels) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-32767.f, 32767.f);
+    Block x(kNumBands, num_render_channels);
+    for (int k = 0; k < 30; ++k) {
+      for (int band = 0; band < x.NumBands(); ++band) {
+        for (int ch = 0; ch < x.NumChannels(); ++ch) {
+          for (float& v : x.View(band, ch)) {
+            v = dist(rng);
+          }
+        }
+      }
+      render_delay_buffer_->Insert(x);
+      if (k == 0) {
+        render_delay_buffer_->Reset();
+      }
+      render_delay_buffer_->PrepareCaptureProcessing();
+    }
+    FftData H_p_ch;
+    for (size_t p = 0; p < num_partitions; ++p) {
+      for (size_t ch = 0; ch < num_render_channels; ++ch) {
+        RandomizeFftData(&rng, 0.1f, &H_p_ch);
+        H_[p][ch].CopyFrom(H_p_ch);
+      }
+    }
+    RandomizeFftData(&rng, 1e-4f, &G_);
+  }
+
+  const RenderBuffer& render_buffer() const {
+    return *render_delay_buffer_->GetRenderBuffer();
+  }
+  FftDataArray& H() { return H_; }
+  const FftData& G() const { return G_; }
+
+ private:
+  std::unique_ptr<RenderDelayBuffer> render_delay_buffer_;
+  FftDataArray H_;
+  FftData G_;
+};
+
+void BM_ApplyFilter(benchmark::State& state, Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  const size_t num_partitions = state.range(0);
+  const size_t num_render_channels = state.range(1);
+  RenderFixture fixture(num_render_channels, num_partitions);
+  FftData S;
+  for (auto _ : state) {
+    switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kSse2:
+        aec3::ApplyFilter_Sse2(fixture.render_buffer(), num_partitions,
+                               fixture.H(), &S);
+        break;
+      case Aec3Optimization::kAvx2:
+        aec3::ApplyFilter_Avx2(fixture.render_buffer(), num_partitions,
+                               fixture.H(), &S);
+        break;
+      case Aec3Optimization::kAvx512:
+        aec3::ApplyFilter_Avx512(fixture.render_buffer(), num_partitions,
+                                 fixture.H(), &S);
+        break;
+#endif
+      default:
+        aec3::ApplyFilter(fixture.render_buffer(), num_partitions, fixture.H(),
+                          &S);
+    }
+    benchmark::DoNotOptimize(S);
+  }
+}
+
+void BM_AdaptPartitions(benchmark::State& state,
+                        Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  const size_t num_partitions = state.range(0);
+  const size_t num_render_channels = state.range(1);
+  RenderFixture fixture(num_render_channels, num_partitions);
+  for (auto _ : state) {
+    switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kSse2:
+        aec3::AdaptPartitions_Sse2(fixture.render_buffer(), fixture.G(),
+                                   num_partitions, &fixture.H());
+        break;
+      case Aec3Optimization::kAvx2:
+        aec3::AdaptPartitions_Avx2(fixture.render_buffer(), fixture.G(),
+                                   num_partitions, &fixture.H());
+        break;
+      case Aec3Optimization::kAvx512:
+        aec3::AdaptPartitions_Avx512(fixture.render_buffer(), fixture.G(),
+                                     num_partitions, &fixture.H());
+        break;
+#endif
+      default:
+        aec3::AdaptPartitions(fixture.render_buffer(), fixture.G(),
+                              num_partitions, &fixture.H());
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+void BM_ComputeFrequencyResponse(benchmark::State& state,
+                                 Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  const size_t num_partitions = state.range(0);
+  const size_t num_render_channels = state.range(1);
+  RenderFixture fixture(num_render_channels, num_partitions);
+  std::vector<std::array<float, kFftLengthBy2Plus1>> H2(num_partitions);
+  for (auto _ : state) {
+    switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kSse2:
+        aec3::ComputeFrequencyResponse_Sse2(num_partitions, fixture.H(), &H2);
+        break;
+      case Aec3Optimization::kAvx2:
+        aec3::ComputeFrequencyResponse_Avx2(num_partitions, fixture.H(), &H2);
+        break;
+      case Aec3Optimization::kAvx512:
+        aec3::ComputeFrequencyResponse_Avx512(num_partitions, fixture.H(),
+                                              &H2);
+        break;
+#endif
+      default:
+        aec3::ComputeFrequencyResponse(num_partitions, fixture.H(), &H2);
+    }
+    benchmark::DoNotOptimize(H2.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+// Runs one sub-block of one matched filter, i.e., the innermost unit of work
+// in MatchedFilter::Update().
+void BM_MatchedFilterCore(benchmark::State& state,
+                          Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  const size_t filter_length = state.range(0);
+  const bool compute_accumulated_error = state.range(1) != 0;
+  constexpr size_t kSubBlockSize = 16;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-32767.f, 32767.f);
+  std::vector<float> x(4 * filter_length);
+  std::vector<float> y(kSubBlockSize);
+  std::vector<float> h(filter_length, 0.f);
+  std::vector<float> accumulated_error(filter_length);
+  std::vector<float> scratch_memory(filter_length);
+  for (auto& v : x) {
+    v = dist(rng);
+  }
+  for (auto& v : y) {
+    v = dist(rng);
+  }
+  // Start close to the end of the circular buffer so that the wrap-around
+  // path is included.
+  const size_t x_start_index = x.size() - filter_length / 2;
+  for (auto _ : state) {
+    bool filters_updated = false;
+    float error_sum = 0.f;
+    switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kSse2:
+        aec3::MatchedFilterCore_SSE2(x_start_index, 0.f, 0.7f, x, y, h,
+                                     &filters_updated, &error_sum,
+                                     compute_accumulated_error,
+                                     accumulated_error, scratch_memory);
+        break;
+      case Aec3Optimization::kAvx2:
+        aec3::MatchedFilterCore_AVX2(x_start_index, 0.f, 0.7f, x, y, h,
+                                     &filters_updated, &error_sum,
+                                     compute_accumulated_error,
+                                     accumulated_error, scratch_memory);
+        break;
+      case Aec3Optimization::kAvx512:
+        aec3::MatchedFilterCore_AVX512(x_start_index, 0.f, 0.7f, x, y, h,
+                                       &filters_updated, &error_sum,
+                                       compute_accumulated_error,
+                                       accumulated_error, scratch_memory);
+        break;
+#endif
+      default:
+        aec3::MatchedFilterCore(x_start_index, 0.f, 0.7f, x, y, h,
+                                &filters_updated, &error_sum,
+                                compute_accumulated_error, accumulated_error);
+    }
+    benchmark::DoNotOptimize(error_sum);
+    benchmark::ClobberMemory();
+  }
+}
+
+// Inserts a sub-block of random render samples into `render_buffer` and
+// produces a capture sub-block that is the render signal delayed by `delay`
+// samples.
+void InsertDelayedSubBlock(std::mt19937* rng,
+                           int delay,
+                           DownsampledRenderBuffer* render_buffer,
+                           rtc::ArrayView<float> y) {
+  std::uniform_real_distribution<float> dist(-32767.f, 32767.f);
+  const int sub_block_size = static_cast<int>(y.size());
+  render_buffer->UpdateWriteIndex(-sub_block_size);
+  for (int k = 0; k < sub_block_size; ++k) {
+    render_buffer->buffer[render_buffer->OffsetIndex(render_buffer->write,
+                                                     k)] = dist(*rng);
+  }
+  render_buffer->read = render_buffer->write;
+  for (int k = 0; k < sub_block_size; ++k) {
+    y[k] = render_buffer->buffer[render_buffer->OffsetIndex(
+        render_buffer->read, sub_block_size - 1 - k + delay)];
+  }
+}
+
+// Runs the FFT lag correlator on one sub-block of 16 samples per iteration for
+// a lag range of `max_lag` samples. The time per item is the time per capture
+// sample.
+void BM_MatchedFilterFft(benchmark::State& state) {
+  const size_t max_lag = state.range(0);
+  constexpr size_t kSubBlockSize = 16;
+  std::mt19937 rng(42);
+  DownsampledRenderBuffer render_buffer(2 * max_lag);
+  std::array<float, kSubBlockSize> y;
+  MatchedFilterFft correlator(kSubBlockSize, max_lag,
+                              /*excitation_limit=*/150.f);
+  for (auto _ : state) {
+    InsertDelayedSubBlock(&rng, static_cast<int>(max_lag / 2), &render_buffer,
+                          y);
+    correlator.Update(render_buffer, y);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kSubBlockSize);
+}
+
+// Runs the matched filter of the delay estimator, with the default filter sizes
+// for down-sampling factor 4, on one sub-block per iteration. The time per item
+// is the time per capture sample.
+void BM_MatchedFilterUpdate(benchmark::State& state) {
+  const int num_filters = state.range(0);
+  const bool use_fft = state.range(1) != 0;
+  const EchoCanceller3Config config;
+  const size_t sub_block_size =
+      kBlockSize / config.delay.down_sampling_factor;
+  const size_t window_size_sub_blocks = kMatchedFilterWindowSizeSubBlocks;
+  const size_t alignment_shift_sub_blocks =
+      kMatchedFilterAlignmentShiftSizeSubBlocks;
+  const size_t max_lag =
+      sub_block_size * ((num_filters - 1) * alignment_shift_sub_blocks +
+                        window_size_sub_blocks);
+  std::mt19937 rng(42);
+  DownsampledRenderBuffer render_buffer(max_lag + 4 * sub_block_size);
+  std::vector<float> y(sub_block_size);
+  ApmDataDumper data_dumper(0);
+  MatchedFilter filter(
+      &data_dumper, DetectOptimization(), sub_block_size,
+      window_size_sub_blocks, num_filters, alignment_shift_sub_blocks,
+      config.render_levels.poor_excitation_render_limit,
+      config.delay.delay_estimate_smoothing,
+      config.delay.delay_estimate_smoothing_delay_found,
+      config.delay.delay_candidate_detection_threshold,
+      config.delay.detect_pre_echo, use_fft, /*use_tracking=*/false);
+  // The echo is placed in the middle of the lag range and the matched filter
+  // is run long enough for the lag correlator to have found it.
+  const int delay = static_cast<int>(max_lag / 2);
+  for (size_t k = 0; k < 4 * max_lag / sub_block_size; ++k) {
+    InsertDelayedSubBlock(&rng, delay, &render_buffer, y);
+    filter.Update(render_buffer, y, /*use_slow_smoothing=*/false);
+  }
+  for (auto _ : state) {
+    InsertDelayedSubBlock(&rng, delay, &render_buffer, y);
+    filter.Update(render_buffer, y, /*use_slow_smoothing=*/false);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * sub_block_size);
+}
+
+void BM_PaddedFft(benchmark::State& state) {
+  const Aec3Fft::Window window = static_cast<Aec3Fft::Window>(state.range(0));
+  Aec3Fft fft;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-32767.f, 32767.f);
+  std::array<float, kFftLengthBy2> x;
+  std::array<float, kFftLengthBy2> x_old;
+  for (size_t k = 0; k < kFftLengthBy2; ++k) {
+    x[k] = dist(rng);
+    x_old[k] = dist(rng);
+  }
+  FftData X;
+  for (auto _ : state) {
+    fft.PaddedFft(x, x_old, window, &X);
+    benchmark::DoNotOptimize(X);
+  }
+}
+
+void BM_FftAndIfft(benchmark::State& state) {
+  const Aec3Fft::Backend backend =
+      static_cast<Aec3Fft::Backend>(state.range(0));
+  Aec3Fft fft(backend);
+  if (fft.backend() != backend) {
+    state.SkipWithError("FFT backend not supported on this CPU");
+    return;
+  }
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-32767.f, 32767.f);
+  std::array<float, kFftLength> x;
+  for (auto& v : x) {
+    v = dist(rng);
+  }
+  FftData X;
+  for (auto _ : state) {
+    fft.Fft(&x, &X);
+    fft.Ifft(X, &x);
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+void BM_Spectrum(benchmark::State& state, Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  std::mt19937 rng(42);
+  FftData X;
+  RandomizeFftData(&rng, 1000.f, &X);
+  std::array<float, kFftLengthBy2Plus1> X2;
+  for (auto _ : state) {
+    X.Spectrum(optimization, X2);
+    benchmark::DoNotOptimize(X2.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+// The VectorMath operations are benchmarked on spectrum sized vectors, which
+// is how they are used by the echo remover.
+struct VectorMathFixture {
+  VectorMathFixture() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(0.f, 1000.f);
+    for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
+      x[k] = dist(rng);
+      y[k] = dist(rng);
+      z[k] = dist(rng);
+    }
+  }
+  std::array<float, kFftLengthBy2Plus1> x;
+  std::array<float, kFftLengthBy2Plus1> y;
+  std::array<float, kFftLengthBy2Plus1> z;
+};
+
+void BM_VectorMathSqrt(benchmark::State& state,
+                       Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  VectorMathFixture f;
+  aec3::VectorMath math(optimization);
+  for (auto _ : state) {
+    // The values converge towards one across iterations, which does not
+    // affect the cost of the square root.
+    math.Sqrt(f.x);
+    benchmark::DoNotOptimize(f.x.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+void BM_VectorMathMultiply(benchmark::State& state,
+                           Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  VectorMathFixture f;
+  aec3::VectorMath math(optimization);
+  for (auto _ : state) {
+    math.Multiply(f.x, f.y, f.z);
+    benchmark::DoNotOptimize(f.z.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+void BM_VectorMathAccumulate(benchmark::State& state,
+                             Aec3Optimization optimization) {
+  if (SkipIfUnsupported(state, optimization)) {
+    return;
+  }
+  VectorMathFixture f;
+  aec3::VectorMath math(optimization);
+  for (auto _ : state) {
+    math.Accumulate(f.x, f.z);
+    benchmark::DoNotOptimize(f.z.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+// {num_partitions, num_render_channels}. 13 partitions is the default refined
+// and coarse filter length; 40 corresponds to a long refined filter.
+void FilterArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"partitions", "channels"});
+  for (int num_render_channels : {1, 2}) {
+    for (int num_partitions : {13, 40}) {
+      b->Args({num_partitions, num_render_channels});
+    }
+  }
+}
+
+// {filter_length, compute_accumulated_error}. 512 taps is the matched filter
+// length used by the default configuration.
+void MatchedFilterArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"taps", "accumulated_error"});
+  b->Args({512, 0});
+  b->Args({512, 1});
+}
+
+#define AEC3_BENCHMARK_VARIANTS(func, ...)                           \
+  BENCHMARK_CAPTURE(func, kNone, Aec3Optimization::kNone)            \
+      __VA_ARGS__;                                                   \
+  BENCHMARK_CAPTURE(func, kSse2, Aec3Optimization::kSse2)            \
+      __VA_ARGS__;                                                   \
+  BENCHMARK_CAPTURE(func, kAvx2, Aec3Optimization::kAvx2)            \
+      __VA_ARGS__;                                                   \
+  BENCHMARK_CAPTURE(func, kAvx512, Aec3Optimization::kAvx512) __VA_ARGS__
+
+AEC3_BENCHMARK_VARIANTS(BM_ApplyFilter, ->Apply(FilterArgs));
+AEC3_BENCHMARK_VARIANTS(BM_AdaptPartitions, ->Apply(FilterArgs));
+AEC3_BENCHMARK_VARIANTS(BM_ComputeFrequencyResponse, ->Apply(FilterArgs));
+AEC3_BENCHMARK_VARIANTS(BM_MatchedFilterCore, ->Apply(MatchedFilterArgs));
+BENCHMARK(BM_MatchedFilterFft)
+    ->ArgName("max_lag")
+    ->RangeMultiplier(2)
+    ->Range(512, 16384);
+BENCHMARK(BM_MatchedFilterUpdate)
+    ->ArgNames({"filters", "use_fft"})
+    ->ArgsProduct({{5, 10, 20, 40}, {0, 1}});
+AEC3_BENCHMARK_VARIANTS(BM_Spectrum);
+AEC3_BENCHMARK_VARIANTS(BM_VectorMathSqrt);
+AEC3_BENCHMARK_VARIANTS(BM_VectorMathMultiply);
+AEC3_BENCHMARK_VARIANTS(BM_VectorMathAccumulate);
+
+BENCHMARK(BM_PaddedFft)
+    ->ArgName("window")
+    ->Arg(static_cast<int>(Aec3Fft::Window::kRectangular))
+    ->Arg(static_cast<int>(Aec3Fft::Window::kHanning))
+    ->Arg(static_cast<int>(Aec3Fft::Window::kSqrtHanning));
+BENCHMARK(BM_FftAndIfft)
+    ->ArgName("backend")
+    ->Arg(static_cast<int>(Aec3Fft::Backend::kOoura))
+    ->Arg(static_cast<int>(Aec3Fft::Backend::kPffft))
+    ->Arg(static_cast<int>(Aec3Fft::Backend::kAvx2));
+
+}  // namespace
+}  // namespace webrtc
@@ -323,6 +323,26 @@ void AecState::Update(
                         subtractor_output[0].e2_refined);
 }
 
+void AecState::SaveWarmStartState(Aec3WarmStartState* state) const {
+  RTC_DCHECK_EQ(state->capture_channels.size(), num_capture_channels_);
+  state->erl = erl_estimator_.Erl();
+  state->erl_time_domain = erl_estimator_.ErlTimeDomain();
+  erle_estimator_.SaveWarmStartState(state);
+  reverb_model_estimator_.SaveWarmStartState(state);
+}
+
+void AecState::RestoreWarmStartState(const Aec3WarmStartState& state) {
+  RTC_DCHECK_EQ(state.capture_channels.size(), num_capture_channels_);
+  erl_estimator_.SetErl(state.erl, state.erl_time_domain);
+  erle_estimator_.RestoreWarmStartState(state);
+  reverb_model_estimator_.RestoreWarmStartState(state);
+  initial_state_.Complete();
+  filter_quality_state_.SetConverged();
+  strong_not_saturated_render_blocks_ =
+      std::max(strong_not_saturated_render_blocks_,
+               static_cast<size_t>(2 * kNumBlocksPerSecond));
+}
+
 AecState::InitialState::InitialState(const EchoCanceller3Config& config)
     : conservative_initial_phase_(config.filter.conservative_initial_phase),
       initial_state_seconds_(config.filter.initial_state_seconds) {
@@ -332,6 +352,16 @@ void AecState::InitialState::InitialState::Reset() {
   initial_state_ = true;
   strong_not_saturated_render_blocks_ = 0;
 }
+void AecState::InitialState::Complete() {
+  const float initial_state_seconds =
+      conservative_initial_phase_ ? 5.f : initial_state_seconds_;
+  initial_state_ = false;
+  transition_triggered_ = false;
+  strong_not_saturated_render_blocks_ = std::max(
+      strong_not_saturated_render_blocks_,
+      static_cast<size_t>(initial_state_seconds * kNumBlocksPerSecond) + 1);
+}
+
 void AecState::InitialState::InitialState::Update(bool active_render,
                                                   bool saturated_capture) {
   strong_not_saturated_render_blocks_ +=
@@ -401,6 +431,16 @@ void AecState::FilteringQualityAnalyzer::Reset() {
   filter_update_blocks_since_reset_ = 0;
 }
 
+void AecState::FilteringQualityAnalyzer::SetConverged() {
+  convergence_seen_ = true;
+  filter_update_blocks_since_start_ =
+      std::max(filter_update_blocks_since_start_,
+               static_cast<size_t>(kNumBlocksPerSecond));
+  filter_update_blocks_since_reset_ =
+      std::max(filter_update_blocks_since_reset_,
+               static_cast<size_t>(kNumBlocksPerSecond));
+}
+
 void AecState::FilteringQualityAnalyzer::Update(
     bool active_render,
     bool transparent_mode,
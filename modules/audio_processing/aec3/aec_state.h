@@ -33,6 +33,7 @@
 #include "modules/audio_processing/aec3/subtractor_output.h"
 #include "modules/audio_processing/aec3/subtractor_output_analyzer.h"
 #include "modules/audio_processing/aec3/transparent_mode.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 
 namespace webrtc {
 
@@ -148,6 +149,13 @@ class AecState {
       rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> Y2,
       rtc::ArrayView<const SubtractorOutput> subtractor_output);
 
+  // Saves the ERL, ERLE and reverb estimates into `state`.
+  void SaveWarmStartState(Aec3WarmStartState* state) const;
+
+  // Restores the ERL, ERLE and reverb estimates from `state` and ends the
+  // initial state, so that the restored linear filters are used right away.
+  void RestoreWarmStartState(const Aec3WarmStartState& state);
+
   // Returns filter length in blocks.
   int FilterLengthBlocks() const {
     // All filters have the same length, so arbitrarily return channel 0 length.
@@ -171,6 +179,9 @@ class AecState {
     // Resets the state to again begin in the initial state.
     void Reset();
 
+    // Ends the initial state.
+    void Complete();
+
     // Updates the state based on new data.
     void Update(bool active_render, bool saturated_capture);
 
@@ -249,6 +260,10 @@ class AecState {
     // Resets the state of the analyzer.
     void Reset();
 
+    // Sets the state to that of an analyzer that has seen the filters
+    // converge.
+    void SetConverged();
+
     // Updates the analysis based on new data.
     void Update(bool active_render,
                 bool transparent_mode,
@@ -16,7 +16,11 @@ namespace webrtc {
 
 BlockBuffer::BlockBuffer(size_t size, size_t num_bands, size_t num_channels)
     : size(static_cast<int>(size)),
-      buffer(size, Block(num_bands, num_channels)) {}
+      buffer(storage_),
+      storage_(size, Block(num_bands, num_channels)) {}
+
+BlockBuffer::BlockBuffer(BlockBuffer* other)
+    : size(other->size), buffer(other->buffer) {}
 
 BlockBuffer::~BlockBuffer() = default;
 
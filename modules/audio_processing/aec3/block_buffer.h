@@ -24,6 +24,11 @@ namespace webrtc {
 // together with the read and write indices.
 struct BlockBuffer {
   BlockBuffer(size_t size, size_t num_bands, size_t num_channels);
+  // Creates a buffer with its own read and write indices that shares the
+  // stored blocks with `other`, which must outlive the created buffer.
+  explicit BlockBuffer(BlockBuffer* other);
+  BlockBuffer(const BlockBuffer&) = delete;
+  BlockBuffer& operator=(const BlockBuffer&) = delete;
   ~BlockBuffer();
 
   int IncIndex(int index) const {
@@ -50,9 +55,13 @@ struct BlockBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<Block> buffer;
+  std::vector<Block>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  // Holds the blocks unless they are shared with another buffer.
+  std::vector<Block> storage_;
 };
 
 }  // namespace webrtc
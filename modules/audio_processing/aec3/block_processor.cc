@@ -26,6 +26,7 @@
 #include "modules/audio_processing/aec3/echo_remover.h"
 #include "modules/audio_processing/aec3/render_delay_buffer.h"
 #include "modules/audio_processing/aec3/render_delay_controller.h"
+#include "modules/audio_processing/aec3/stage_profiler.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -62,8 +63,14 @@ class BlockProcessorImpl final : public BlockProcessor {
 
   void SetAudioBufferDelay(int delay_ms) override;
   void SetCaptureOutputUsage(bool capture_output_used) override;
+  void SaveWarmStartState(Aec3WarmStartState* state) const override;
+  void RestoreWarmStartState(const Aec3WarmStartState& state) override;
+  void SetComputeTier(Aec3ComputeTier tier) override;
 
  private:
+  // Applies a delay restored from a warm start state.
+  void ApplyRestoredDelay();
+
   static std::atomic<int> instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
   const EchoCanceller3Config config_;
@@ -77,6 +84,7 @@ class BlockProcessorImpl final : public BlockProcessor {
   RenderDelayBuffer::BufferingEvent render_event_;
   size_t capture_call_counter_ = 0;
   absl::optional<DelayEstimate> estimated_delay_;
+  absl::optional<size_t> restored_delay_samples_;
 };
 
 std::atomic<int> BlockProcessorImpl::instance_count_(0);
@@ -122,6 +130,7 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
       render_buffer_->Reset();
       if (delay_controller_)
         delay_controller_->Reset(true);
+      ApplyRestoredDelay();
     }
   } else {
     // If no render data has yet arrived, do not process the capture signal.
@@ -147,8 +156,11 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
   // Update the render buffers with any newly arrived render blocks and prepare
   // the render buffers for reading the render data corresponding to the current
   // capture block.
-  RenderDelayBuffer::BufferingEvent buffer_event =
-      render_buffer_->PrepareCaptureProcessing();
+  RenderDelayBuffer::BufferingEvent buffer_event;
+  {
+    ScopedStageTimer timer(Aec3Stage::kPrepareCaptureProcessing);
+    buffer_event = render_buffer_->PrepareCaptureProcessing();
+  }
   // Reset the delay controller at render buffer underrun.
   if (buffer_event == RenderDelayBuffer::BufferingEvent::kRenderUnderrun) {
     if (delay_controller_)
@@ -164,9 +176,12 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
     RTC_DCHECK(delay_controller_);
     // Compute and apply the render delay required to achieve proper signal
     // alignment.
-    estimated_delay_ = delay_controller_->GetDelay(
-        render_buffer_->GetDownsampledRenderBuffer(), render_buffer_->Delay(),
-        *capture_block);
+    {
+      ScopedStageTimer timer(Aec3Stage::kGetDelay);
+      estimated_delay_ = delay_controller_->GetDelay(
+          render_buffer_->GetDownsampledRenderBuffer(),
+          render_buffer_->Delay(), *capture_block);
+    }
 
     if (estimated_delay_) {
       bool delay_change =
@@ -183,6 +198,7 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
     }
 
     echo_path_variability.clock_drift = delay_controller_->HasClockdrift();
+    delay_controller_->HandleEchoPathChange(echo_path_variability);
 
   } else {
     render_buffer_->AlignFromExternalDelay();
@@ -235,6 +251,46 @@ void BlockProcessorImpl::SetCaptureOutputUsage(bool capture_output_used) {
   echo_remover_->SetCaptureOutputUsage(capture_output_used);
 }
 
+void BlockProcessorImpl::SaveWarmStartState(Aec3WarmStartState* state) const {
+  echo_remover_->SaveWarmStartState(state);
+  state->delay_samples =
+      delay_controller_ ? delay_controller_->DelaySamples() : absl::nullopt;
+}
+
+void BlockProcessorImpl::SetComputeTier(Aec3ComputeTier tier) {
+  echo_remover_->SetComputeTier(tier);
+  if (delay_controller_) {
+    delay_controller_->SetComputeTier(tier);
+  }
+}
+
+void BlockProcessorImpl::RestoreWarmStartState(
+    const Aec3WarmStartState& state) {
+  echo_remover_->RestoreWarmStartState(state);
+  restored_delay_samples_ =
+      delay_controller_ ? state.delay_samples : absl::nullopt;
+  // Before the capture processing has started, the delay controller and the
+  // render delay buffer are still to be reset.
+  if (capture_properly_started_) {
+    ApplyRestoredDelay();
+  }
+}
+
+void BlockProcessorImpl::ApplyRestoredDelay() {
+  if (!restored_delay_samples_) {
+    return;
+  }
+  RTC_DCHECK(delay_controller_);
+  estimated_delay_ = delay_controller_->RestoreDelay(*restored_delay_samples_);
+  restored_delay_samples_ = absl::nullopt;
+  if (estimated_delay_) {
+    // Aligning before the delay is estimated for the next capture block
+    // avoids the echo path change that a delay change would otherwise cause,
+    // as that would reset the restored filters.
+    render_buffer_->AlignFromDelay(estimated_delay_->delay);
+  }
+}
+
 }  // namespace
 
 BlockProcessor* BlockProcessor::Create(const EchoCanceller3Config& config,
@@ -255,6 +311,18 @@ BlockProcessor* BlockProcessor::Create(const EchoCanceller3Config& config,
                 std::move(delay_controller), std::move(echo_remover));
 }
 
+BlockProcessor* BlockProcessor::Create(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    size_t num_render_channels,
+    size_t num_capture_channels,
+    rtc::scoped_refptr<SharedRenderPipeline> render_pipeline) {
+  std::unique_ptr<RenderDelayBuffer> render_buffer(RenderDelayBuffer::Create(
+      config, sample_rate_hz, num_render_channels, std::move(render_pipeline)));
+  return Create(config, sample_rate_hz, num_render_channels,
+                num_capture_channels, std::move(render_buffer));
+}
+
 BlockProcessor* BlockProcessor::Create(
     const EchoCanceller3Config& config,
     int sample_rate_hz,
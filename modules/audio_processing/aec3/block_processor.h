@@ -18,10 +18,14 @@
 
 #include "api/audio/echo_canceller3_config.h"
 #include "api/audio/echo_control.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "api/scoped_refptr.h"
 #include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/echo_remover.h"
 #include "modules/audio_processing/aec3/render_delay_buffer.h"
 #include "modules/audio_processing/aec3/render_delay_controller.h"
+#include "modules/audio_processing/aec3/shared_render_pipeline.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 
 namespace webrtc {
 
@@ -32,6 +36,14 @@ class BlockProcessor {
                                 int sample_rate_hz,
                                 size_t num_render_channels,
                                 size_t num_capture_channels);
+  // Creates a block processor whose render delay buffer reads the render data
+  // computed by `render_pipeline`.
+  static BlockProcessor* Create(
+      const EchoCanceller3Config& config,
+      int sample_rate_hz,
+      size_t num_render_channels,
+      size_t num_capture_channels,
+      rtc::scoped_refptr<SharedRenderPipeline> render_pipeline);
   // Only used for testing purposes.
   static BlockProcessor* Create(
       const EchoCanceller3Config& config,
@@ -74,6 +86,17 @@ class BlockProcessor {
   // resulting output is anyway not used, for instance when the endpoint is
   // muted.
   virtual void SetCaptureOutputUsage(bool capture_output_used) = 0;
+
+  // Saves the converged state of the echo cancellation into `state`.
+  virtual void SaveWarmStartState(Aec3WarmStartState* /*state*/) const {}
+
+  // Restores a state saved by a block processor with the same setup. The
+  // restored delay is applied when the capture processing starts.
+  virtual void RestoreWarmStartState(const Aec3WarmStartState& /*state*/) {}
+
+  // Reduces the computational complexity of the processing according to
+  // `tier`, in order to stay within a CPU budget.
+  virtual void SetComputeTier(Aec3ComputeTier /*tier*/) {}
 };
 
 }  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/block_stream_adapter.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+BlockStreamAdapter::BlockStreamAdapter(size_t num_bands, size_t num_channels)
+    : num_bands_(num_bands),
+      num_channels_(num_channels),
+      block_(num_bands, num_channels) {
+  RTC_DCHECK_LT(0, num_bands);
+  RTC_DCHECK_LT(0, num_channels);
+}
+
+BlockStreamAdapter::~BlockStreamAdapter() = default;
+
+size_t BlockStreamAdapter::ExchangeSamples(
+    const std::vector<std::vector<rtc::ArrayView<float>>>& chunk,
+    size_t offset) {
+  RTC_DCHECK_EQ(num_bands_, chunk.size());
+  RTC_DCHECK_EQ(num_channels_, chunk[0].size());
+  const size_t num_samples = PrepareInsertion(chunk[0][0].size(), offset);
+  for (size_t band = 0; band < num_bands_; ++band) {
+    for (size_t channel = 0; channel < num_channels_; ++channel) {
+      RTC_DCHECK_EQ(chunk[0][0].size(), chunk[band][channel].size());
+      auto chunk_begin = chunk[band][channel].begin() + offset;
+      std::swap_ranges(chunk_begin, chunk_begin + num_samples,
+                       block_.begin(band, channel) + position_);
+    }
+  }
+  position_ += num_samples;
+  return num_samples;
+}
+
+size_t BlockStreamAdapter::InsertSamples(
+    const std::vector<std::vector<rtc::ArrayView<const float>>>& chunk,
+    size_t offset) {
+  RTC_DCHECK_EQ(num_bands_, chunk.size());
+  RTC_DCHECK_EQ(num_channels_, chunk[0].size());
+  const size_t num_samples = PrepareInsertion(chunk[0][0].size(), offset);
+  for (size_t band = 0; band < num_bands_; ++band) {
+    for (size_t channel = 0; channel < num_channels_; ++channel) {
+      RTC_DCHECK_EQ(chunk[0][0].size(), chunk[band][channel].size());
+      auto chunk_begin = chunk[band][channel].begin() + offset;
+      std::copy(chunk_begin, chunk_begin + num_samples,
+                block_.begin(band, channel) + position_);
+    }
+  }
+  position_ += num_samples;
+  return num_samples;
+}
+
+void BlockStreamAdapter::Reset() {
+  block_.SetNumChannels(num_channels_);
+  position_ = 0;
+}
+
+size_t BlockStreamAdapter::PrepareInsertion(size_t chunk_length,
+                                            size_t offset) {
+  RTC_DCHECK_LE(offset, chunk_length);
+  if (position_ == kBlockSize) {
+    position_ = 0;
+  }
+  return std::min(chunk_length - offset, kBlockSize - position_);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_BLOCK_STREAM_ADAPTER_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_BLOCK_STREAM_ADAPTER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/block.h"
+
+namespace webrtc {
+
+// Adapts multiband chunks of arbitrary length, e.g., the 2.5 ms or 5 ms
+// periods of an audio device, to the 64 sample blocks of the block-level
+// EchoCanceller3 API. The samples are copied into an internal block, and the
+// samples of a processed block are handed back while the samples of the next
+// block are inserted. The capture signal is therefore delayed by kBlockSize
+// samples, i.e., 4 ms, for any chunk length, in addition to any delay of the
+// echo canceller itself. Callers that report the audio latency must include
+// this delay. A chunk is processed as
+//
+//   for (size_t k = 0; k < chunk_length;) {
+//     k += adapter.ExchangeSamples(chunk, k);
+//     if (adapter.IsBlockComplete()) {
+//       echo_canceller.ProcessCaptureBlock(..., adapter.block());
+//     }
+//   }
+class BlockStreamAdapter {
+ public:
+  BlockStreamAdapter(size_t num_bands, size_t num_channels);
+  ~BlockStreamAdapter();
+  BlockStreamAdapter(const BlockStreamAdapter&) = delete;
+  BlockStreamAdapter& operator=(const BlockStreamAdapter&) = delete;
+
+  // Swaps the samples of `chunk` starting at `offset` with the samples of the
+  // previously processed block, until either the chunk is exhausted or the
+  // block is complete. Returns the number of swapped samples per band and
+  // channel.
+  size_t ExchangeSamples(
+      const std::vector<std::vector<rtc::ArrayView<float>>>& chunk,
+      size_t offset);
+  // As ExchangeSamples, but only copies the samples into the block. Intended
+  // for the render signal, for which no output is produced.
+  size_t InsertSamples(
+      const std::vector<std::vector<rtc::ArrayView<const float>>>& chunk,
+      size_t offset);
+  // Reports whether the block is complete and should be processed before more
+  // samples are inserted.
+  bool IsBlockComplete() const { return position_ == kBlockSize; }
+  // Returns the block, which is to be processed in place once complete.
+  Block* block() { return &block_; }
+  // Clears the block and restarts the assembly of it.
+  void Reset();
+
+ private:
+  // Returns the number of samples of a chunk of length `chunk_length` that
+  // fit into the block, and restarts the block if it has been completed.
+  size_t PrepareInsertion(size_t chunk_length, size_t offset);
+
+  const size_t num_bands_;
+  const size_t num_channels_;
+  Block block_;
+  size_t position_ = 0;
+};
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_BLOCK_STREAM_ADAPTER_H_
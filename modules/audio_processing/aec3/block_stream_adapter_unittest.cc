@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/block_stream_adapter.h"
+
+#include <vector>
+
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "rtc_base/strings/string_builder.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumBands = 3;
+constexpr size_t kNumChannels = 2;
+
+float ComputeSampleValue(size_t sample_index, size_t band, size_t channel) {
+  return 1.0f + sample_index + 10000.0f * band + 100000.0f * channel;
+}
+
+// Creates a chunk holding the `chunk_length` samples following
+// `sample_index`.
+std::vector<std::vector<std::vector<float>>> CreateChunk(size_t sample_index,
+                                                         size_t chunk_length) {
+  std::vector<std::vector<std::vector<float>>> chunk(
+      kNumBands, std::vector<std::vector<float>>(
+                     kNumChannels, std::vector<float>(chunk_length)));
+  for (size_t band = 0; band < kNumBands; ++band) {
+    for (size_t channel = 0; channel < kNumChannels; ++channel) {
+      for (size_t k = 0; k < chunk_length; ++k) {
+        chunk[band][channel][k] =
+            ComputeSampleValue(sample_index + k, band, channel);
+      }
+    }
+  }
+  return chunk;
+}
+
+template <typename T>
+std::vector<std::vector<rtc::ArrayView<T>>> CreateView(
+    std::vector<std::vector<std::vector<float>>>& chunk) {
+  std::vector<std::vector<rtc::ArrayView<T>>> view(
+      kNumBands, std::vector<rtc::ArrayView<T>>(kNumChannels));
+  for (size_t band = 0; band < kNumBands; ++band) {
+    for (size_t channel = 0; channel < kNumChannels; ++channel) {
+      view[band][channel] = chunk[band][channel];
+    }
+  }
+  return view;
+}
+
+std::string ProduceDebugText(size_t chunk_length) {
+  rtc::StringBuilder ss;
+  ss << "Chunk length: " << chunk_length;
+  return ss.Release();
+}
+
+}  // namespace
+
+// Verifies that the samples of the completed blocks are returned with a delay
+// of one block, irrespective of the chunk length.
+TEST(BlockStreamAdapter, ExchangeDelaysByOneBlock) {
+  for (size_t chunk_length : {1, 40, 63, 64, 80, 160, 441}) {
+    SCOPED_TRACE(ProduceDebugText(chunk_length));
+    BlockStreamAdapter adapter(kNumBands, kNumChannels);
+    size_t num_blocks = 0;
+    for (size_t sample_index = 0; sample_index < 20 * kBlockSize;
+         sample_index += chunk_length) {
+      auto chunk = CreateChunk(sample_index, chunk_length);
+      auto view = CreateView<float>(chunk);
+      for (size_t k = 0; k < chunk_length;) {
+        k += adapter.ExchangeSamples(view, k);
+        if (adapter.IsBlockComplete()) {
+          const Block& block = *adapter.block();
+          for (size_t band = 0; band < kNumBands; ++band) {
+            for (size_t channel = 0; channel < kNumChannels; ++channel) {
+              for (size_t j = 0; j < kBlockSize; ++j) {
+                ASSERT_EQ(block.View(band, channel)[j],
+                          ComputeSampleValue(num_blocks * kBlockSize + j, band,
+                                             channel));
+              }
+            }
+          }
+          ++num_blocks;
+        }
+      }
+
+      for (size_t band = 0; band < kNumBands; ++band) {
+        for (size_t channel = 0; channel < kNumChannels; ++channel) {
+          for (size_t k = 0; k < chunk_length; ++k) {
+            const float expected =
+                sample_index + k < kBlockSize
+                    ? 0.0f
+                    : ComputeSampleValue(sample_index + k - kBlockSize, band,
+                                         channel);
+            ASSERT_EQ(chunk[band][channel][k], expected);
+          }
+        }
+      }
+    }
+    EXPECT_LT(0u, num_blocks);
+  }
+}
+
+// Verifies that the inserted samples form consecutive blocks and that the
+// assembly restarts after a reset.
+TEST(BlockStreamAdapter, InsertFormsBlocks) {
+  constexpr size_t kChunkLength = 40;
+  BlockStreamAdapter adapter(kNumBands, kNumChannels);
+  auto chunk = CreateChunk(0, kChunkLength);
+  EXPECT_EQ(adapter.InsertSamples(CreateView<const float>(chunk), 0),
+            kChunkLength);
+  EXPECT_FALSE(adapter.IsBlockComplete());
+  adapter.Reset();
+
+  size_t num_blocks = 0;
+  for (size_t sample_index = 0; sample_index < 10 * kBlockSize;
+       sample_index += kChunkLength) {
+    chunk = CreateChunk(sample_index, kChunkLength);
+    auto view = CreateView<const float>(chunk);
+    for (size_t k = 0; k < kChunkLength;) {
+      k += adapter.InsertSamples(view, k);
+      if (adapter.IsBlockComplete()) {
+        const Block& block = *adapter.block();
+        for (size_t band = 0; band < kNumBands; ++band) {
+          for (size_t channel = 0; channel < kNumChannels; ++channel) {
+            for (size_t j = 0; j < kBlockSize; ++j) {
+              ASSERT_EQ(block.View(band, channel)[j],
+                        ComputeSampleValue(num_blocks * kBlockSize + j, band,
+                                           channel));
+            }
+          }
+        }
+        ++num_blocks;
+      }
+    }
+  }
+  EXPECT_EQ(num_blocks, 10u);
+}
+
+}  // namespace webrtc
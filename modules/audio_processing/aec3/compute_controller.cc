@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/compute_controller.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "api/make_ref_counted.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+// Time constant of the smoothing of the load.
+constexpr int64_t kLoadSmoothingTimeNs = rtc::kNumNanosecsPerSec;
+
+// Minimum times in a tier before it is degraded and restored, respectively.
+// Restoring is slower to avoid oscillations between the tiers.
+constexpr int64_t kMinTimeBeforeDegradeNs = 2 * rtc::kNumNanosecsPerSec;
+constexpr int64_t kMinTimeBeforeRestoreNs = 5 * rtc::kNumNanosecsPerSec;
+
+// Fraction of the budgets below which the load must be for restoring a tier.
+constexpr float kRestoreFraction = 0.5f;
+
+constexpr float kPpmPerUnit = 1e6f;
+
+}  // namespace
+
+rtc::scoped_refptr<Aec3ComputeBudget> Aec3ComputeBudget::Create(
+    float max_load) {
+  return rtc::make_ref_counted<Aec3ComputeBudget>(max_load);
+}
+
+Aec3ComputeBudget::Aec3ComputeBudget(float max_load) : max_load_(max_load) {
+  RTC_DCHECK_LT(0.0f, max_load);
+}
+
+Aec3ComputeBudget::~Aec3ComputeBudget() = default;
+
+float Aec3ComputeBudget::TotalLoad() const {
+  return total_load_ppm_.load(std::memory_order_relaxed) / kPpmPerUnit;
+}
+
+Aec3ComputeController::Aec3ComputeController(
+    float max_load,
+    rtc::scoped_refptr<Aec3ComputeBudget> shared_budget)
+    : max_load_(max_load), shared_budget_(std::move(shared_budget)) {
+  RTC_DCHECK_LE(0.0f, max_load);
+  if (shared_budget_) {
+    shared_budget_->AddUser();
+  }
+}
+
+Aec3ComputeController::~Aec3ComputeController() {
+  if (shared_budget_) {
+    shared_budget_->AddLoad(-reported_load_ppm_);
+    shared_budget_->RemoveUser();
+  }
+}
+
+bool Aec3ComputeController::Update(int64_t processing_ns,
+                                   int64_t audio_duration_ns) {
+  RTC_DCHECK_LT(0, audio_duration_ns);
+  const float instantaneous_load =
+      static_cast<float>(processing_ns) / audio_duration_ns;
+  const float alpha = std::min(
+      1.0f, static_cast<float>(audio_duration_ns) / kLoadSmoothingTimeNs);
+  load_ += alpha * (instantaneous_load - load_);
+
+  if (shared_budget_) {
+    const int64_t load_ppm = static_cast<int64_t>(load_ * kPpmPerUnit);
+    shared_budget_->AddLoad(load_ppm - reported_load_ppm_);
+    reported_load_ppm_ = load_ppm;
+  }
+
+  time_in_tier_ns_ += audio_duration_ns;
+  const int tier = static_cast<int>(tier_);
+  const int max_tier = static_cast<int>(Aec3ComputeTier::kNumTiers) - 1;
+  int new_tier = tier;
+  if (tier < max_tier && time_in_tier_ns_ >= kMinTimeBeforeDegradeNs &&
+      ExceedsBudget(1.0f)) {
+    new_tier = tier + 1;
+  } else if (tier > 0 && time_in_tier_ns_ >= kMinTimeBeforeRestoreNs &&
+             !ExceedsBudget(kRestoreFraction)) {
+    new_tier = tier - 1;
+  }
+  if (new_tier == tier) {
+    return false;
+  }
+  tier_ = static_cast<Aec3ComputeTier>(new_tier);
+  time_in_tier_ns_ = 0;
+  return true;
+}
+
+bool Aec3ComputeController::ExceedsBudget(float fraction) const {
+  if (max_load_ > 0.0f && load_ > fraction * max_load_) {
+    return true;
+  }
+  if (!shared_budget_) {
+    return false;
+  }
+  const float total_load = shared_budget_->TotalLoad();
+  if (total_load <= fraction * shared_budget_->max_load()) {
+    return false;
+  }
+  // When the shared budget is exceeded, only the echo cancellers using at
+  // least their fair share of it are degraded.
+  const float fair_share = total_load / std::max(shared_budget_->NumUsers(), 1);
+  return fraction < 1.0f || load_ >= fair_share;
+}
+
+}  // namespace webrtc
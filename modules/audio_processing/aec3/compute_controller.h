@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_COMPUTE_CONTROLLER_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_COMPUTE_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "api/scoped_refptr.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "rtc_base/ref_count.h"
+
+namespace webrtc {
+
+// CPU budget shared by a group of echo cancellers, e.g., all the echo
+// cancellers running on a host. The budget is expressed as the fraction of
+// real time that the capture processing of the echo cancellers may use in
+// total. The loads are reported by the Aec3ComputeControllers of the echo
+// cancellers, which may run on different threads.
+class Aec3ComputeBudget : public rtc::RefCountInterface {
+ public:
+  static rtc::scoped_refptr<Aec3ComputeBudget> Create(float max_load);
+
+  explicit Aec3ComputeBudget(float max_load);
+  ~Aec3ComputeBudget() override;
+
+  Aec3ComputeBudget(const Aec3ComputeBudget&) = delete;
+  Aec3ComputeBudget& operator=(const Aec3ComputeBudget&) = delete;
+
+  float max_load() const { return max_load_; }
+
+  // Returns the sum of the loads of the echo cancellers using the budget.
+  float TotalLoad() const;
+
+  // Returns the number of echo cancellers using the budget.
+  int NumUsers() const { return num_users_.load(std::memory_order_relaxed); }
+
+ private:
+  friend class Aec3ComputeController;
+
+  void AddUser() { num_users_.fetch_add(1, std::memory_order_relaxed); }
+  void RemoveUser() { num_users_.fetch_sub(1, std::memory_order_relaxed); }
+  void AddLoad(int64_t load_ppm) {
+    total_load_ppm_.fetch_add(load_ppm, std::memory_order_relaxed);
+  }
+
+  const float max_load_;
+  // The loads are summed in parts per million to allow atomic additions.
+  std::atomic<int64_t> total_load_ppm_{0};
+  std::atomic<int> num_users_{0};
+};
+
+// Chooses the compute tier of an echo canceller from the measured execution
+// times of its capture processing. The tier is degraded one step at a time
+// when the load exceeds the budget of the echo canceller or when the shared
+// budget is exceeded and the echo canceller uses at least its fair share of
+// it. The tier is restored, more slowly, when the loads are well within the
+// budgets.
+class Aec3ComputeController {
+ public:
+  // `max_load` is the fraction of real time that the capture processing may
+  // use, or zero for only applying the shared budget. `shared_budget` may be
+  // null.
+  Aec3ComputeController(float max_load,
+                        rtc::scoped_refptr<Aec3ComputeBudget> shared_budget);
+  ~Aec3ComputeController();
+
+  Aec3ComputeController(const Aec3ComputeController&) = delete;
+  Aec3ComputeController& operator=(const Aec3ComputeController&) = delete;
+
+  // Reports that the processing of `audio_duration_ns` of audio took
+  // `processing_ns`. Returns true if the compute tier was changed.
+  bool Update(int64_t processing_ns, int64_t audio_duration_ns);
+
+  // Returns the chosen compute tier.
+  Aec3ComputeTier tier() const { return tier_; }
+
+  // Returns the smoothed fraction of real time used by the processing.
+  float load() const { return load_; }
+
+ private:
+  // Returns whether the load exceeds the budgets, or is well within them when
+  // `fraction` is less than one.
+  bool ExceedsBudget(float fraction) const;
+
+  const float max_load_;
+  const rtc::scoped_refptr<Aec3ComputeBudget> shared_budget_;
+  float load_ = 0.0f;
+  int64_t reported_load_ppm_ = 0;
+  int64_t time_in_tier_ns_ = 0;
+  Aec3ComputeTier tier_ = Aec3ComputeTier::kFull;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_COMPUTE_CONTROLLER_H_
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/compute_controller.h"
+
+#include <memory>
+
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kFrameDurationNs = rtc::kNumNanosecsPerSec / 100;
+
+// Reports `num_frames` frames of 10 ms processed at `load`.
+void RunFrames(Aec3ComputeController& controller, float load, int num_frames) {
+  for (int k = 0; k < num_frames; ++k) {
+    controller.Update(static_cast<int64_t>(load * kFrameDurationNs),
+                      kFrameDurationNs);
+  }
+}
+
+}  // namespace
+
+// Verifies that the tier is degraded step by step while the budget is
+// exceeded and restored once the load is well within the budget.
+TEST(Aec3ComputeController, DegradesAndRestoresWithLoad) {
+  Aec3ComputeController controller(/*max_load=*/0.5f, nullptr);
+  RunFrames(controller, 0.3f, 1000);
+  EXPECT_EQ(controller.tier(), Aec3ComputeTier::kFull);
+  EXPECT_NEAR(controller.load(), 0.3f, 0.01f);
+
+  RunFrames(controller, 0.8f, 150);
+  EXPECT_EQ(controller.tier(), Aec3ComputeTier::kReducedDelayEstimation);
+  RunFrames(controller, 0.8f, 1000);
+  EXPECT_EQ(controller.tier(), Aec3ComputeTier::kReducedFilterLength);
+
+  RunFrames(controller, 0.1f, 100);
+  EXPECT_EQ(controller.tier(), Aec3ComputeTier::kReducedFilterLength);
+  RunFrames(controller, 0.1f, 3000);
+  EXPECT_EQ(controller.tier(), Aec3ComputeTier::kFull);
+}
+
+// Verifies that a load between the restore and degrade thresholds keeps the
+// tier.
+TEST(Aec3ComputeController, HoldsTierBetweenThresholds) {
+  Aec3ComputeController controller(/*max_load=*/0.5f, nullptr);
+  RunFrames(controller, 0.8f, 250);
+  ASSERT_EQ(controller.tier(), Aec3ComputeTier::kReducedDelayEstimation);
+  RunFrames(controller, 0.35f, 3000);
+  EXPECT_EQ(controller.tier(), Aec3ComputeTier::kReducedDelayEstimation);
+}
+
+// Verifies that only the echo cancellers that use at least their fair share
+// of an exceeded shared budget are degraded, and that the load of a destroyed
+// controller is removed from the budget.
+TEST(Aec3ComputeController, SharedBudgetDegradesHeaviestUser) {
+  auto budget = Aec3ComputeBudget::Create(/*max_load=*/1.0f);
+  auto heavy = std::make_unique<Aec3ComputeController>(0.0f, budget);
+  Aec3ComputeController light(0.0f, budget);
+  EXPECT_EQ(budget->NumUsers(), 2);
+
+  for (int k = 0; k < 300; ++k) {
+    RunFrames(*heavy, 0.7f, 1);
+    RunFrames(light, 0.4f, 1);
+  }
+  EXPECT_GT(budget->TotalLoad(), 1.0f);
+  EXPECT_EQ(heavy->tier(), Aec3ComputeTier::kReducedDelayEstimation);
+  EXPECT_EQ(light.tier(), Aec3ComputeTier::kFull);
+
+  heavy.reset();
+  EXPECT_EQ(budget->NumUsers(), 1);
+  EXPECT_NEAR(budget->TotalLoad(), light.load(), 1e-5f);
+}
+
+}  // namespace webrtc
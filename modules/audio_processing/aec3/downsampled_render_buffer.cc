@@ -16,10 +16,14 @@ namespace webrtc {
 
 DownsampledRenderBuffer::DownsampledRenderBuffer(size_t downsampled_buffer_size)
     : size(static_cast<int>(downsampled_buffer_size)),
-      buffer(downsampled_buffer_size, 0.f) {
+      buffer(storage_),
+      storage_(downsampled_buffer_size, 0.f) {
   std::fill(buffer.begin(), buffer.end(), 0.f);
 }
 
+DownsampledRenderBuffer::DownsampledRenderBuffer(DownsampledRenderBuffer* other)
+    : size(other->size), buffer(other->buffer) {}
+
 DownsampledRenderBuffer::~DownsampledRenderBuffer() = default;
 
 }  // namespace webrtc
@@ -22,6 +22,11 @@ namespace webrtc {
 // Holds the circular buffer of the downsampled render data.
 struct DownsampledRenderBuffer {
   explicit DownsampledRenderBuffer(size_t downsampled_buffer_size);
+  // Creates a buffer with its own read and write indices that shares the
+  // stored samples with `other`, which must outlive the created buffer.
+  explicit DownsampledRenderBuffer(DownsampledRenderBuffer* other);
+  DownsampledRenderBuffer(const DownsampledRenderBuffer&) = delete;
+  DownsampledRenderBuffer& operator=(const DownsampledRenderBuffer&) = delete;
   ~DownsampledRenderBuffer();
 
   int IncIndex(int index) const {
@@ -48,9 +53,13 @@ struct DownsampledRenderBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<float> buffer;
+  std::vector<float>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  // Holds the samples unless they are shared with another buffer.
+  std::vector<float> storage_;
 };
 
 }  // namespace webrtc
@@ -14,10 +14,13 @@
 
 #include "absl/strings/string_view.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/fft_data_array.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 #include "modules/audio_processing/high_pass_filter.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
@@ -26,6 +29,10 @@ namespace {
 
 enum class EchoCanceller3ApiCall { kCapture, kRender };
 
+constexpr int64_t kFrameDurationNs = rtc::kNumNanosecsPerSec / 100;
+constexpr int64_t kBlockDurationNs =
+    rtc::kNumNanosecsPerSec / kNumBlocksPerSecond;
+
 bool DetectSaturation(rtc::ArrayView<const float> y) {
   for (size_t k = 0; k < y.size(); ++k) {
     if (y[k] >= 32700.0f || y[k] <= -32700.0f) {
@@ -35,6 +42,25 @@ bool DetectSaturation(rtc::ArrayView<const float> y) {
   return false;
 }
 
+// Returns the size of the arrays that an echo canceller with the specified
+// setup allocates from its arena: the partitions of the refined and coarse
+// filters and, unless they are shared, the render FFTs.
+size_t ArenaSizeBytes(const EchoCanceller3Config& config,
+                      size_t num_render_channels,
+                      size_t num_capture_channels,
+                      bool include_render_buffers) {
+  size_t num_ffts = num_capture_channels * num_render_channels *
+                    (config.filter.refined.length_blocks +
+                     config.filter.coarse.length_blocks);
+  if (include_render_buffers) {
+    num_ffts += num_render_channels *
+                GetRenderDelayBufferSize(config.delay.down_sampling_factor,
+                                         config.delay.num_filters,
+                                         config.filter.refined.length_blocks);
+  }
+  return num_ffts * sizeof(AlignedFftData);
+}
+
 // Retrieves a value from a field trial if it is available. If no value is
 // present, the default value is returned. If the retrieved value is beyond the
 // specified limits, the default value is returned instead.
@@ -95,15 +121,35 @@ void FillSubFrameView(
   }
 }
 
+// Averages the channels returned by `get_channel` into `downmix`, which holds
+// the content of channel 0.
+template <typename GetChannel>
+void DownmixByAveraging(size_t num_channels,
+                        const GetChannel& get_channel,
+                        rtc::ArrayView<float> downmix) {
+  for (size_t ch = 1; ch < num_channels; ++ch) {
+    rtc::ArrayView<const float> channel = get_channel(ch);
+    RTC_DCHECK_EQ(downmix.size(), channel.size());
+    for (size_t k = 0; k < downmix.size(); ++k) {
+      downmix[k] += channel[k];
+    }
+  }
+  const float one_by_num_channels = 1.0f / num_channels;
+  for (size_t k = 0; k < downmix.size(); ++k) {
+    downmix[k] *= one_by_num_channels;
+  }
+}
+
 void FillSubFrameView(
     bool proper_downmix_needed,
-    std::vector<std::vector<std::vector<float>>>* frame,
+    const RenderFrameView& frame,
     size_t sub_frame_index,
     std::vector<std::vector<rtc::ArrayView<float>>>* sub_frame_view) {
   RTC_DCHECK_GE(1, sub_frame_index);
-  RTC_DCHECK_EQ(frame->size(), sub_frame_view->size());
-  const size_t frame_num_channels = (*frame)[0].size();
+  RTC_DCHECK_EQ(frame.NumBands(), sub_frame_view->size());
+  const size_t frame_num_channels = frame.NumChannels();
   const size_t sub_frame_num_channels = (*sub_frame_view)[0].size();
+  const size_t offset = sub_frame_index * kSubFrameLength;
   if (frame_num_channels > sub_frame_num_channels) {
     RTC_DCHECK_EQ(sub_frame_num_channels, 1u);
     if (proper_downmix_needed) {
@@ -111,33 +157,26 @@ void FillSubFrameView(
       // is present in the echo reference signal but the echo canceller does the
       // processing in mono) downmix the echo reference by averaging the channel
       // content (otherwise downmixing is done by selecting channel 0).
-      for (size_t band = 0; band < frame->size(); ++band) {
-        for (size_t ch = 1; ch < frame_num_channels; ++ch) {
-          for (size_t k = 0; k < kSubFrameLength; ++k) {
-            (*frame)[band][/*channel=*/0]
-                    [sub_frame_index * kSubFrameLength + k] +=
-                (*frame)[band][ch][sub_frame_index * kSubFrameLength + k];
-          }
-        }
-        const float one_by_num_channels = 1.0f / frame_num_channels;
-        for (size_t k = 0; k < kSubFrameLength; ++k) {
-          (*frame)[band][/*channel=*/0][sub_frame_index * kSubFrameLength +
-                                        k] *= one_by_num_channels;
-        }
+      for (int band = 0; band < frame.NumBands(); ++band) {
+        DownmixByAveraging(
+            frame_num_channels,
+            [&frame, band, offset](size_t ch) {
+              return rtc::ArrayView<const float>(
+                  frame.View(band, ch).subview(offset, kSubFrameLength));
+            },
+            frame.View(band, /*channel=*/0).subview(offset, kSubFrameLength));
       }
     }
-    for (size_t band = 0; band < frame->size(); ++band) {
+    for (int band = 0; band < frame.NumBands(); ++band) {
       (*sub_frame_view)[band][/*channel=*/0] = rtc::ArrayView<float>(
-          &(*frame)[band][/*channel=*/0][sub_frame_index * kSubFrameLength],
-          kSubFrameLength);
+          &frame.View(band, /*channel=*/0)[offset], kSubFrameLength);
     }
   } else {
     RTC_DCHECK_EQ(frame_num_channels, sub_frame_num_channels);
-    for (size_t band = 0; band < frame->size(); ++band) {
-      for (size_t channel = 0; channel < (*frame)[band].size(); ++channel) {
+    for (int band = 0; band < frame.NumBands(); ++band) {
+      for (int channel = 0; channel < frame.NumChannels(); ++channel) {
         (*sub_frame_view)[band][channel] = rtc::ArrayView<float>(
-            &(*frame)[band][channel][sub_frame_index * kSubFrameLength],
-            kSubFrameLength);
+            &frame.View(band, channel)[offset], kSubFrameLength);
       }
     }
   }
@@ -213,7 +252,7 @@ void ProcessRemainingCaptureFrameContent(bool level_change,
 
 void BufferRenderFrameContent(
     bool proper_downmix_needed,
-    std::vector<std::vector<std::vector<float>>>* render_frame,
+    const RenderFrameView& render_frame,
     size_t sub_frame_index,
     FrameBlocker* render_blocker,
     BlockProcessor* block_processor,
@@ -238,17 +277,17 @@ void BufferRemainingRenderFrameContent(FrameBlocker* render_blocker,
 void CopyBufferIntoFrame(const AudioBuffer& buffer,
                          size_t num_bands,
                          size_t num_channels,
-                         std::vector<std::vector<std::vector<float>>>* frame) {
-  RTC_DCHECK_EQ(num_bands, frame->size());
-  RTC_DCHECK_EQ(num_channels, (*frame)[0].size());
-  RTC_DCHECK_EQ(AudioBuffer::kSplitBandSize, (*frame)[0][0].size());
+                         const RenderFrameView& frame) {
+  RTC_DCHECK_EQ(num_bands, frame.NumBands());
+  RTC_DCHECK_EQ(num_channels, frame.NumChannels());
+  RTC_DCHECK_EQ(AudioBuffer::kSplitBandSize, frame.FrameLength());
   for (size_t band = 0; band < num_bands; ++band) {
     for (size_t channel = 0; channel < num_channels; ++channel) {
       rtc::ArrayView<const float> buffer_view(
           &buffer.split_bands_const(channel)[band][0],
           AudioBuffer::kSplitBandSize);
       std::copy(buffer_view.begin(), buffer_view.end(),
-                (*frame)[band][channel].begin());
+                frame.View(band, channel).begin());
     }
   }
 }
@@ -648,8 +687,7 @@ class EchoCanceller3::RenderWriter {
  public:
   RenderWriter(ApmDataDumper* data_dumper,
                const EchoCanceller3Config& config,
-               SwapQueue<std::vector<std::vector<std::vector<float>>>,
-                         Aec3RenderQueueItemVerifier>* render_transfer_queue,
+               RenderTransferQueue* render_transfer_queue,
                size_t num_bands,
                size_t num_channels);
 
@@ -665,26 +703,18 @@ class EchoCanceller3::RenderWriter {
   const size_t num_bands_;
   const size_t num_channels_;
   std::unique_ptr<HighPassFilter> high_pass_filter_;
-  std::vector<std::vector<std::vector<float>>> render_queue_input_frame_;
-  SwapQueue<std::vector<std::vector<std::vector<float>>>,
-            Aec3RenderQueueItemVerifier>* render_transfer_queue_;
+  RenderTransferQueue* render_transfer_queue_;
 };
 
 EchoCanceller3::RenderWriter::RenderWriter(
     ApmDataDumper* data_dumper,
     const EchoCanceller3Config& config,
-    SwapQueue<std::vector<std::vector<std::vector<float>>>,
-              Aec3RenderQueueItemVerifier>* render_transfer_queue,
+    RenderTransferQueue* render_transfer_queue,
     size_t num_bands,
     size_t num_channels)
     : data_dumper_(data_dumper),
       num_bands_(num_bands),
       num_channels_(num_channels),
-      render_queue_input_frame_(
-          num_bands_,
-          std::vector<std::vector<float>>(
-              num_channels_,
-              std::vector<float>(AudioBuffer::kSplitBandSize, 0.f))),
       render_transfer_queue_(render_transfer_queue) {
   RTC_DCHECK(data_dumper);
   if (config.filter.high_pass_filter_echo_reference) {
@@ -706,13 +736,15 @@ void EchoCanceller3::RenderWriter::Insert(const AudioBuffer& input) {
   data_dumper_->DumpWav("aec3_render_input", AudioBuffer::kSplitBandSize,
                         &input.split_bands_const(0)[0][0], 16000, 1);
 
-  CopyBufferIntoFrame(input, num_bands_, num_channels_,
-                      &render_queue_input_frame_);
+  const RenderFrameView frame = render_transfer_queue_->InsertionFrame();
+  CopyBufferIntoFrame(input, num_bands_, num_channels_, frame);
   if (high_pass_filter_) {
-    high_pass_filter_->Process(&render_queue_input_frame_[0]);
+    for (size_t channel = 0; channel < num_channels_; ++channel) {
+      high_pass_filter_->Process(channel, frame.View(/*band=*/0, channel));
+    }
   }
 
-  static_cast<void>(render_transfer_queue_->Insert(&render_queue_input_frame_));
+  static_cast<void>(render_transfer_queue_->Insert());
 }
 
 std::atomic<int> EchoCanceller3::instance_count_(0);
@@ -723,6 +755,20 @@ EchoCanceller3::EchoCanceller3(
     int sample_rate_hz,
     size_t num_render_channels,
     size_t num_capture_channels)
+    : EchoCanceller3(config,
+                     multichannel_config,
+                     sample_rate_hz,
+                     num_render_channels,
+                     num_capture_channels,
+                     /*render_pipeline=*/nullptr) {}
+
+EchoCanceller3::EchoCanceller3(
+    const EchoCanceller3Config& config,
+    const absl::optional<EchoCanceller3Config>& multichannel_config,
+    int sample_rate_hz,
+    size_t num_render_channels,
+    size_t num_capture_channels,
+    rtc::scoped_refptr<SharedRenderPipeline> render_pipeline)
     : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
       config_(AdjustConfig(config)),
       sample_rate_hz_(sample_rate_hz),
@@ -743,21 +789,12 @@ EchoCanceller3::EchoCanceller3(
               .multi_channel.stereo_detection_hysteresis_seconds),
       output_framer_(num_bands_, num_capture_channels_),
       capture_blocker_(num_bands_, num_capture_channels_),
-      render_transfer_queue_(
-          kRenderTransferQueueSizeFrames,
-          std::vector<std::vector<std::vector<float>>>(
-              num_bands_,
-              std::vector<std::vector<float>>(
-                  num_render_input_channels_,
-                  std::vector<float>(AudioBuffer::kSplitBandSize, 0.f))),
-          Aec3RenderQueueItemVerifier(num_bands_,
-                                      num_render_input_channels_,
-                                      AudioBuffer::kSplitBandSize)),
-      render_queue_output_frame_(
-          num_bands_,
-          std::vector<std::vector<float>>(
-              num_render_input_channels_,
-              std::vector<float>(AudioBuffer::kSplitBandSize, 0.f))),
+      render_transfer_queue_(kRenderTransferQueueSizeFrames,
+                             num_bands_,
+                             num_render_input_channels_,
+                             AudioBuffer::kSplitBandSize),
+      render_pipeline_(std::move(render_pipeline)),
+      use_arena_(!field_trial::IsEnabled("WebRTC-Aec3ArenaKillSwitch")),
       render_block_(num_bands_, num_render_input_channels_),
       capture_block_(num_bands_, num_capture_channels_),
       capture_sub_frame_view_(
@@ -775,6 +812,12 @@ EchoCanceller3::EchoCanceller3(
       data_dumper_.get(), config_selector_.active_config(),
       &render_transfer_queue_, num_bands_, num_render_input_channels_));
 
+  if (config_selector_.active_config()
+          .filter.high_pass_filter_echo_reference) {
+    render_block_high_pass_filter_ =
+        std::make_unique<HighPassFilter>(16000, num_render_input_channels_);
+  }
+
   RTC_DCHECK_EQ(num_bands_, std::max(sample_rate_hz_, 16000) / 16000);
   RTC_DCHECK_GE(kMaxNumBands, num_bands_);
 
@@ -813,9 +856,38 @@ void EchoCanceller3::Initialize() {
   render_blocker_.reset(
       new FrameBlocker(num_bands_, num_render_channels_to_aec_));
 
-  block_processor_.reset(BlockProcessor::Create(
-      config_selector_.active_config(), sample_rate_hz_,
-      num_render_channels_to_aec_, num_capture_channels_));
+  const bool use_render_pipeline =
+      render_pipeline_ &&
+      render_pipeline_->IsCompatible(config_selector_.active_config(),
+                                     sample_rate_hz_,
+                                     num_render_channels_to_aec_);
+  if (render_pipeline_ && !use_render_pipeline) {
+    RTC_LOG(LS_WARNING) << "AEC3 shared render pipeline not compatible with "
+                           "the active setup, using a private pipeline.";
+  }
+
+  // The block processor must release its arena allocations before the arena
+  // is reset.
+  block_processor_.reset();
+  if (use_arena_) {
+    arena_.Reset(ArenaSizeBytes(
+        config_selector_.active_config(), num_render_channels_to_aec_,
+        num_capture_channels_,
+        /*include_render_buffers=*/!use_render_pipeline));
+  }
+  ScopedAec3ArenaBinding arena_binding(use_arena_ ? &arena_ : nullptr);
+  if (use_render_pipeline) {
+    block_processor_.reset(BlockProcessor::Create(
+        config_selector_.active_config(), sample_rate_hz_,
+        num_render_channels_to_aec_, num_capture_channels_, render_pipeline_));
+  } else {
+    block_processor_.reset(BlockProcessor::Create(
+        config_selector_.active_config(), sample_rate_hz_,
+        num_render_channels_to_aec_, num_capture_channels_));
+  }
+  if (compute_controller_) {
+    block_processor_->SetComputeTier(compute_controller_->tier());
+  }
 
   render_sub_frame_view_ = std::vector<std::vector<rtc::ArrayView<float>>>(
       num_bands_,
@@ -861,6 +933,8 @@ void EchoCanceller3::ProcessCapture(AudioBuffer* capture,
   RTC_DCHECK_EQ(capture->num_channels(), num_capture_channels_);
   data_dumper_->DumpRaw("aec3_call_order",
                         static_cast<int>(EchoCanceller3ApiCall::kCapture));
+  ScopedStageProfilerBinding stage_profiler_binding(&stage_profiler_);
+  const int64_t start_ns = compute_controller_ ? rtc::TimeNanos() : 0;
 
   if (linear_output && !linear_output_framer_) {
     RTC_LOG(LS_ERROR) << "Trying to retrieve the linear AEC output without "
@@ -910,6 +984,81 @@ void EchoCanceller3::ProcessCapture(AudioBuffer* capture,
 
   data_dumper_->DumpWav("aec3_capture_output", AudioBuffer::kSplitBandSize,
                         &capture->split_bands(0)[0][0], 16000, 1);
+
+  UpdateComputeTier(start_ns, kFrameDurationNs);
+}
+
+void EchoCanceller3::AnalyzeRenderBlock(Block* render) {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  RTC_DCHECK(render);
+  RTC_DCHECK_EQ(num_bands_, render->NumBands());
+  RTC_DCHECK_EQ(num_render_input_channels_, render->NumChannels());
+  data_dumper_->DumpRaw("aec3_call_order",
+                        static_cast<int>(EchoCanceller3ApiCall::kRender));
+
+  if (render_block_high_pass_filter_) {
+    for (int channel = 0; channel < render->NumChannels(); ++channel) {
+      render_block_high_pass_filter_->Process(
+          channel, render->View(/*band=*/0, channel));
+    }
+  }
+
+  multichannel_content_detector_.UpdateDetection(*render);
+
+  const size_t num_channels = render->NumChannels();
+  if (num_channels == num_render_channels_to_aec_) {
+    block_processor_->BufferRender(*render);
+    return;
+  }
+
+  // As for the 10 ms API, the channels are only averaged when a proper
+  // downmix is needed and channel 0 is used otherwise.
+  RTC_DCHECK_EQ(render_block_.NumChannels(), 1);
+  for (int band = 0; band < num_bands_; ++band) {
+    rtc::ArrayView<float, kBlockSize> downmix =
+        render_block_.View(band, /*channel=*/0);
+    std::copy(render->begin(band, 0), render->end(band, 0), downmix.begin());
+    if (multichannel_content_detector_
+            .IsTemporaryMultiChannelContentDetected()) {
+      DownmixByAveraging(
+          num_channels,
+          [render, band](size_t ch) {
+            return rtc::ArrayView<const float>(render->View(band, ch));
+          },
+          downmix);
+    }
+  }
+  block_processor_->BufferRender(render_block_);
+}
+
+void EchoCanceller3::ProcessCaptureBlock(bool level_change,
+                                         bool saturated_microphone_signal,
+                                         Block* linear_output,
+                                         Block* capture) {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  RTC_DCHECK(capture);
+  RTC_DCHECK_EQ(num_bands_, capture->NumBands());
+  RTC_DCHECK_EQ(num_capture_channels_, capture->NumChannels());
+  data_dumper_->DumpRaw("aec3_call_order",
+                        static_cast<int>(EchoCanceller3ApiCall::kCapture));
+  ScopedStageProfilerBinding stage_profiler_binding(&stage_profiler_);
+  const int64_t start_ns = compute_controller_ ? rtc::TimeNanos() : 0;
+
+  if (linear_output && !linear_output_framer_) {
+    RTC_LOG(LS_ERROR) << "Trying to retrieve the linear AEC output without "
+                         "properly configuring AEC3.";
+    RTC_DCHECK_NOTREACHED();
+  }
+
+  EmptyRenderQueue();
+
+  block_processor_->ProcessCapture(
+      /*echo_path_gain_change=*/level_change ||
+          multichannel_content_detector_
+              .IsTemporaryMultiChannelContentDetected(),
+      saturated_microphone_signal, linear_output, capture);
+
+  UpdateComputeTier(start_ns, kBlockDurationNs);
 }
 
 EchoControl::Metrics EchoCanceller3::GetMetrics() const {
@@ -919,11 +1068,79 @@ EchoControl::Metrics EchoCanceller3::GetMetrics() const {
   return metrics;
 }
 
+Aec3ArenaStats EchoCanceller3::GetArenaStats() const {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  return arena_.GetStats();
+}
+
+std::vector<uint8_t> EchoCanceller3::GetWarmStartState() const {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  Aec3WarmStartState state;
+  block_processor_->SaveWarmStartState(&state);
+  return SerializeAec3WarmStartState(state);
+}
+
+bool EchoCanceller3::SetWarmStartState(rtc::ArrayView<const uint8_t> state) {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  Aec3WarmStartState warm_start_state;
+  if (!DeserializeAec3WarmStartState(state, &warm_start_state)) {
+    RTC_LOG(LS_WARNING) << "Malformed AEC3 warm start state.";
+    return false;
+  }
+
+  const EchoCanceller3Config::Filter& filter =
+      config_selector_.active_config().filter;
+  const size_t partition_size =
+      Aec3WarmStartState::kPartitionSize * num_render_channels_to_aec_;
+  const size_t max_refined_size =
+      partition_size * std::max(filter.refined.length_blocks,
+                                filter.refined_initial.length_blocks);
+  const size_t max_coarse_size =
+      partition_size * std::max(filter.coarse.length_blocks,
+                                filter.coarse_initial.length_blocks);
+  auto valid_filter_size = [&](size_t size, size_t max_size) {
+    return size > 0 && size % partition_size == 0 && size <= max_size;
+  };
+
+  bool compatible =
+      warm_start_state.num_render_channels == num_render_channels_to_aec_ &&
+      warm_start_state.capture_channels.size() == num_capture_channels_;
+  for (const auto& channel : warm_start_state.capture_channels) {
+    compatible = compatible &&
+                 valid_filter_size(channel.refined_filter.size(),
+                                   max_refined_size) &&
+                 valid_filter_size(channel.coarse_filter.size(),
+                                   max_coarse_size);
+  }
+  if (!compatible) {
+    RTC_LOG(LS_WARNING) << "AEC3 warm start state does not match the setup.";
+    return false;
+  }
+
+  block_processor_->RestoreWarmStartState(warm_start_state);
+  return true;
+}
+
 void EchoCanceller3::SetAudioBufferDelay(int delay_ms) {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
   block_processor_->SetAudioBufferDelay(delay_ms);
 }
 
+void EchoCanceller3::EnableComputeScaling(
+    float max_load,
+    rtc::scoped_refptr<Aec3ComputeBudget> shared_budget) {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  compute_controller_ = std::make_unique<Aec3ComputeController>(
+      max_load, std::move(shared_budget));
+  block_processor_->SetComputeTier(compute_controller_->tier());
+}
+
+Aec3ComputeTier EchoCanceller3::GetComputeTier() const {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  return compute_controller_ ? compute_controller_->tier()
+                             : Aec3ComputeTier::kFull;
+}
+
 void EchoCanceller3::SetCaptureOutputUsage(bool capture_output_used) {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
   block_processor_->SetCaptureOutputUsage(capture_output_used);
@@ -955,16 +1172,31 @@ void EchoCanceller3::SetBlockProcessorForTesting(
   block_processor_ = std::move(block_processor);
 }
 
+void EchoCanceller3::UpdateComputeTier(int64_t start_ns,
+                                       int64_t audio_duration_ns) {
+  if (!compute_controller_) {
+    return;
+  }
+  if (compute_controller_->Update(rtc::TimeNanos() - start_ns,
+                                  audio_duration_ns)) {
+    block_processor_->SetComputeTier(compute_controller_->tier());
+    RTC_LOG(LS_INFO) << "AEC3 compute tier changed to "
+                     << static_cast<int>(compute_controller_->tier())
+                     << " at load " << compute_controller_->load() << ".";
+  }
+  data_dumper_->DumpRaw("aec3_compute_tier",
+                        static_cast<int>(compute_controller_->tier()));
+}
+
 void EchoCanceller3::EmptyRenderQueue() {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
-  bool frame_to_buffer =
-      render_transfer_queue_.Remove(&render_queue_output_frame_);
-  while (frame_to_buffer) {
+  while (render_transfer_queue_.HasFrame()) {
+    const RenderFrameView render_frame = render_transfer_queue_.RemovalFrame();
+
     // Report render call in the metrics.
     api_call_metrics_.ReportRenderCall();
 
-    if (multichannel_content_detector_.UpdateDetection(
-            render_queue_output_frame_)) {
+    if (multichannel_content_detector_.UpdateDetection(render_frame)) {
       // Reinitialize the AEC when proper stereo is detected.
       //Initialize();
     }
@@ -973,20 +1205,19 @@ void EchoCanceller3::EmptyRenderQueue() {
     BufferRenderFrameContent(
         /*proper_downmix_needed=*/multichannel_content_detector_
             .IsTemporaryMultiChannelContentDetected(),
-        &render_queue_output_frame_, 0, render_blocker_.get(),
+        render_frame, 0, render_blocker_.get(),
         block_processor_.get(), &render_block_, &render_sub_frame_view_);
 
     BufferRenderFrameContent(
         /*proper_downmix_needed=*/multichannel_content_detector_
             .IsTemporaryMultiChannelContentDetected(),
-        &render_queue_output_frame_, 1, render_blocker_.get(),
+        render_frame, 1, render_blocker_.get(),
         block_processor_.get(), &render_block_, &render_sub_frame_view_);
 
     BufferRemainingRenderFrameContent(render_blocker_.get(),
                                       block_processor_.get(), &render_block_);
 
-    frame_to_buffer =
-        render_transfer_queue_.Remove(&render_queue_output_frame_);
+    render_transfer_queue_.Remove();
   }
 }
 }  // namespace webrtc
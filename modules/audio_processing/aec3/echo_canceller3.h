@@ -12,6 +12,7 @@
 #define MODULES_AUDIO_PROCESSING_AEC3_ECHO_CANCELLER3_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <atomic>
 #include <memory>
@@ -21,18 +22,24 @@
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "api/audio/echo_control.h"
+#include "api/scoped_refptr.h"
+#include "modules/audio_processing/aec3/aec3_arena.h"
 #include "modules/audio_processing/aec3/api_call_jitter_metrics.h"
 #include "modules/audio_processing/aec3/block_delay_buffer.h"
 #include "modules/audio_processing/aec3/block_framer.h"
 #include "modules/audio_processing/aec3/block_processor.h"
+#include "modules/audio_processing/aec3/compute_controller.h"
 #include "modules/audio_processing/aec3/config_selector.h"
 #include "modules/audio_processing/aec3/frame_blocker.h"
 #include "modules/audio_processing/aec3/multi_channel_content_detector.h"
+#include "modules/audio_processing/aec3/render_transfer_queue.h"
+#include "modules/audio_processing/aec3/shared_render_pipeline.h"
+#include "modules/audio_processing/aec3/stage_profiler.h"
 #include "modules/audio_processing/audio_buffer.h"
+#include "modules/audio_processing/high_pass_filter.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/race_checker.h"
-#include "rtc_base/swap_queue.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -42,40 +49,6 @@ namespace webrtc {
 // TODO(webrtc:5298): Move this to a separate file.
 EchoCanceller3Config AdjustConfig(const EchoCanceller3Config& config);
 
-// Functor for verifying the invariance of the frames being put into the render
-// queue.
-class Aec3RenderQueueItemVerifier {
- public:
-  Aec3RenderQueueItemVerifier(size_t num_bands,
-                              size_t num_channels,
-                              size_t frame_length)
-      : num_bands_(num_bands),
-        num_channels_(num_channels),
-        frame_length_(frame_length) {}
-
-  bool operator()(const std::vector<std::vector<std::vector<float>>>& v) const {
-    if (v.size() != num_bands_) {
-      return false;
-    }
-    for (const auto& band : v) {
-      if (band.size() != num_channels_) {
-        return false;
-      }
-      for (const auto& channel : band) {
-        if (channel.size() != frame_length_) {
-          return false;
-        }
-      }
-    }
-    return true;
-  }
-
- private:
-  const size_t num_bands_;
-  const size_t num_channels_;
-  const size_t frame_length_;
-};
-
 // Main class for the echo canceller3.
 // It does 4 things:
 // -Receives 10 ms frames of band-split audio.
@@ -94,6 +67,18 @@ class EchoCanceller3 : public EchoControl {
       int sample_rate_hz,
       size_t num_render_channels,
       size_t num_capture_channels);
+  // Creates an echo canceller that shares the render analysis of
+  // `render_pipeline` with the other echo cancellers that cancel the echo of
+  // the same render signal. The pipeline is only used while it is compatible
+  // with the active configuration, and the render signal must be analyzed by
+  // all the sharing echo cancellers.
+  EchoCanceller3(
+      const EchoCanceller3Config& config,
+      const absl::optional<EchoCanceller3Config>& multichannel_config,
+      int sample_rate_hz,
+      size_t num_render_channels,
+      size_t num_capture_channels,
+      rtc::scoped_refptr<SharedRenderPipeline> render_pipeline);
 
   ~EchoCanceller3() override;
 
@@ -114,11 +99,56 @@ class EchoCanceller3 : public EchoControl {
   void ProcessCapture(AudioBuffer* capture,
                       AudioBuffer* linear_output,
                       bool level_change) override;
+  // Block-level API, for callers that already produce split-band audio in
+  // blocks of kBlockSize samples (see BlockStreamAdapter for arbitrary chunk
+  // lengths). The blocks are passed to the block processor without the 10 ms
+  // framing. Unlike AnalyzeRender, AnalyzeRenderBlock buffers the render
+  // block directly and must therefore be called on the capture thread, in
+  // between the ProcessCaptureBlock calls. The echo reference high-pass
+  // filter, if enabled, is applied to `render` in place. As for the 10 ms API,
+  // the render blocks drive the multichannel content detection and are
+  // downmixed when fewer channels than the render channels are processed.
+  void AnalyzeRenderBlock(Block* render);
+  // Removes the echo from the `capture` block in place and, if
+  // `linear_output` is non-null, returns the linear filter output in it.
+  // Render frames passed to AnalyzeRender are buffered before the block is
+  // processed. The fixed capture delay is not applied.
+  void ProcessCaptureBlock(bool level_change,
+                           bool saturated_microphone_signal,
+                           Block* linear_output,
+                           Block* capture);
   // Collect current metrics from the echo canceller.
   Metrics GetMetrics() const override;
+  // Returns the execution time statistics of the capture processing stages.
+  // The statistics are only collected when the code is built with
+  // WEBRTC_AEC3_STAGE_PROFILING set to 1. May be called from any thread.
+  Aec3StageStats GetStageStats() const { return stage_profiler_.GetStats(); }
+  // Returns the memory footprint of the arena that holds the filter and render
+  // FFT arrays. Must be called on the capture thread.
+  Aec3ArenaStats GetArenaStats() const;
+  // Returns the converged linear filters, delay and echo estimates in a
+  // serialized form that can be stored and passed to SetWarmStartState of a
+  // later echo canceller for the same device, to avoid the initial
+  // convergence. Must be called on the capture thread.
+  std::vector<uint8_t> GetWarmStartState() const;
+  // Restores a state returned by GetWarmStartState. Returns false, and leaves
+  // the echo canceller unchanged, if the state is malformed or was saved by an
+  // echo canceller with a different number of channels or filter lengths.
+  // Must be called on the capture thread.
+  bool SetWarmStartState(rtc::ArrayView<const uint8_t> state);
   // Provides an optional external estimate of the audio buffer delay.
   void SetAudioBufferDelay(int delay_ms) override;
 
+  // Enables the scaling of the computational complexity for keeping the
+  // capture processing within `max_load`, the fraction of real time that it
+  // may use, and within `shared_budget` if non-null. A `max_load` of zero only
+  // applies the shared budget. Must be called on the capture thread.
+  void EnableComputeScaling(
+      float max_load,
+      rtc::scoped_refptr<Aec3ComputeBudget> shared_budget);
+  // Returns the compute tier in use. Must be called on the capture thread.
+  Aec3ComputeTier GetComputeTier() const;
+
   // Specifies whether the capture output will be used. The purpose of this is
   // to allow the echo controller to deactivate some of the processing when the
   // resulting output is anyway not used, for instance when the endpoint is
@@ -148,6 +178,7 @@ class EchoCanceller3 : public EchoControl {
                            DetectionOfProperStereoUsingHysteresis);
   FRIEND_TEST_ALL_PREFIXES(EchoCanceller3,
                            StereoContentDetectionForMonoSignals);
+  FRIEND_TEST_ALL_PREFIXES(EchoCanceller3, BlockLevelApiDetectsProperStereo);
 
   class RenderWriter;
 
@@ -169,9 +200,14 @@ class EchoCanceller3 : public EchoControl {
     return config_selector_.active_config();
   }
 
-  // Empties the render SwapQueue.
+  // Empties the render transfer queue.
   void EmptyRenderQueue();
 
+  // Reports the execution time of a capture processing call that started at
+  // `start_ns` to the compute controller, and applies any change of the
+  // compute tier.
+  void UpdateComputeTier(int64_t start_ns, int64_t audio_duration_ns);
+
   // Analyzes and stores an internal copy of the split-band domain render
   // signal.
   void AnalyzeRender(const AudioBuffer& render);
@@ -202,16 +238,18 @@ class EchoCanceller3 : public EchoControl {
   FrameBlocker capture_blocker_ RTC_GUARDED_BY(capture_race_checker_);
   std::unique_ptr<FrameBlocker> render_blocker_
       RTC_GUARDED_BY(capture_race_checker_);
-  SwapQueue<std::vector<std::vector<std::vector<float>>>,
-            Aec3RenderQueueItemVerifier>
-      render_transfer_queue_;
+  RenderTransferQueue render_transfer_queue_;
+  const rtc::scoped_refptr<SharedRenderPipeline> render_pipeline_;
+  const bool use_arena_;
+  Aec3Arena arena_ RTC_GUARDED_BY(capture_race_checker_);
+  Aec3StageProfiler stage_profiler_;
   std::unique_ptr<BlockProcessor> block_processor_
       RTC_GUARDED_BY(capture_race_checker_);
-  std::vector<std::vector<std::vector<float>>> render_queue_output_frame_
-      RTC_GUARDED_BY(capture_race_checker_);
   bool saturated_microphone_signal_ RTC_GUARDED_BY(capture_race_checker_) =
       false;
   Block render_block_ RTC_GUARDED_BY(capture_race_checker_);
+  std::unique_ptr<HighPassFilter> render_block_high_pass_filter_
+      RTC_GUARDED_BY(capture_race_checker_);
   std::unique_ptr<Block> linear_output_block_
       RTC_GUARDED_BY(capture_race_checker_);
   Block capture_block_ RTC_GUARDED_BY(capture_race_checker_);
@@ -224,6 +262,8 @@ class EchoCanceller3 : public EchoControl {
   std::unique_ptr<BlockDelayBuffer> block_delay_buffer_
       RTC_GUARDED_BY(capture_race_checker_);
   ApiCallJitterMetrics api_call_metrics_ RTC_GUARDED_BY(capture_race_checker_);
+  std::unique_ptr<Aec3ComputeController> compute_controller_
+      RTC_GUARDED_BY(capture_race_checker_);
 };
 }  // namespace webrtc
 
@@ -0,0 +1,416 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/echo_canceller3_engine.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#elif defined(WEBRTC_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <deque>
+#include <string>
+
+#include "absl/types/optional.h"
+#include "api/units/time_delta.h"
+#include "modules/audio_processing/aec3/echo_canceller3.h"
+#include "modules/audio_processing/audio_buffer.h"
+#include "modules/audio_processing/high_pass_filter.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+
+namespace {
+
+void PinCurrentThreadToCore(int core) {
+#if defined(WEBRTC_WIN)
+  if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << core) == 0) {
+    RTC_LOG(LS_WARNING) << "Failed to pin worker to core " << core;
+  }
+#elif defined(WEBRTC_LINUX)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core, &cpu_set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+    RTC_LOG(LS_WARNING) << "Failed to pin worker to core " << core;
+  }
+#else
+  RTC_LOG(LS_WARNING) << "Pinning workers to cores is not supported";
+#endif
+}
+
+}  // namespace
+
+// Holds the echo canceller of a session together with a queue of frames to
+// process. The queue is a ring of preallocated frames; the frame at the front
+// is only accessed by the worker that processes the session, which allows the
+// processing to run without holding the lock.
+class EchoCanceller3Engine::Session {
+ public:
+  Session(const EchoCanceller3Config& config,
+          int sample_rate_hz,
+          size_t num_render_channels,
+          size_t num_capture_channels,
+          size_t max_queued_frames,
+          size_t home_worker)
+      : home_worker(home_worker),
+        render_config_(sample_rate_hz, num_render_channels),
+        capture_config_(sample_rate_hz, num_capture_channels),
+        frames_(max_queued_frames),
+        echo_canceller_(config,
+                        /*multichannel_config=*/absl::nullopt,
+                        sample_rate_hz,
+                        num_render_channels,
+                        num_capture_channels),
+        high_pass_filter_(sample_rate_hz, num_capture_channels),
+        render_buffer_(sample_rate_hz,
+                       num_render_channels,
+                       sample_rate_hz,
+                       num_render_channels,
+                       sample_rate_hz,
+                       num_render_channels),
+        capture_buffer_(sample_rate_hz,
+                        num_capture_channels,
+                        sample_rate_hz,
+                        num_capture_channels,
+                        sample_rate_hz,
+                        num_capture_channels) {
+    RTC_DCHECK_LT(0, max_queued_frames);
+    for (auto& frame : frames_) {
+      frame.render.resize(render_config_.num_samples());
+      frame.capture.resize(capture_config_.num_samples());
+    }
+  }
+
+  Session(const Session&) = delete;
+  Session& operator=(const Session&) = delete;
+
+  // Copies a frame pair into the queue. Returns false if the queue is full.
+  // Sets `needs_scheduling` if the session is not already scheduled.
+  bool Push(rtc::ArrayView<const int16_t> render,
+            rtc::ArrayView<const int16_t> capture,
+            rtc::ArrayView<int16_t> output,
+            int64_t deadline_us,
+            bool* needs_scheduling) {
+    RTC_CHECK_EQ(render.size(), render_config_.num_samples());
+    RTC_CHECK_EQ(capture.size(), capture_config_.num_samples());
+    RTC_CHECK_EQ(output.size(), capture_config_.num_samples());
+    MutexLock lock(&mutex_);
+    *needs_scheduling = false;
+    if (num_queued_ == frames_.size()) {
+      ++stats_.frames_dropped;
+      return false;
+    }
+    Frame& frame = frames_[(read_index_ + num_queued_) % frames_.size()];
+    std::copy(render.begin(), render.end(), frame.render.begin());
+    std::copy(capture.begin(), capture.end(), frame.capture.begin());
+    frame.output = output.data();
+    frame.deadline_us = deadline_us;
+    ++num_queued_;
+    if (!scheduled_) {
+      scheduled_ = true;
+      *needs_scheduling = true;
+    }
+    return true;
+  }
+
+  // Processes queued frames until the queue is empty and returns the number
+  // of processed frames. Must only be called by the worker that has dequeued
+  // the session.
+  int ProcessQueuedFrames() {
+    int num_processed = 0;
+    Frame* frame;
+    {
+      MutexLock lock(&mutex_);
+      RTC_DCHECK(scheduled_);
+      RTC_DCHECK_LT(0, num_queued_);
+      frame = &frames_[read_index_];
+    }
+    while (true) {
+      ProcessFrame(*frame);
+      ++num_processed;
+      const int64_t lateness_us = rtc::TimeMicros() - frame->deadline_us;
+
+      MutexLock lock(&mutex_);
+      read_index_ = (read_index_ + 1) % frames_.size();
+      --num_queued_;
+      ++stats_.frames_processed;
+      stats_.last_lateness_us = lateness_us;
+      if (lateness_us > 0) {
+        ++stats_.frames_late;
+        stats_.max_lateness_us = std::max(stats_.max_lateness_us, lateness_us);
+        stats_.total_lateness_us += lateness_us;
+      }
+      if (num_queued_ == 0) {
+        scheduled_ = false;
+        // The session may be destroyed as soon as the lock is released, so
+        // the event needs to be set while holding it.
+        drained_.Set();
+        return num_processed;
+      }
+      frame = &frames_[read_index_];
+    }
+  }
+
+  // Blocks until no frames are queued for the session.
+  void WaitUntilDrained() {
+    while (true) {
+      {
+        MutexLock lock(&mutex_);
+        if (!scheduled_) {
+          return;
+        }
+      }
+      drained_.Wait(rtc::Event::kForever);
+    }
+  }
+
+  SessionStats stats() const {
+    MutexLock lock(&mutex_);
+    return stats_;
+  }
+
+  const size_t home_worker;
+
+ private:
+  struct Frame {
+    std::vector<int16_t> render;
+    std::vector<int16_t> capture;
+    int16_t* output = nullptr;
+    int64_t deadline_us = 0;
+  };
+
+  void ProcessFrame(const Frame& frame) {
+    // The band split is only needed (and only available) for rates above
+    // 16 kHz.
+    const bool multi_band = capture_buffer_.num_bands() > 1;
+
+    render_buffer_.CopyFrom(frame.render.data(), render_config_);
+    if (multi_band) {
+      render_buffer_.SplitIntoFrequencyBands();
+    }
+    echo_canceller_.AnalyzeRender(&render_buffer_);
+
+    capture_buffer_.CopyFrom(frame.capture.data(), capture_config_);
+    echo_canceller_.AnalyzeCapture(&capture_buffer_);
+    if (multi_band) {
+      capture_buffer_.SplitIntoFrequencyBands();
+    }
+    high_pass_filter_.Process(&capture_buffer_, /*use_split_band_data=*/true);
+    echo_canceller_.ProcessCapture(&capture_buffer_, /*level_change=*/false);
+    if (multi_band) {
+      capture_buffer_.MergeFrequencyBands();
+    }
+    capture_buffer_.CopyTo(capture_config_, frame.output);
+  }
+
+  const StreamConfig render_config_;
+  const StreamConfig capture_config_;
+
+  mutable Mutex mutex_;
+  std::vector<Frame> frames_;
+  size_t read_index_ RTC_GUARDED_BY(mutex_) = 0;
+  size_t num_queued_ RTC_GUARDED_BY(mutex_) = 0;
+  bool scheduled_ RTC_GUARDED_BY(mutex_) = false;
+  SessionStats stats_ RTC_GUARDED_BY(mutex_);
+  rtc::Event drained_;
+
+  // Processing state, only accessed by the worker processing the session.
+  EchoCanceller3 echo_canceller_;
+  HighPassFilter high_pass_filter_;
+  AudioBuffer render_buffer_;
+  AudioBuffer capture_buffer_;
+};
+
+struct EchoCanceller3Engine::Worker {
+  Mutex mutex;
+  std::deque<Session*> tasks RTC_GUARDED_BY(mutex);
+  rtc::Event wakeup;
+  std::atomic<bool> idle{false};
+  rtc::PlatformThread thread;
+};
+
+EchoCanceller3Engine::EchoCanceller3Engine(const Config& config)
+    : config_(config) {
+  const int num_cores = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  const size_t num_workers =
+      config_.num_workers > 0 ? config_.num_workers : num_cores;
+  workers_.reserve(num_workers);
+  for (size_t k = 0; k < num_workers; ++k) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (size_t k = 0; k < num_workers; ++k) {
+    const int core = (config_.first_core + static_cast<int>(k)) % num_cores;
+    workers_[k]->thread = rtc::PlatformThread::SpawnJoinable(
+        [this, k, core] {
+          if (config_.pin_workers) {
+            PinCurrentThreadToCore(core);
+          }
+          WorkerLoop(k);
+        },
+        "aec3_engine_" + std::to_string(k),
+        rtc::ThreadAttributes().SetPriority(rtc::ThreadPriority::kHigh));
+  }
+}
+
+EchoCanceller3Engine::~EchoCanceller3Engine() {
+  WaitUntilIdle();
+  quit_ = true;
+  for (auto& worker : workers_) {
+    worker->wakeup.Set();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.Finalize();
+  }
+}
+
+EchoCanceller3Engine::SessionId EchoCanceller3Engine::CreateSession(
+    int sample_rate_hz,
+    size_t num_render_channels,
+    size_t num_capture_channels) {
+  MutexLock lock(&sessions_mutex_);
+  SessionId id;
+  if (free_session_ids_.empty()) {
+    id = static_cast<SessionId>(sessions_.size());
+    sessions_.emplace_back();
+  } else {
+    id = free_session_ids_.back();
+    free_session_ids_.pop_back();
+  }
+  sessions_[id] = std::make_unique<Session>(
+      config_.aec3, sample_rate_hz, num_render_channels, num_capture_channels,
+      config_.max_queued_frames_per_session, id % workers_.size());
+  return id;
+}
+
+void EchoCanceller3Engine::DestroySession(SessionId id) {
+  std::unique_ptr<Session> session;
+  {
+    MutexLock lock(&sessions_mutex_);
+    RTC_CHECK_LT(id, sessions_.size());
+    RTC_CHECK(sessions_[id]);
+    session = std::move(sessions_[id]);
+    free_session_ids_.push_back(id);
+  }
+  session->WaitUntilDrained();
+}
+
+bool EchoCanceller3Engine::SubmitFrame(SessionId id,
+                                       rtc::ArrayView<const int16_t> render,
+                                       rtc::ArrayView<const int16_t> capture,
+                                       rtc::ArrayView<int16_t> output) {
+  const int64_t deadline_us =
+      rtc::TimeMicros() +
+      config_.frame_deadline_ms * rtc::kNumMicrosecsPerMillisec;
+  Session* session;
+  bool needs_scheduling;
+  {
+    MutexLock lock(&sessions_mutex_);
+    RTC_CHECK_LT(id, sessions_.size());
+    session = sessions_[id].get();
+    RTC_CHECK(session);
+    // The frame needs to be counted before it can be processed.
+    ++pending_frames_;
+    if (!session->Push(render, capture, output, deadline_us,
+                       &needs_scheduling)) {
+      --pending_frames_;
+      return false;
+    }
+  }
+  if (needs_scheduling) {
+    Schedule(session);
+  }
+  return true;
+}
+
+void EchoCanceller3Engine::WaitUntilIdle() {
+  // The event only wakes up one waiter, so the wait is bounded to support
+  // concurrent callers.
+  while (pending_frames_ > 0) {
+    idle_event_.Wait(TimeDelta::Millis(10));
+  }
+}
+
+EchoCanceller3Engine::SessionStats EchoCanceller3Engine::GetSessionStats(
+    SessionId id) const {
+  MutexLock lock(&sessions_mutex_);
+  RTC_CHECK_LT(id, sessions_.size());
+  RTC_CHECK(sessions_[id]);
+  return sessions_[id]->stats();
+}
+
+void EchoCanceller3Engine::Schedule(Session* session) {
+  Worker& home = *workers_[session->home_worker];
+  {
+    MutexLock lock(&home.mutex);
+    home.tasks.push_back(session);
+  }
+  home.wakeup.Set();
+
+  // If the home worker is busy, let an idle worker steal the task.
+  if (!home.idle) {
+    for (auto& worker : workers_) {
+      if (worker->idle) {
+        worker->wakeup.Set();
+        break;
+      }
+    }
+  }
+}
+
+EchoCanceller3Engine::Session* EchoCanceller3Engine::PopTask(
+    size_t worker_index) {
+  // Tasks are taken from the front both by the owner and by thieves, as the
+  // oldest task is the one closest to its deadline.
+  for (size_t k = 0; k < workers_.size(); ++k) {
+    Worker& worker = *workers_[(worker_index + k) % workers_.size()];
+    MutexLock lock(&worker.mutex);
+    if (!worker.tasks.empty()) {
+      Session* session = worker.tasks.front();
+      worker.tasks.pop_front();
+      return session;
+    }
+  }
+  return nullptr;
+}
+
+void EchoCanceller3Engine::WorkerLoop(size_t worker_index) {
+  Worker& self = *workers_[worker_index];
+  while (!quit_) {
+    Session* session = PopTask(worker_index);
+    if (!session) {
+      // Look for work once more after announcing that the worker is idle, so
+      // that tasks scheduled in between are not left to a busy worker.
+      self.idle = true;
+      session = PopTask(worker_index);
+      if (!session) {
+        self.wakeup.Wait(rtc::Event::kForever);
+        self.idle = false;
+        continue;
+      }
+      self.idle = false;
+    }
+
+    const int num_processed = session->ProcessQueuedFrames();
+    if (pending_frames_.fetch_sub(num_processed) == num_processed) {
+      idle_event_.Set();
+    }
+  }
+}
+
+}  // namespace webrtc
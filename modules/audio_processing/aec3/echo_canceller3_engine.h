@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_ECHO_CANCELLER3_ENGINE_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_ECHO_CANCELLER3_ENGINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/audio/echo_canceller3_config.h"
+#include "rtc_base/event.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Runs many independent echo canceller sessions on a fixed pool of worker
+// threads instead of using one thread per session.
+//
+// Each session owns an EchoCanceller3 and accepts pairs of interleaved 10 ms
+// render and capture frames. The processing of a frame pair (render analysis
+// followed by the capture processing, which runs
+// BlockProcessor::ProcessCapture for the blocks in the frame) is scheduled on
+// the pool. Sessions are assigned a home worker for cache locality and idle
+// workers steal queued sessions from busy ones. The frames of a session are
+// always processed in order and never concurrently.
+//
+// Every frame gets a deadline relative to the time it was submitted and the
+// lateness with respect to that deadline is reported per session.
+//
+// All methods are thread-safe.
+class EchoCanceller3Engine {
+ public:
+  using SessionId = int;
+
+  struct Config {
+    EchoCanceller3Config aec3;
+    // Number of worker threads. Zero selects the number of available cores.
+    size_t num_workers = 0;
+    // Whether worker n is pinned to core (first_core + n) % number of cores.
+    bool pin_workers = true;
+    int first_core = 0;
+    // Time allowed for processing a frame, counted from its submission.
+    int frame_deadline_ms = 10;
+    // Maximum number of frames that may be queued for a session. Frames
+    // submitted beyond that are dropped.
+    size_t max_queued_frames_per_session = 4;
+  };
+
+  struct SessionStats {
+    int64_t frames_processed = 0;
+    int64_t frames_late = 0;
+    int64_t frames_dropped = 0;
+    // Lateness of the most recently processed frame. Negative values denote
+    // the margin to the deadline.
+    int64_t last_lateness_us = 0;
+    // Largest and accumulated lateness over the late frames.
+    int64_t max_lateness_us = 0;
+    int64_t total_lateness_us = 0;
+  };
+
+  explicit EchoCanceller3Engine(const Config& config);
+  ~EchoCanceller3Engine();
+
+  EchoCanceller3Engine(const EchoCanceller3Engine&) = delete;
+  EchoCanceller3Engine& operator=(const EchoCanceller3Engine&) = delete;
+
+  // Creates a session with its own echo canceller. The sample rate and the
+  // number of channels define the size of the frames accepted by
+  // SubmitFrame().
+  SessionId CreateSession(int sample_rate_hz,
+                          size_t num_render_channels,
+                          size_t num_capture_channels);
+
+  // Destroys a session after any of its queued frames have been processed.
+  void DestroySession(SessionId id);
+
+  // Queues one 10 ms frame of interleaved render and capture audio for
+  // processing. The echo cancelled capture audio is written to `output`, which
+  // must stay valid until the frame has been processed (see WaitUntilIdle()).
+  // Returns false if the frame was dropped because the session queue was full.
+  bool SubmitFrame(SessionId id,
+                   rtc::ArrayView<const int16_t> render,
+                   rtc::ArrayView<const int16_t> capture,
+                   rtc::ArrayView<int16_t> output);
+
+  // Blocks until all submitted frames have been processed.
+  void WaitUntilIdle();
+
+  // Returns the deadline statistics for a session.
+  SessionStats GetSessionStats(SessionId id) const;
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  class Session;
+  struct Worker;
+
+  // Queues `session` on its home worker and wakes up workers to process it.
+  void Schedule(Session* session);
+  Session* PopTask(size_t worker_index);
+  void WorkerLoop(size_t worker_index);
+
+  const Config config_;
+  mutable Mutex sessions_mutex_;
+  std::vector<std::unique_ptr<Session>> sessions_
+      RTC_GUARDED_BY(sessions_mutex_);
+  std::vector<SessionId> free_session_ids_ RTC_GUARDED_BY(sessions_mutex_);
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<bool> quit_{false};
+  std::atomic<int64_t> pending_frames_{0};
+  rtc::Event idle_event_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_ECHO_CANCELLER3_ENGINE_H_
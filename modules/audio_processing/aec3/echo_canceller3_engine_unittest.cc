@@ -0,0 +1,281 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/echo_canceller3_engine.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "modules/audio_processing/aec3/echo_canceller3.h"
+#include "modules/audio_processing/audio_buffer.h"
+#include "modules/audio_processing/high_pass_filter.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/random.h"
+#include "rtc_base/strings/string_builder.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumFrames = 200;
+
+std::string ProduceDebugText(int sample_rate_hz, size_t num_channels) {
+  rtc::StringBuilder ss;
+  ss << "Sample rate: " << sample_rate_hz << ", ";
+  ss << "num_channels: " << num_channels;
+  return ss.Release();
+}
+
+// Produces render frames of noise and capture frames that contain a delayed
+// and attenuated copy of the render signal.
+class SignalGenerator {
+ public:
+  SignalGenerator(int sample_rate_hz, size_t num_channels, uint64_t seed)
+      : frame_length_(sample_rate_hz / 100 * num_channels),
+        random_generator_(seed),
+        delay_line_(3 * frame_length_ / 2, 0) {}
+
+  void Generate(std::vector<int16_t>* render, std::vector<int16_t>* capture) {
+    render->resize(frame_length_);
+    capture->resize(frame_length_);
+    for (size_t k = 0; k < frame_length_; ++k) {
+      (*render)[k] = random_generator_.Rand(-10000, 10000);
+      const int16_t echo = delay_line_[delay_index_] / 4;
+      delay_line_[delay_index_] = (*render)[k];
+      delay_index_ = (delay_index_ + 1) % delay_line_.size();
+      (*capture)[k] = echo + random_generator_.Rand(-100, 100);
+    }
+  }
+
+ private:
+  const size_t frame_length_;
+  Random random_generator_;
+  std::vector<int16_t> delay_line_;
+  size_t delay_index_ = 0;
+};
+
+// Processes frames the same way as the engine, but on the calling thread.
+class ReferenceProcessor {
+ public:
+  ReferenceProcessor(int sample_rate_hz, size_t num_channels)
+      : config_(sample_rate_hz, num_channels),
+        echo_canceller_(EchoCanceller3Config(),
+                        absl::nullopt,
+                        sample_rate_hz,
+                        num_channels,
+                        num_channels),
+        high_pass_filter_(sample_rate_hz, num_channels),
+        render_(sample_rate_hz,
+                num_channels,
+                sample_rate_hz,
+                num_channels,
+                sample_rate_hz,
+                num_channels),
+        capture_(sample_rate_hz,
+                 num_channels,
+                 sample_rate_hz,
+                 num_channels,
+                 sample_rate_hz,
+                 num_channels) {}
+
+  void Process(const std::vector<int16_t>& render,
+               const std::vector<int16_t>& capture,
+               std::vector<int16_t>* output) {
+    const bool multi_band = capture_.num_bands() > 1;
+    output->resize(capture.size());
+    render_.CopyFrom(render.data(), config_);
+    if (multi_band) {
+      render_.SplitIntoFrequencyBands();
+    }
+    echo_canceller_.AnalyzeRender(&render_);
+    capture_.CopyFrom(capture.data(), config_);
+    echo_canceller_.AnalyzeCapture(&capture_);
+    if (multi_band) {
+      capture_.SplitIntoFrequencyBands();
+    }
+    high_pass_filter_.Process(&capture_, true);
+    echo_canceller_.ProcessCapture(&capture_, false);
+    if (multi_band) {
+      capture_.MergeFrequencyBands();
+    }
+    capture_.CopyTo(config_, output->data());
+  }
+
+ private:
+  const StreamConfig config_;
+  EchoCanceller3 echo_canceller_;
+  HighPassFilter high_pass_filter_;
+  AudioBuffer render_;
+  AudioBuffer capture_;
+};
+
+EchoCanceller3Engine::Config EngineConfig(size_t num_workers) {
+  EchoCanceller3Engine::Config config;
+  config.num_workers = num_workers;
+  config.pin_workers = false;
+  return config;
+}
+
+}  // namespace
+
+// Verifies that sessions processed on the pool produce the same output as
+// echo cancellers that are run directly on the calling thread.
+TEST(EchoCanceller3Engine, BitexactWithStandaloneEchoCanceller) {
+  constexpr int kNumSessionsPerConfig = 3;
+  EchoCanceller3Engine engine(EngineConfig(/*num_workers=*/2));
+
+  struct TestSession {
+    EchoCanceller3Engine::SessionId id;
+    std::unique_ptr<SignalGenerator> generator;
+    std::unique_ptr<ReferenceProcessor> reference;
+    std::vector<int16_t> render;
+    std::vector<int16_t> capture;
+    std::vector<int16_t> output;
+    std::vector<int16_t> reference_output;
+    std::string debug_text;
+  };
+  std::vector<TestSession> sessions;
+  for (int rate : {16000, 48000}) {
+    for (size_t num_channels : {1, 2}) {
+      for (int k = 0; k < kNumSessionsPerConfig; ++k) {
+        TestSession session;
+        session.id = engine.CreateSession(rate, num_channels, num_channels);
+        session.generator = std::make_unique<SignalGenerator>(
+            rate, num_channels, /*seed=*/sessions.size() + 1);
+        session.reference =
+            std::make_unique<ReferenceProcessor>(rate, num_channels);
+        session.output.resize(rate / 100 * num_channels);
+        session.debug_text = ProduceDebugText(rate, num_channels);
+        sessions.push_back(std::move(session));
+      }
+    }
+  }
+
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    for (auto& session : sessions) {
+      session.generator->Generate(&session.render, &session.capture);
+      ASSERT_TRUE(engine.SubmitFrame(session.id, session.render,
+                                     session.capture, session.output));
+    }
+    for (auto& session : sessions) {
+      session.reference->Process(session.render, session.capture,
+                                 &session.reference_output);
+    }
+    engine.WaitUntilIdle();
+    for (auto& session : sessions) {
+      SCOPED_TRACE(session.debug_text);
+      ASSERT_EQ(session.reference_output, session.output);
+    }
+  }
+
+  for (auto& session : sessions) {
+    const auto stats = engine.GetSessionStats(session.id);
+    EXPECT_EQ(kNumFrames, stats.frames_processed);
+    EXPECT_EQ(0, stats.frames_dropped);
+    engine.DestroySession(session.id);
+  }
+}
+
+// Verifies that several frames may be queued for a session and that they are
+// processed in order.
+TEST(EchoCanceller3Engine, QueuedFramesAreProcessedInOrder) {
+  constexpr int kSampleRateHz = 16000;
+  constexpr size_t kFrameLength = kSampleRateHz / 100;
+  constexpr int kQueueDepth = 4;
+  auto config = EngineConfig(/*num_workers=*/4);
+  config.max_queued_frames_per_session = kQueueDepth;
+  EchoCanceller3Engine engine(config);
+  const auto id = engine.CreateSession(kSampleRateHz, 1, 1);
+
+  SignalGenerator generator(kSampleRateHz, 1, 42);
+  ReferenceProcessor reference(kSampleRateHz, 1);
+  std::vector<std::vector<int16_t>> render(kQueueDepth);
+  std::vector<std::vector<int16_t>> capture(kQueueDepth);
+  std::vector<std::vector<int16_t>> output(
+      kQueueDepth, std::vector<int16_t>(kFrameLength));
+  std::vector<int16_t> reference_output;
+  for (int k = 0; k < kNumFrames / kQueueDepth; ++k) {
+    for (int j = 0; j < kQueueDepth; ++j) {
+      generator.Generate(&render[j], &capture[j]);
+      ASSERT_TRUE(engine.SubmitFrame(id, render[j], capture[j], output[j]));
+    }
+    engine.WaitUntilIdle();
+    for (int j = 0; j < kQueueDepth; ++j) {
+      reference.Process(render[j], capture[j], &reference_output);
+      ASSERT_EQ(reference_output, output[j]);
+    }
+  }
+  EXPECT_EQ(kNumFrames, engine.GetSessionStats(id).frames_processed);
+}
+
+// Verifies that frames that are submitted while the session queue is full are
+// dropped and reported.
+TEST(EchoCanceller3Engine, FramesAreDroppedWhenQueueIsFull) {
+  constexpr int kSampleRateHz = 48000;
+  constexpr size_t kFrameLength = kSampleRateHz / 100;
+  constexpr int kNumSubmittedFrames = 50;
+  auto config = EngineConfig(/*num_workers=*/1);
+  config.max_queued_frames_per_session = 1;
+  EchoCanceller3Engine engine(config);
+  const auto id = engine.CreateSession(kSampleRateHz, 1, 1);
+
+  std::vector<int16_t> render(kFrameLength, 1000);
+  std::vector<int16_t> capture(kFrameLength, 1000);
+  std::vector<int16_t> output(kFrameLength);
+  int num_accepted = 0;
+  for (int k = 0; k < kNumSubmittedFrames; ++k) {
+    num_accepted += engine.SubmitFrame(id, render, capture, output) ? 1 : 0;
+  }
+  engine.WaitUntilIdle();
+
+  const auto stats = engine.GetSessionStats(id);
+  EXPECT_LE(1, num_accepted);
+  EXPECT_EQ(num_accepted, stats.frames_processed);
+  EXPECT_EQ(kNumSubmittedFrames - num_accepted, stats.frames_dropped);
+}
+
+// Verifies that frames that miss their deadline are reported as late.
+TEST(EchoCanceller3Engine, ReportsLateness) {
+  constexpr int kSampleRateHz = 16000;
+  constexpr size_t kFrameLength = kSampleRateHz / 100;
+  auto config = EngineConfig(/*num_workers=*/1);
+  config.frame_deadline_ms = -1000;
+  EchoCanceller3Engine engine(config);
+  const auto id = engine.CreateSession(kSampleRateHz, 1, 1);
+
+  std::vector<int16_t> render(kFrameLength, 0);
+  std::vector<int16_t> capture(kFrameLength, 0);
+  std::vector<int16_t> output(kFrameLength);
+  for (int k = 0; k < 10; ++k) {
+    ASSERT_TRUE(engine.SubmitFrame(id, render, capture, output));
+    engine.WaitUntilIdle();
+  }
+
+  const auto stats = engine.GetSessionStats(id);
+  EXPECT_EQ(10, stats.frames_processed);
+  EXPECT_EQ(10, stats.frames_late);
+  EXPECT_LE(1000 * 1000, stats.last_lateness_us);
+  EXPECT_LE(stats.last_lateness_us, stats.max_lateness_us);
+  EXPECT_LE(10 * 1000 * 1000, stats.total_lateness_us);
+}
+
+// Verifies that the ids of destroyed sessions are reused.
+TEST(EchoCanceller3Engine, SessionIdsAreReused) {
+  EchoCanceller3Engine engine(EngineConfig(/*num_workers=*/1));
+  const auto id0 = engine.CreateSession(16000, 1, 1);
+  const auto id1 = engine.CreateSession(16000, 1, 1);
+  EXPECT_NE(id0, id1);
+  engine.DestroySession(id0);
+  EXPECT_EQ(id0, engine.CreateSession(48000, 2, 1));
+}
+
+}  // namespace webrtc
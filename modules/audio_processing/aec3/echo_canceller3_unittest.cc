@@ -17,12 +17,15 @@
 #include <vector>
 
 #include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/block_processor.h"
+#include "modules/audio_processing/aec3/block_stream_adapter.h"
 #include "modules/audio_processing/aec3/frame_blocker.h"
 #include "modules/audio_processing/aec3/mock/mock_block_processor.h"
 #include "modules/audio_processing/audio_buffer.h"
 #include "modules/audio_processing/high_pass_filter.h"
 #include "modules/audio_processing/utility/cascaded_biquad_filter.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
@@ -1125,6 +1128,141 @@ TEST(EchoCanceller3, StereoContentDetectionForMonoSignals) {
   }
 }
 
+// Verifies that the echo is removed when the signals are passed through the
+// block-level API in 2.5 ms chunks.
+TEST(EchoCanceller3, BlockLevelApiRemovesEcho) {
+  constexpr size_t kChunkLength = 40;
+  constexpr size_t kEchoDelay = 200;
+  constexpr size_t kNumChunks = 2000;
+  EchoCanceller3 aec3(EchoCanceller3Config(),
+                      /*multichannel_config=*/absl::nullopt, 16000, 1, 1);
+  BlockStreamAdapter render_adapter(/*num_bands=*/1, /*num_channels=*/1);
+  BlockStreamAdapter capture_adapter(/*num_bands=*/1, /*num_channels=*/1);
+
+  Random random_generator(42U);
+  std::vector<float> render(kChunkLength);
+  std::vector<float> capture(kChunkLength);
+  std::deque<float> echo_path(kEchoDelay, 0.0f);
+  std::vector<std::vector<rtc::ArrayView<const float>>> render_view(
+      1, std::vector<rtc::ArrayView<const float>>(1, render));
+  std::vector<std::vector<rtc::ArrayView<float>>> capture_view(
+      1, std::vector<rtc::ArrayView<float>>(1, capture));
+  float capture_energy = 0.0f;
+  float output_energy = 0.0f;
+  for (size_t chunk = 0; chunk < kNumChunks; ++chunk) {
+    for (size_t k = 0; k < kChunkLength; ++k) {
+      render[k] = random_generator.Rand(-10000, 10000);
+      echo_path.push_back(render[k]);
+      capture[k] = 0.5f * echo_path.front();
+      echo_path.pop_front();
+    }
+    const bool measure = chunk >= kNumChunks - kNumChunks / 10;
+    if (measure) {
+      for (float y : capture) {
+        capture_energy += y * y;
+      }
+    }
+
+    for (size_t k = 0; k < kChunkLength;) {
+      k += render_adapter.InsertSamples(render_view, k);
+      if (render_adapter.IsBlockComplete()) {
+        aec3.AnalyzeRenderBlock(render_adapter.block());
+      }
+    }
+    for (size_t k = 0; k < kChunkLength;) {
+      k += capture_adapter.ExchangeSamples(capture_view, k);
+      if (capture_adapter.IsBlockComplete()) {
+        aec3.ProcessCaptureBlock(/*level_change=*/false,
+                                 /*saturated_microphone_signal=*/false,
+                                 /*linear_output=*/nullptr,
+                                 capture_adapter.block());
+      }
+    }
+
+    if (measure) {
+      for (float e : capture) {
+        output_energy += e * e;
+      }
+    }
+  }
+  EXPECT_LT(output_energy, 0.01f * capture_energy);
+}
+
+// Verifies that render blocks passed through the block-level API drive the
+// detection of proper stereo content.
+TEST(EchoCanceller3, BlockLevelApiDetectsProperStereo) {
+  EchoCanceller3Config config;
+  config.multi_channel.detect_stereo_content = true;
+  config.multi_channel.stereo_detection_threshold = 0.0f;
+  config.multi_channel.stereo_detection_hysteresis_seconds = 0.0f;
+  EchoCanceller3 aec3(config, /*multichannel_config=*/absl::nullopt,
+                      /*sample_rate_hz=*/16000, /*num_render_channels=*/2,
+                      /*num_capture_input_channels=*/1);
+  Block render(/*num_bands=*/1, /*num_channels=*/2);
+  Block capture(/*num_bands=*/1, /*num_channels=*/1);
+
+  for (float right_offset : {0.0f, 1.0f}) {
+    for (int k = 0; k < 3; ++k) {
+      std::fill(render.begin(/*band=*/0, /*channel=*/0),
+                render.end(/*band=*/0, /*channel=*/0), 100.0f);
+      std::fill(render.begin(/*band=*/0, /*channel=*/1),
+                render.end(/*band=*/0, /*channel=*/1), 100.0f + right_offset);
+      aec3.AnalyzeRenderBlock(&render);
+      aec3.ProcessCaptureBlock(/*level_change=*/false,
+                               /*saturated_microphone_signal=*/false,
+                               /*linear_output=*/nullptr, &capture);
+    }
+    EXPECT_EQ(right_offset > 0.0f,
+              aec3.StereoRenderProcessingActiveForTesting());
+  }
+}
+
+// Verifies that the compute tier is degraded when the CPU budget is exceeded
+// and that the echo is still removed with the reduced complexity.
+TEST(EchoCanceller3, ComputeScalingDegradesTier) {
+  constexpr size_t kEchoDelay = 200;
+  constexpr size_t kNumBlocks = 2500;
+  EchoCanceller3 aec3(EchoCanceller3Config(),
+                      /*multichannel_config=*/absl::nullopt, 16000, 1, 1);
+  EXPECT_EQ(aec3.GetComputeTier(), Aec3ComputeTier::kFull);
+  aec3.EnableComputeScaling(/*max_load=*/1e-6f, /*shared_budget=*/nullptr);
+
+  Random random_generator(42U);
+  Block render(/*num_bands=*/1, /*num_channels=*/1);
+  Block capture(/*num_bands=*/1, /*num_channels=*/1);
+  std::deque<float> echo_path(kEchoDelay, 0.0f);
+  float capture_energy = 0.0f;
+  float output_energy = 0.0f;
+  for (size_t block = 0; block < kNumBlocks; ++block) {
+    for (size_t k = 0; k < kBlockSize; ++k) {
+      const float x = random_generator.Rand(-10000, 10000);
+      render.View(/*band=*/0, /*channel=*/0)[k] = x;
+      echo_path.push_back(x);
+      capture.View(/*band=*/0, /*channel=*/0)[k] = 0.5f * echo_path.front();
+      echo_path.pop_front();
+    }
+    const bool measure = block >= kNumBlocks - kNumBlocks / 10;
+    if (measure) {
+      for (float y : capture.View(/*band=*/0, /*channel=*/0)) {
+        capture_energy += y * y;
+      }
+    }
+
+    aec3.AnalyzeRenderBlock(&render);
+    aec3.ProcessCaptureBlock(/*level_change=*/false,
+                             /*saturated_microphone_signal=*/false,
+                             /*linear_output=*/nullptr, &capture);
+
+    if (measure) {
+      for (float e : capture.View(/*band=*/0, /*channel=*/0)) {
+        output_energy += e * e;
+      }
+    }
+  }
+  EXPECT_EQ(aec3.GetComputeTier(), Aec3ComputeTier::kReducedFilterLength);
+  EXPECT_LT(output_energy, 0.03f * capture_energy);
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 
 TEST(EchoCanceller3InputCheckDeathTest, WrongCaptureNumBandsCheckVerification) {
@@ -28,6 +28,7 @@ EchoPathDelayEstimator::EchoPathDelayEstimator(
       sub_block_size_(down_sampling_factor_ != 0
                           ? kBlockSize / down_sampling_factor_
                           : kBlockSize),
+      use_matched_filter_tracking_(config.delay.use_matched_filter_tracking),
       capture_mixer_(num_capture_channels,
                      config.delay.capture_alignment_mixing),
       capture_decimator_(down_sampling_factor_),
@@ -44,7 +45,9 @@ EchoPathDelayEstimator::EchoPathDelayEstimator(
           config.delay.delay_estimate_smoothing,
           config.delay.delay_estimate_smoothing_delay_found,
           config.delay.delay_candidate_detection_threshold,
-          config.delay.detect_pre_echo),
+          config.delay.detect_pre_echo,
+          config.delay.use_fft_matched_filter,
+          config.delay.use_matched_filter_tracking),
       matched_filter_lag_aggregator_(data_dumper_,
                                      matched_filter_.GetMaxFilterLag(),
                                      config.delay) {
@@ -115,6 +118,11 @@ absl::optional<DelayEstimate> EchoPathDelayEstimator::EstimateDelay(
   return aggregated_matched_filter_lag;
 }
 
+void EchoPathDelayEstimator::SetComputeTier(Aec3ComputeTier tier) {
+  matched_filter_.SetTracking(use_matched_filter_tracking_ ||
+                              tier >= Aec3ComputeTier::kReducedDelayEstimation);
+}
+
 void EchoPathDelayEstimator::Reset(bool reset_lag_aggregator,
                                    bool reset_delay_confidence) {
   if (reset_lag_aggregator) {
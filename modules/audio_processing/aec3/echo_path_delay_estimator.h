@@ -15,6 +15,7 @@
 
 #include "absl/types/optional.h"
 #include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/alignment_mixer.h"
 #include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/clockdrift_detector.h"
@@ -60,10 +61,18 @@ class EchoPathDelayEstimator {
     return clockdrift_detector_.ClockdriftLevel();
   }
 
+  // Restarts the search for the delay over the full delay range, as after a
+  // change of the echo path.
+  void RestartFullSearch() { matched_filter_.RestartFullSearch(); }
+
+  // Reduces the complexity of the delay estimation according to `tier`.
+  void SetComputeTier(Aec3ComputeTier tier);
+
  private:
   ApmDataDumper* const data_dumper_;
   const size_t down_sampling_factor_;
   const size_t sub_block_size_;
+  const bool use_matched_filter_tracking_;
   AlignmentMixer capture_mixer_;
   Decimator capture_decimator_;
   MatchedFilter matched_filter_;
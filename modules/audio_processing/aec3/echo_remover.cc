@@ -29,6 +29,7 @@
 #include "modules/audio_processing/aec3/render_buffer.h"
 #include "modules/audio_processing/aec3/render_signal_analyzer.h"
 #include "modules/audio_processing/aec3/residual_echo_estimator.h"
+#include "modules/audio_processing/aec3/stage_profiler.h"
 #include "modules/audio_processing/aec3/subtractor.h"
 #include "modules/audio_processing/aec3/subtractor_output.h"
 #include "modules/audio_processing/aec3/suppression_filter.h"
@@ -135,6 +136,13 @@ class EchoRemoverImpl final : public EchoRemover {
     capture_output_used_ = capture_output_used;
   }
 
+  void SaveWarmStartState(Aec3WarmStartState* state) const override;
+  void RestoreWarmStartState(const Aec3WarmStartState& state) override;
+
+  void SetComputeTier(Aec3ComputeTier tier) override {
+    subtractor_.SetComputeTier(tier);
+  }
+
  private:
   // Selects which of the coarse and refined linear filter outputs that is most
   // appropriate to pass to the suppressor and forms the linear filter output by
@@ -366,17 +374,23 @@ void EchoRemoverImpl::ProcessCapture(
   }
 
   // Perform linear echo cancellation.
-  subtractor_.Process(*render_buffer, *y, render_signal_analyzer_, aec_state_,
-                      subtractor_output);
+  {
+    ScopedStageTimer timer(Aec3Stage::kSubtractor);
+    subtractor_.Process(*render_buffer, *y, render_signal_analyzer_,
+                        aec_state_, subtractor_output);
+  }
 
   // Compute spectra.
-  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
-    FormLinearFilterOutput(subtractor_output[ch], e[ch]);
-    WindowedPaddedFft(fft_, y->View(/*band=*/0, ch), y_old_[ch], &Y[ch]);
-    WindowedPaddedFft(fft_, e[ch], e_old_[ch], &E[ch]);
-    LinearEchoPower(E[ch], Y[ch], &S2_linear[ch]);
-    Y[ch].Spectrum(optimization_, Y2[ch]);
-    E[ch].Spectrum(optimization_, E2[ch]);
+  {
+    ScopedStageTimer timer(Aec3Stage::kCaptureFft);
+    for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+      FormLinearFilterOutput(subtractor_output[ch], e[ch]);
+      WindowedPaddedFft(fft_, y->View(/*band=*/0, ch), y_old_[ch], &Y[ch]);
+      WindowedPaddedFft(fft_, e[ch], e_old_[ch], &E[ch]);
+      LinearEchoPower(E[ch], Y[ch], &S2_linear[ch]);
+      Y[ch].Spectrum(optimization_, Y2[ch]);
+      E[ch].Spectrum(optimization_, E2[ch]);
+    }
   }
 
   // Optionally return the linear filter output.
@@ -410,9 +424,12 @@ void EchoRemoverImpl::ProcessCapture(
   std::array<float, kFftLengthBy2Plus1> G;
   if (capture_output_used_) {
     // Estimate the residual echo power.
-    residual_echo_estimator_.Estimate(aec_state_, *render_buffer, S2_linear, Y2,
-                                      suppression_gain_.IsDominantNearend(), R2,
-                                      R2_unbounded);
+    {
+      ScopedStageTimer timer(Aec3Stage::kResidualEchoEstimator);
+      residual_echo_estimator_.Estimate(
+          aec_state_, *render_buffer, S2_linear, Y2,
+          suppression_gain_.IsDominantNearend(), R2, R2_unbounded);
+    }
 
     // Suppressor nearend estimate.
     if (aec_state_.UsableLinearEstimate()) {
@@ -435,12 +452,19 @@ void EchoRemoverImpl::ProcessCapture(
 
     // Compute preferred gains.
     float high_bands_gain;
-    suppression_gain_.GetGain(nearend_spectrum, echo_spectrum, R2, R2_unbounded,
-                              cng_.NoiseSpectrum(), render_signal_analyzer_,
-                              aec_state_, x, clock_drift, &high_bands_gain, &G);
+    {
+      ScopedStageTimer timer(Aec3Stage::kSuppressionGain);
+      suppression_gain_.GetGain(nearend_spectrum, echo_spectrum, R2,
+                                R2_unbounded, cng_.NoiseSpectrum(),
+                                render_signal_analyzer_, aec_state_, x,
+                                clock_drift, &high_bands_gain, &G);
+    }
 
-    suppression_filter_.ApplyGain(comfort_noise, high_band_comfort_noise, G,
-                                  high_bands_gain, Y_fft, y);
+    {
+      ScopedStageTimer timer(Aec3Stage::kSuppressionFilter);
+      suppression_filter_.ApplyGain(comfort_noise, high_band_comfort_noise, G,
+                                    high_bands_gain, Y_fft, y);
+    }
 
   } else {
     G.fill(0.f);
@@ -474,6 +498,20 @@ void EchoRemoverImpl::ProcessCapture(
                         aec_state_.SaturatedCapture() ? 1 : 0);
 }
 
+void EchoRemoverImpl::SaveWarmStartState(Aec3WarmStartState* state) const {
+  state->num_render_channels = num_render_channels_;
+  state->capture_channels.resize(num_capture_channels_);
+  subtractor_.SaveWarmStartState(state);
+  aec_state_.SaveWarmStartState(state);
+}
+
+void EchoRemoverImpl::RestoreWarmStartState(const Aec3WarmStartState& state) {
+  RTC_DCHECK_EQ(state.num_render_channels, num_render_channels_);
+  RTC_DCHECK_EQ(state.capture_channels.size(), num_capture_channels_);
+  subtractor_.RestoreWarmStartState(state);
+  aec_state_.RestoreWarmStartState(state);
+}
+
 void EchoRemoverImpl::FormLinearFilterOutput(
     const SubtractorOutput& subtractor_output,
     rtc::ArrayView<float> output) {
@@ -16,10 +16,12 @@
 #include "absl/types/optional.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "api/audio/echo_control.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/delay_estimate.h"
 #include "modules/audio_processing/aec3/echo_path_variability.h"
 #include "modules/audio_processing/aec3/render_buffer.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 
 namespace webrtc {
 
@@ -55,6 +57,18 @@ class EchoRemover {
   // resulting output is anyway not used, for instance when the endpoint is
   // muted.
   virtual void SetCaptureOutputUsage(bool capture_output_used) = 0;
+
+  // Saves the converged filters and estimates into `state`, which is resized
+  // to the number of capture channels.
+  virtual void SaveWarmStartState(Aec3WarmStartState* /*state*/) const {}
+
+  // Restores the filters and estimates saved by an echo remover with the same
+  // setup.
+  virtual void RestoreWarmStartState(const Aec3WarmStartState& /*state*/) {}
+
+  // Reduces the complexity of the linear echo cancellation according to
+  // `tier`.
+  virtual void SetComputeTier(Aec3ComputeTier /*tier*/) {}
 };
 
 }  // namespace webrtc
@@ -38,6 +38,15 @@ void ErlEstimator::Reset() {
   blocks_since_reset_ = 0;
 }
 
+void ErlEstimator::SetErl(const std::array<float, kFftLengthBy2Plus1>& erl,
+                          float erl_time_domain) {
+  erl_ = erl;
+  erl_time_domain_ = erl_time_domain;
+  hold_counters_.fill(0);
+  hold_counter_time_domain_ = 0;
+  blocks_since_reset_ = startup_phase_length_blocks__;
+}
+
 void ErlEstimator::Update(
     const std::vector<bool>& converged_filters,
     rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> render_spectra,
@@ -40,6 +40,10 @@ class ErlEstimator {
               rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>>
                   capture_spectra);
 
+  // Sets the ERL estimates and ends the startup phase.
+  void SetErl(const std::array<float, kFftLengthBy2Plus1>& erl,
+              float erl_time_domain);
+
   // Returns the most recent ERL estimate.
   const std::array<float, kFftLengthBy2Plus1>& Erl() const { return erl_; }
   float ErlTimeDomain() const { return erl_time_domain_; }
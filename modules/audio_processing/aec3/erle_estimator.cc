@@ -42,6 +42,32 @@ void ErleEstimator::Reset(bool delay_change) {
   }
 }
 
+void ErleEstimator::SaveWarmStartState(Aec3WarmStartState* state) const {
+  const auto erle = subband_erle_estimator_.Erle(/*onset_compensated=*/false);
+  const auto erle_onset_compensated =
+      subband_erle_estimator_.Erle(/*onset_compensated=*/true);
+  const auto erle_unbounded = subband_erle_estimator_.ErleUnbounded();
+  RTC_DCHECK_EQ(state->capture_channels.size(), erle.size());
+  for (size_t ch = 0; ch < erle.size(); ++ch) {
+    auto& channel = state->capture_channels[ch];
+    channel.erle = erle[ch];
+    channel.erle_onset_compensated = erle_onset_compensated[ch];
+    channel.erle_unbounded = erle_unbounded[ch];
+    channel.fullband_erle_log2 = fullband_erle_estimator_.FullbandErleLog2(ch);
+  }
+}
+
+void ErleEstimator::RestoreWarmStartState(const Aec3WarmStartState& state) {
+  for (size_t ch = 0; ch < state.capture_channels.size(); ++ch) {
+    const auto& channel = state.capture_channels[ch];
+    subband_erle_estimator_.SetErle(ch, channel.erle,
+                                    channel.erle_onset_compensated,
+                                    channel.erle_unbounded);
+    fullband_erle_estimator_.SetErleLog2(ch, channel.fullband_erle_log2);
+  }
+  blocks_since_reset_ = startup_phase_length_blocks_;
+}
+
 void ErleEstimator::Update(
     const RenderBuffer& render_buffer,
     rtc::ArrayView<const std::vector<std::array<float, kFftLengthBy2Plus1>>>
@@ -25,6 +25,7 @@
 #include "modules/audio_processing/aec3/render_buffer.h"
 #include "modules/audio_processing/aec3/signal_dependent_erle_estimator.h"
 #include "modules/audio_processing/aec3/subband_erle_estimator.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 
 namespace webrtc {
@@ -54,6 +55,12 @@ class ErleEstimator {
           subtractor_spectra,
       const std::vector<bool>& converged_filters);
 
+  // Saves and restores the subband and fullband ERLE estimates. The state of
+  // the signal dependent ERLE estimator is not included. Restoring ends the
+  // startup phase.
+  void SaveWarmStartState(Aec3WarmStartState* state) const;
+  void RestoreWarmStartState(const Aec3WarmStartState& state);
+
   // Returns the most recent subband ERLE estimates.
   rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> Erle(
       bool onset_compensated) const {
@@ -14,13 +14,11 @@ namespace webrtc {
 
 FftBuffer::FftBuffer(size_t size, size_t num_channels)
     : size(static_cast<int>(size)),
-      buffer(size, std::vector<FftData>(num_channels)) {
-  for (auto& block : buffer) {
-    for (auto& channel_fft_data : block) {
-      channel_fft_data.Clear();
-    }
-  }
-}
+      buffer(storage_),
+      storage_(size, num_channels) {}
+
+FftBuffer::FftBuffer(FftBuffer* other)
+    : size(other->size), buffer(other->buffer), storage_(0, 0) {}
 
 FftBuffer::~FftBuffer() = default;
 
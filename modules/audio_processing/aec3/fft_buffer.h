@@ -13,17 +13,20 @@
 
 #include <stddef.h>
 
-#include <vector>
-
-#include "modules/audio_processing/aec3/fft_data.h"
+#include "modules/audio_processing/aec3/fft_data_array.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
 
-// Struct for bundling a circular buffer of FftData objects together with the
-// read and write indices.
+// Struct for bundling a circular buffer of FFT data together with the read and
+// write indices.
 struct FftBuffer {
   FftBuffer(size_t size, size_t num_channels);
+  // Creates a buffer with its own read and write indices that shares the
+  // stored FFTs with `other`, which must outlive the created buffer.
+  explicit FftBuffer(FftBuffer* other);
+  FftBuffer(const FftBuffer&) = delete;
+  FftBuffer& operator=(const FftBuffer&) = delete;
   ~FftBuffer();
 
   int IncIndex(int index) const {
@@ -50,9 +53,13 @@ struct FftBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<std::vector<FftData>> buffer;
+  FftDataArray& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  // Holds the FFTs unless they are shared with another buffer.
+  FftDataArray storage_;
 };
 
 }  // namespace webrtc
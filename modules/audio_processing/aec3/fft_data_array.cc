@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/fft_data_array.h"
+
+namespace webrtc {
+
+FftDataArray::FftDataArray(size_t size, size_t num_channels)
+    : size_(size), num_channels_(num_channels) {
+  Allocate();
+  Clear();
+}
+
+FftDataArray::~FftDataArray() {
+  Free();
+}
+
+FftDataArray::FftDataArray(const FftDataArray& other)
+    : size_(other.size_), num_channels_(other.num_channels_) {
+  Allocate();
+  std::copy(other.data_, other.data_ + size_ * num_channels_, data_);
+}
+
+FftDataArray& FftDataArray::operator=(const FftDataArray& other) {
+  if (this != &other) {
+    const bool same_num_elements =
+        size_ * num_channels_ == other.size_ * other.num_channels_;
+    size_ = other.size_;
+    num_channels_ = other.num_channels_;
+    if (!same_num_elements) {
+      Free();
+      Allocate();
+    }
+    std::copy(other.data_, other.data_ + size_ * num_channels_, data_);
+  }
+  return *this;
+}
+
+void FftDataArray::Clear() {
+  for (size_t k = 0; k < size_ * num_channels_; ++k) {
+    data_[k].Clear();
+  }
+}
+
+void FftDataArray::Allocate() {
+  const size_t num_elements = size_ * num_channels_;
+  Aec3Arena* arena = ScopedAec3ArenaBinding::Current();
+  void* allocation =
+      arena && num_elements > 0
+          ? arena->Allocate(num_elements * sizeof(AlignedFftData))
+          : nullptr;
+  if (allocation) {
+    arena_ = arena;
+    data_ = static_cast<AlignedFftData*>(allocation);
+  } else {
+    heap_data_.reset(new AlignedFftData[num_elements]);
+    data_ = heap_data_.get();
+  }
+}
+
+void FftDataArray::Free() {
+  if (arena_) {
+    arena_->Release();
+    arena_ = nullptr;
+  }
+  heap_data_.reset();
+  data_ = nullptr;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_FFT_DATA_ARRAY_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_FFT_DATA_ARRAY_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_arena.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/fft_data.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Number of bins stored per row in AlignedFftData. The 65 bins of a 128 point
+// real-valued FFT are padded to a multiple of 16 floats so that every row
+// starts on a cache line and can be processed with full-width SIMD vectors
+// without a scalar tail.
+constexpr size_t kFftLengthBy2Plus1Padded = 80;
+constexpr size_t kFftDataAlignment = 64;
+
+static_assert(kFftLengthBy2Plus1Padded >= kFftLengthBy2Plus1, "");
+static_assert(kFftLengthBy2Plus1Padded % 16 == 0, "");
+static_assert(Aec3Arena::kAlignment % kFftDataAlignment == 0, "");
+
+// Cache line aligned counterpart of FftData. Only the first
+// kFftLengthBy2Plus1 bins carry data; the padding bins are kept at zero, which
+// all the kernels operating on the data preserve.
+struct alignas(kFftDataAlignment) AlignedFftData {
+  // Copies the data in src and clears the padding.
+  void CopyFrom(const FftData& src) {
+    std::copy(src.re.begin(), src.re.end(), re.begin());
+    std::copy(src.im.begin(), src.im.end(), im.begin());
+    std::fill(re.begin() + kFftLengthBy2Plus1, re.end(), 0.f);
+    std::fill(im.begin() + kFftLengthBy2Plus1, im.end(), 0.f);
+  }
+
+  // Copies the data into dst.
+  void CopyTo(FftData* dst) const {
+    RTC_DCHECK(dst);
+    std::copy(re.begin(), re.begin() + kFftLengthBy2Plus1, dst->re.begin());
+    std::copy(im.begin(), im.begin() + kFftLengthBy2Plus1, dst->im.begin());
+  }
+
+  // Clears all the data, including the padding.
+  void Clear() {
+    re.fill(0.f);
+    im.fill(0.f);
+  }
+
+  std::array<float, kFftLengthBy2Plus1Padded> re;
+  std::array<float, kFftLengthBy2Plus1Padded> im;
+};
+
+// Two-dimensional (index x channel) array of AlignedFftData stored in one
+// contiguous allocation with all the channels of an index adjacent in memory.
+// Used for the partitions of the adaptive filters as well as for the circular
+// buffer of render FFTs, so that the filter kernels stream through both with
+// aligned loads. The storage is taken from the Aec3Arena bound to the
+// constructing thread when there is one and it has room, and from the heap
+// otherwise.
+class FftDataArray {
+ public:
+  FftDataArray(size_t size, size_t num_channels);
+  ~FftDataArray();
+
+  FftDataArray(const FftDataArray&);
+  FftDataArray& operator=(const FftDataArray&);
+
+  size_t size() const { return size_; }
+  size_t num_channels() const { return num_channels_; }
+
+  rtc::ArrayView<AlignedFftData> operator[](size_t index) {
+    RTC_DCHECK_LT(index, size_);
+    return rtc::ArrayView<AlignedFftData>(data_ + index * num_channels_,
+                                          num_channels_);
+  }
+
+  rtc::ArrayView<const AlignedFftData> operator[](size_t index) const {
+    RTC_DCHECK_LT(index, size_);
+    return rtc::ArrayView<const AlignedFftData>(data_ + index * num_channels_,
+                                                num_channels_);
+  }
+
+  // Clears all the data.
+  void Clear();
+
+ private:
+  // Allocates storage for size_ * num_channels_ elements.
+  void Allocate();
+  void Free();
+
+  size_t size_;
+  size_t num_channels_;
+  Aec3Arena* arena_ = nullptr;
+  std::unique_ptr<AlignedFftData[]> heap_data_;
+  AlignedFftData* data_ = nullptr;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_FFT_DATA_ARRAY_H_
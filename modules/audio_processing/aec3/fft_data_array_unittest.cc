@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/fft_data_array.h"
+
+#include <stdint.h>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+// Verifies that the data is stored contiguously, index-major and with every
+// element aligned to a cache line.
+TEST(FftDataArray, LayoutIsContiguousAndAligned) {
+  constexpr size_t kSize = 7;
+  constexpr size_t kNumChannels = 3;
+  FftDataArray x(kSize, kNumChannels);
+  EXPECT_EQ(kSize, x.size());
+  EXPECT_EQ(kNumChannels, x.num_channels());
+
+  const AlignedFftData* first = &x[0][0];
+  for (size_t k = 0; k < kSize; ++k) {
+    ASSERT_EQ(kNumChannels, x[k].size());
+    for (size_t ch = 0; ch < kNumChannels; ++ch) {
+      EXPECT_EQ(first + k * kNumChannels + ch, &x[k][ch]);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(x[k][ch].re.data()) %
+                        kFftDataAlignment);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(x[k][ch].im.data()) %
+                        kFftDataAlignment);
+    }
+  }
+}
+
+// Verifies that the data is initialized to zero.
+TEST(FftDataArray, InitializedToZero) {
+  FftDataArray x(4, 2);
+  for (size_t k = 0; k < x.size(); ++k) {
+    for (const auto& x_k_ch : x[k]) {
+      for (size_t j = 0; j < kFftLengthBy2Plus1Padded; ++j) {
+        EXPECT_EQ(0.f, x_k_ch.re[j]);
+        EXPECT_EQ(0.f, x_k_ch.im[j]);
+      }
+    }
+  }
+}
+
+// Verifies that FftData is copied in and out unchanged and that the padding
+// is cleared when copying in.
+TEST(AlignedFftData, CopyFromAndTo) {
+  FftData x;
+  for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
+    x.re[k] = k + 1.f;
+    x.im[k] = -2.f * k;
+  }
+
+  AlignedFftData y;
+  y.re.fill(1.f);
+  y.im.fill(1.f);
+  y.CopyFrom(x);
+  for (size_t k = kFftLengthBy2Plus1; k < kFftLengthBy2Plus1Padded; ++k) {
+    EXPECT_EQ(0.f, y.re[k]);
+    EXPECT_EQ(0.f, y.im[k]);
+  }
+
+  FftData z;
+  y.CopyTo(&z);
+  EXPECT_EQ(x.re, z.re);
+  EXPECT_EQ(x.im, z.im);
+}
+
+}  // namespace webrtc
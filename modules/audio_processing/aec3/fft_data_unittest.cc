@@ -62,6 +62,28 @@ TEST(FftData, TestAvx2Optimizations) {
     EXPECT_EQ(spectrum, spectrum_avx2);
   }
 }
+
+// Verifies that the AVX-512 method is bitexact to the AVX2 counterpart.
+TEST(FftData, TestAvx512Optimizations) {
+  if (GetCPUInfo(kAVX512) != 0) {
+    FftData x;
+
+    for (size_t k = 0; k < x.re.size(); ++k) {
+      x.re[k] = k + 1;
+    }
+
+    x.im[0] = x.im[x.im.size() - 1] = 0.f;
+    for (size_t k = 1; k < x.im.size() - 1; ++k) {
+      x.im[k] = 2.f * (k + 1);
+    }
+
+    std::array<float, kFftLengthBy2Plus1> spectrum_avx2;
+    std::array<float, kFftLengthBy2Plus1> spectrum_avx512;
+    x.Spectrum(Aec3Optimization::kAvx2, spectrum_avx2);
+    x.Spectrum(Aec3Optimization::kAvx512, spectrum_avx512);
+    EXPECT_EQ(spectrum_avx2, spectrum_avx512);
+  }
+}
 #endif
 
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
@@ -38,6 +38,16 @@ class FullBandErleEstimator {
               rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> E2,
               const std::vector<bool>& converged_filters);
 
+  // Sets the fullband ERLE estimate of a capture channel in log2 units.
+  void SetErleLog2(size_t channel, float erle_log2) {
+    erle_time_domain_log2_[channel] = erle_log2;
+  }
+
+  // Returns the fullband ERLE estimate of a capture channel in log2 units.
+  float FullbandErleLog2(size_t channel) const {
+    return erle_time_domain_log2_[channel];
+  }
+
   // Returns the fullband ERLE estimates in log2 units.
   float FullbandErleLog2() const {
     float min_erle = erle_time_domain_log2_[0];
@@ -20,6 +20,7 @@
 #endif
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
 #include <initializer_list>
 #include <iterator>
 #include <numeric>
@@ -40,6 +41,22 @@ namespace {
 // equal to 4.
 constexpr int kAccumulatedErrorSubSampleRate = 4;
 
+// Number of filters on each side of the filter with the last detected lag that
+// are updated on every call when tracking.
+constexpr int kNumTrackedNeighborFilters = 1;
+
+// Number of calls between the updates of the filters that are not tracked. On
+// each such update one of the filters is updated, in a round-robin manner.
+constexpr int kTrackingRefreshInterval = 4;
+
+// Number of calls to Update() after an echo path change during which all
+// filters are updated, even when tracking.
+constexpr int kNumFullSearchUpdates = webrtc::kNumBlocksPerSecond / 2;
+
+// Margin, in sub-blocks, around the candidate lag of the lag correlator within
+// which the matched filters are updated.
+constexpr size_t kCandidateLagMarginSubBlocks = 2;
+
 void UpdateAccumulatedError(
     const rtc::ArrayView<const float> instantaneous_accumulated_error,
     const rtc::ArrayView<float> accumulated_error,
@@ -670,7 +687,9 @@ MatchedFilter::MatchedFilter(ApmDataDumper* data_dumper,
                              float smoothing_fast,
                              float smoothing_slow,
                              float matching_filter_threshold,
-                             bool detect_pre_echo)
+                             bool detect_pre_echo,
+                             bool use_fft,
+                             bool use_tracking)
     : data_dumper_(data_dumper),
       optimization_(optimization),
       sub_block_size_(sub_block_size),
@@ -684,6 +703,7 @@ MatchedFilter::MatchedFilter(ApmDataDumper* data_dumper,
       smoothing_slow_(smoothing_slow),
       matching_filter_threshold_(matching_filter_threshold),
       detect_pre_echo_(detect_pre_echo),
+      use_tracking_(use_tracking),
       pre_echo_config_(FetchPreEchoConfiguration()) {
   RTC_DCHECK(data_dumper);
   RTC_DCHECK_LT(0, window_size_sub_blocks);
@@ -704,6 +724,13 @@ MatchedFilter::MatchedFilter(ApmDataDumper* data_dumper,
     scratch_memory_ =
         std::vector<float>(window_size_sub_blocks * sub_block_size_);
   }
+  if (use_fft) {
+    lag_correlator_ = std::make_unique<MatchedFilterFft>(
+        sub_block_size_,
+        (num_matched_filters - 1) * filter_intra_lag_shift_ +
+            filters_[0].size(),
+        excitation_limit_);
+  }
 }
 
 MatchedFilter::~MatchedFilter() = default;
@@ -713,6 +740,11 @@ void MatchedFilter::Reset(bool full_reset) {
     std::fill(f.begin(), f.end(), 0.f);
   }
 
+  if (lag_correlator_) {
+    lag_correlator_->Reset();
+  }
+  search_all_filters_ = false;
+
   winner_lag_ = absl::nullopt;
   reported_lag_estimate_ = absl::nullopt;
   if (pre_echo_config_.mode != 3 || full_reset) {
@@ -721,6 +753,10 @@ void MatchedFilter::Reset(bool full_reset) {
     }
     number_pre_echo_updates_ = 0;
   }
+
+  if (full_reset) {
+    tracked_filter_ = -1;
+  }
 }
 
 void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
@@ -729,6 +765,10 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
   RTC_DCHECK_EQ(sub_block_size_, capture.size());
   auto& y = capture;
 
+  if (lag_correlator_) {
+    lag_correlator_->Update(render_buffer, capture);
+  }
+
   const float smoothing =
       use_slow_smoothing ? smoothing_slow_ : smoothing_fast_;
 
@@ -749,7 +789,35 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
   absl::optional<size_t> previous_lag_estimate;
   const int num_filters = static_cast<int>(filters_.size());
   int winner_index = -1;
+  bool any_filter_updated = false;
+  num_updated_filters_ = 0;
+
+  // When tracking, one of the filters that are not tracked is updated every
+  // kTrackingRefreshInterval calls so that a change of the delay is detected.
+  // With the lag correlator, the filters around its candidate lag are updated
+  // instead.
+  int refresh_filter = -1;
+  if (!lag_correlator_ && tracked_filter_ >= 0 &&
+      ++num_updates_since_refresh_ >= kTrackingRefreshInterval) {
+    num_updates_since_refresh_ = 0;
+    for (int k = 0; k < num_filters; ++k) {
+      const int n = next_refresh_filter_;
+      next_refresh_filter_ = (next_refresh_filter_ + 1) % num_filters;
+      if (!IsTracked(n, /*refresh_filter=*/-1)) {
+        refresh_filter = n;
+        break;
+      }
+    }
+  }
+
   for (int n = 0; n < num_filters; ++n) {
+    if (!IsUpdated(n, refresh_filter)) {
+      previous_lag_estimate = absl::nullopt;
+      alignment_shift += filter_intra_lag_shift_;
+      continue;
+    }
+
+    ++num_updated_filters_;
     float error_sum = 0.f;
     bool filters_updated = false;
     const bool compute_pre_echo =
@@ -773,6 +841,12 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
             filters_[n], &filters_updated, &error_sum, compute_pre_echo,
             instantaneous_accumulated_error_, scratch_memory_);
         break;
+      case Aec3Optimization::kAvx512:
+        aec3::MatchedFilterCore_AVX512(
+            x_start_index, x2_sum_threshold, smoothing, render_buffer.buffer, y,
+            filters_[n], &filters_updated, &error_sum, compute_pre_echo,
+            instantaneous_accumulated_error_, scratch_memory_);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon:
@@ -789,6 +863,8 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
                                 instantaneous_accumulated_error_);
     }
 
+    any_filter_updated = any_filter_updated || filters_updated;
+
     // Estimate the lag in the matched filter as the distance to the portion in
     // the filter that contributes the most to the matched filter output. This
     // is detected as the peak of the matched filter.
@@ -844,14 +920,90 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
     }
     last_detected_best_lag_filter_ = winner_index;
   }
+
+  // When the filters around the candidate lag of the lag correlator adapt but
+  // none of them matches the capture signal, the delay may have changed before
+  // the correlator has detected it. All filters are then updated in the next
+  // call.
+  search_all_filters_ = any_filter_updated && winner_index == -1;
+
+  if (num_full_search_updates_ > 0) {
+    --num_full_search_updates_;
+  }
+  if (use_tracking_) {
+    if (!use_slow_smoothing || num_full_search_updates_ > 0) {
+      tracked_filter_ = -1;
+    } else if (winner_index != -1) {
+      tracked_filter_ = winner_index;
+    }
+  }
   if (ApmDataDumper::IsAvailable()) {
     Dump();
     data_dumper_->DumpRaw("error_sum_anchor", error_sum_anchor / y.size());
     data_dumper_->DumpRaw("number_pre_echo_updates", number_pre_echo_updates_);
     data_dumper_->DumpRaw("filter_smoothing", smoothing);
+    data_dumper_->DumpRaw("aec3_matched_filter_tracked_filter",
+                          tracked_filter_);
+    data_dumper_->DumpRaw("aec3_matched_filter_num_updated_filters",
+                          num_updated_filters_);
+    if (lag_correlator_) {
+      const absl::optional<size_t> candidate_lag =
+          lag_correlator_->candidate_lag();
+      data_dumper_->DumpRaw(
+          "aec3_matched_filter_candidate_lag",
+          candidate_lag ? static_cast<int>(*candidate_lag) : -1);
+    }
   }
 }
 
+void MatchedFilter::SetTracking(bool use_tracking) {
+  use_tracking_ = use_tracking;
+  if (!use_tracking_) {
+    tracked_filter_ = -1;
+  }
+}
+
+void MatchedFilter::RestartFullSearch() {
+  tracked_filter_ = -1;
+  num_full_search_updates_ = kNumFullSearchUpdates;
+  if (lag_correlator_) {
+    lag_correlator_->Reset();
+  }
+  search_all_filters_ = false;
+}
+
+bool MatchedFilter::IsUpdated(int n, int refresh_filter) const {
+  if (!lag_correlator_) {
+    return IsTracked(n, refresh_filter);
+  }
+  // When tracking, the filters around the candidate lag are updated instead of
+  // the neighbors of the tracked filter and the round-robin updates, as the
+  // correlator covers all lags.
+  const absl::optional<size_t> candidate_lag = lag_correlator_->candidate_lag();
+  if (tracked_filter_ >= 0) {
+    return n == tracked_filter_ ||
+           (candidate_lag && CoversCandidateLag(n, *candidate_lag));
+  }
+  return !candidate_lag || search_all_filters_ ||
+         CoversCandidateLag(n, *candidate_lag);
+}
+
+bool MatchedFilter::IsTracked(int n, int refresh_filter) const {
+  return tracked_filter_ < 0 || n == refresh_filter ||
+         std::abs(n - tracked_filter_) <= kNumTrackedNeighborFilters;
+}
+
+bool MatchedFilter::CoversCandidateLag(int n, size_t candidate_lag) const {
+  // The candidate lag has to be within the range of reliable lag estimates of
+  // the filter, with a margin for the inaccuracy of the correlation peak.
+  const int margin = static_cast<int>(kCandidateLagMarginSubBlocks *
+                                      sub_block_size_);
+  const int lag = static_cast<int>(candidate_lag);
+  const int filter_start = n * static_cast<int>(filter_intra_lag_shift_);
+  const int filter_end = filter_start + static_cast<int>(filters_[n].size());
+  return lag + margin > filter_start + 2 && lag - margin < filter_end - 10;
+}
+
 void MatchedFilter::LogFilterProperties(int sample_rate_hz,
                                         size_t shift,
                                         size_t downsampling_factor) const {
@@ -13,11 +13,13 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <vector>
 
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/matched_filter_fft.h"
 #include "rtc_base/gtest_prod_util.h"
 #include "rtc_base/system/arch.h"
 
@@ -73,6 +75,19 @@ void MatchedFilterCore_AVX2(size_t x_start_index,
                             rtc::ArrayView<float> accumulated_error,
                             rtc::ArrayView<float> scratch_memory);
 
+// Filter core for the matched filter that is optimized for AVX-512.
+void MatchedFilterCore_AVX512(size_t x_start_index,
+                              float x2_sum_threshold,
+                              float smoothing,
+                              rtc::ArrayView<const float> x,
+                              rtc::ArrayView<const float> y,
+                              rtc::ArrayView<float> h,
+                              bool* filters_updated,
+                              float* error_sum,
+                              bool compute_accumulated_error,
+                              rtc::ArrayView<float> accumulated_error,
+                              rtc::ArrayView<float> scratch_memory);
+
 #endif
 
 // Filter core for the matched filter.
@@ -121,7 +136,9 @@ class MatchedFilter {
                 float smoothing_fast,
                 float smoothing_slow,
                 float matching_filter_threshold,
-                bool detect_pre_echo);
+                bool detect_pre_echo,
+                bool use_fft,
+                bool use_tracking);
 
   MatchedFilter() = delete;
   MatchedFilter(const MatchedFilter&) = delete;
@@ -129,14 +146,33 @@ class MatchedFilter {
 
   ~MatchedFilter();
 
-  // Updates the correlation with the values in the capture buffer.
+  // Updates the correlation with the values in the capture buffer. When
+  // tracking is used and a reliable delay has been found, which is signaled by
+  // `use_slow_smoothing`, only the filters around the last detected lag are
+  // updated on every call while the other filters are updated round-robin at a
+  // low rate. When the FFT lag correlator is used and has found a stable
+  // candidate lag, only the filters around the candidate lag are updated. When
+  // both are used, the filters around the candidate lag replace the round-robin
+  // updates while tracking.
   void Update(const DownsampledRenderBuffer& render_buffer,
               rtc::ArrayView<const float> capture,
               bool use_slow_smoothing);
 
-  // Resets the matched filter.
+  // Resets the matched filter. A full reset also restarts the search over all
+  // filters when tracking is used.
   void Reset(bool full_reset);
 
+  // Enables or disables the tracking of the detected lag.
+  void SetTracking(bool use_tracking);
+
+  // Updates all filters for a while, as after a change of the echo path, before
+  // the tracking of the detected lag is resumed.
+  void RestartFullSearch();
+
+  // Returns the number of filters that were updated in the last call to
+  // Update().
+  int NumUpdatedFilters() const { return num_updated_filters_; }
+
   // Returns the current lag estimates.
   absl::optional<const MatchedFilter::LagEstimate> GetBestLagEstimate() const {
     return reported_lag_estimate_;
@@ -164,6 +200,16 @@ class MatchedFilter {
   }
   void Dump();
 
+  // Returns whether filter `n` is to be updated in the current call to
+  // Update().
+  bool IsUpdated(int n, int refresh_filter) const;
+  // Returns whether filter `n` is to be updated in the current call to Update()
+  // when tracking.
+  bool IsTracked(int n, int refresh_filter) const;
+  // Returns whether `candidate_lag` of the lag correlator is within the range
+  // of lags of filter `n`.
+  bool CoversCandidateLag(int n, size_t candidate_lag) const;
+
   ApmDataDumper* const data_dumper_;
   const Aec3Optimization optimization_;
   const size_t sub_block_size_;
@@ -182,7 +228,21 @@ class MatchedFilter {
   const float smoothing_slow_;
   const float matching_filter_threshold_;
   const bool detect_pre_echo_;
+  bool use_tracking_;
   const PreEchoConfiguration pre_echo_config_;
+  // Selects the filters to update, when `use_fft` is set.
+  std::unique_ptr<MatchedFilterFft> lag_correlator_;
+  // Whether all filters are updated regardless of the candidate lag of the lag
+  // correlator.
+  bool search_all_filters_ = false;
+  // Filter around which the filters are updated when tracking, or -1 when all
+  // filters are updated.
+  int tracked_filter_ = -1;
+  int num_updates_since_refresh_ = 0;
+  int next_refresh_filter_ = 0;
+  // Number of remaining calls to Update() during which no lag is tracked.
+  int num_full_search_updates_ = 0;
+  int num_updated_filters_ = 0;
 };
 
 }  // namespace webrtc
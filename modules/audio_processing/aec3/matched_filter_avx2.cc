@@ -81,14 +81,18 @@ void MatchedFilterCore_AccumulatedError_AVX2(
       s_inst_256_8 = _mm256_mul_ps(h_k_8, x_k_8);
       s_inst_hadd_256 = _mm256_hadd_ps(s_inst_256, s_inst_256_8);
       s_inst_hadd_256 = _mm256_hadd_ps(s_inst_hadd_256, s_inst_hadd_256);
-      s_acum += s_inst_hadd_256.m256_f32[0];
-      e_128.m128_f32[0] = s_acum - y[i];
-      s_acum += s_inst_hadd_256.m256_f32[4];
-      e_128.m128_f32[1] = s_acum - y[i];
-      s_acum += s_inst_hadd_256.m256_f32[1];
-      e_128.m128_f32[2] = s_acum - y[i];
-      s_acum += s_inst_hadd_256.m256_f32[5];
-      e_128.m128_f32[3] = s_acum - y[i];
+      alignas(32) float s_inst[8];
+      alignas(16) float e[4];
+      _mm256_store_ps(s_inst, s_inst_hadd_256);
+      s_acum += s_inst[0];
+      e[0] = s_acum - y[i];
+      s_acum += s_inst[4];
+      e[1] = s_acum - y[i];
+      s_acum += s_inst[1];
+      e[2] = s_acum - y[i];
+      s_acum += s_inst[5];
+      e[3] = s_acum - y[i];
+      e_128 = _mm_load_ps(e);
 
       __m128 accumulated_error = _mm_load_ps(a_p);
       accumulated_error = _mm_fmadd_ps(e_128, e_128, accumulated_error);
@@ -209,8 +213,8 @@ void MatchedFilterCore_AVX2(size_t x_start_index,
     x2_sum_256 = _mm256_add_ps(x2_sum_256, x2_sum_256_8);
     s_256 = _mm256_add_ps(s_256, s_256_8);
     __m128 sum = hsum_ab(x2_sum_256, s_256);
-    x2_sum += sum.m128_f32[0];
-    s += sum.m128_f32[1];
+    x2_sum += _mm_cvtss_f32(sum);
+    s += _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, 0x55));
 
     // Compute the matched filter error.
     float e = y[i] - s;
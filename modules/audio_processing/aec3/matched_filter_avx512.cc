@@ -0,0 +1,256 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "modules/audio_processing/aec3/matched_filter.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace aec3 {
+
+namespace {
+
+// Returns a mask that selects the `num_elements` first lanes.
+inline __mmask16 FirstLanes(int num_elements) {
+  return static_cast<__mmask16>((1u << num_elements) - 1u);
+}
+
+// Returns the horizontal sum of a.
+inline float HorizontalSum(__m512 a) {
+  const __m256 a_256 = _mm256_add_ps(
+      _mm512_castps512_ps256(a),
+      _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1)));
+  __m128 a_128 = _mm_add_ps(_mm256_castps256_ps128(a_256),
+                            _mm256_extractf128_ps(a_256, 1));
+  a_128 = _mm_add_ps(a_128, _mm_movehl_ps(a_128, a_128));
+  a_128 = _mm_add_ss(a_128, _mm_shuffle_ps(a_128, a_128, 0x55));
+  return _mm_cvtss_f32(a_128);
+}
+
+}  // namespace
+
+void MatchedFilterCore_AccumulatedError_AVX512(
+    size_t x_start_index,
+    float x2_sum_threshold,
+    float smoothing,
+    rtc::ArrayView<const float> x,
+    rtc::ArrayView<const float> y,
+    rtc::ArrayView<float> h,
+    bool* filters_updated,
+    float* error_sum,
+    rtc::ArrayView<float> accumulated_error,
+    rtc::ArrayView<float> scratch_memory) {
+  const int h_size = static_cast<int>(h.size());
+  const int x_size = static_cast<int>(x.size());
+  RTC_DCHECK_EQ(0, h_size % 16);
+  std::fill(accumulated_error.begin(), accumulated_error.end(), 0.0f);
+
+  // Process for all samples in the sub-block.
+  for (size_t i = 0; i < y.size(); ++i) {
+    // Apply the matched filter as filter * x, and compute x * x.
+    RTC_DCHECK_GT(x_size, x_start_index);
+    const int chunk1 =
+        std::min(h_size, static_cast<int>(x_size - x_start_index));
+    if (chunk1 != h_size) {
+      const int chunk2 = h_size - chunk1;
+      std::copy(x.begin() + x_start_index, x.end(), scratch_memory.begin());
+      std::copy(x.begin(), x.begin() + chunk2, scratch_memory.begin() + chunk1);
+    }
+    const float* x_p =
+        chunk1 != h_size ? scratch_memory.data() : &x[x_start_index];
+    const float* h_p = &h[0];
+    float* a_p = &accumulated_error[0];
+    __m512 x2_sum_512 = _mm512_setzero_ps();
+    float s_acum = 0;
+    const int limit_by_16 = h_size >> 4;
+    for (int k = limit_by_16; k > 0; --k, h_p += 16, x_p += 16, a_p += 4) {
+      const __m512 x_k = _mm512_loadu_ps(x_p);
+      const __m512 h_k = _mm512_loadu_ps(h_p);
+      x2_sum_512 = _mm512_fmadd_ps(x_k, x_k, x2_sum_512);
+      // Each 128 bit lane holds the products for one group of four filter
+      // taps. Sum the groups pairwise within the lanes, which matches the
+      // summation order of the AVX2 implementation.
+      const __m512 s_inst = _mm512_mul_ps(h_k, x_k);
+      __m512 s_group = _mm512_add_ps(
+          s_inst, _mm512_shuffle_ps(s_inst, s_inst, _MM_SHUFFLE(2, 3, 0, 1)));
+      s_group = _mm512_add_ps(
+          s_group,
+          _mm512_shuffle_ps(s_group, s_group, _MM_SHUFFLE(1, 0, 3, 2)));
+      alignas(64) float s_groups[16];
+      alignas(16) float e[4];
+      _mm512_store_ps(s_groups, s_group);
+      for (int g = 0; g < 4; ++g) {
+        s_acum += s_groups[4 * g];
+        e[g] = s_acum - y[i];
+      }
+      const __m128 e_128 = _mm_load_ps(e);
+
+      __m128 accumulated_error = _mm_loadu_ps(a_p);
+      accumulated_error = _mm_fmadd_ps(e_128, e_128, accumulated_error);
+      _mm_storeu_ps(a_p, accumulated_error);
+    }
+    const float x2_sum = HorizontalSum(x2_sum_512);
+
+    // Compute the matched filter error.
+    float e = y[i] - s_acum;
+    const bool saturation = y[i] >= 32000.f || y[i] <= -32000.f;
+    (*error_sum) += e * e;
+
+    // Update the matched filter estimate in an NLMS manner.
+    if (x2_sum > x2_sum_threshold && !saturation) {
+      RTC_DCHECK_LT(0.f, x2_sum);
+      const float alpha = smoothing * e / x2_sum;
+      const __m512 alpha_512 = _mm512_set1_ps(alpha);
+
+      // filter = filter + smoothing * (y - filter * x) * x / x * x.
+      float* h_p = &h[0];
+      const float* x_p =
+          chunk1 != h_size ? scratch_memory.data() : &x[x_start_index];
+      for (int k = limit_by_16; k > 0; --k, h_p += 16, x_p += 16) {
+        __m512 h_k = _mm512_loadu_ps(h_p);
+        const __m512 x_k = _mm512_loadu_ps(x_p);
+        // Compute h = h + alpha * x.
+        h_k = _mm512_fmadd_ps(x_k, alpha_512, h_k);
+        _mm512_storeu_ps(h_p, h_k);
+      }
+      *filters_updated = true;
+    }
+
+    x_start_index = x_start_index > 0 ? x_start_index - 1 : x_size - 1;
+  }
+}
+
+void MatchedFilterCore_AVX512(size_t x_start_index,
+                              float x2_sum_threshold,
+                              float smoothing,
+                              rtc::ArrayView<const float> x,
+                              rtc::ArrayView<const float> y,
+                              rtc::ArrayView<float> h,
+                              bool* filters_updated,
+                              float* error_sum,
+                              bool compute_accumulated_error,
+                              rtc::ArrayView<float> accumulated_error,
+                              rtc::ArrayView<float> scratch_memory) {
+  if (compute_accumulated_error) {
+    return MatchedFilterCore_AccumulatedError_AVX512(
+        x_start_index, x2_sum_threshold, smoothing, x, y, h, filters_updated,
+        error_sum, accumulated_error, scratch_memory);
+  }
+  const int h_size = static_cast<int>(h.size());
+  const int x_size = static_cast<int>(x.size());
+  RTC_DCHECK_EQ(0, h_size % 16);
+
+  // Process for all samples in the sub-block.
+  for (size_t i = 0; i < y.size(); ++i) {
+    // Apply the matched filter as filter * x, and compute x * x.
+
+    RTC_DCHECK_GT(x_size, x_start_index);
+    const float* x_p = &x[x_start_index];
+    const float* h_p = &h[0];
+
+    // Initialize values for the accumulation.
+    __m512 s_512 = _mm512_setzero_ps();
+    __m512 s_512_16 = _mm512_setzero_ps();
+    __m512 x2_sum_512 = _mm512_setzero_ps();
+    __m512 x2_sum_512_16 = _mm512_setzero_ps();
+
+    // Compute loop chunk sizes until, and after, the wraparound of the circular
+    // buffer for x.
+    const int chunk1 =
+        std::min(h_size, static_cast<int>(x_size - x_start_index));
+
+    // Perform the loop in two chunks.
+    const int chunk2 = h_size - chunk1;
+    for (int limit : {chunk1, chunk2}) {
+      // Perform 512 bit vector operations.
+      const int limit_by_32 = limit >> 5;
+      for (int k = limit_by_32; k > 0; --k, h_p += 32, x_p += 32) {
+        const __m512 x_k = _mm512_loadu_ps(x_p);
+        const __m512 h_k = _mm512_loadu_ps(h_p);
+        const __m512 x_k_16 = _mm512_loadu_ps(x_p + 16);
+        const __m512 h_k_16 = _mm512_loadu_ps(h_p + 16);
+        // Compute and accumulate x * x and h * x.
+        x2_sum_512 = _mm512_fmadd_ps(x_k, x_k, x2_sum_512);
+        x2_sum_512_16 = _mm512_fmadd_ps(x_k_16, x_k_16, x2_sum_512_16);
+        s_512 = _mm512_fmadd_ps(h_k, x_k, s_512);
+        s_512_16 = _mm512_fmadd_ps(h_k_16, x_k_16, s_512_16);
+      }
+
+      // Process the remaining items using masked vector operations.
+      for (int k = limit - limit_by_32 * 32; k > 0; k -= 16) {
+        const int num_elements = std::min(k, 16);
+        const __mmask16 mask = FirstLanes(num_elements);
+        const __m512 x_k = _mm512_maskz_loadu_ps(mask, x_p);
+        const __m512 h_k = _mm512_maskz_loadu_ps(mask, h_p);
+        x2_sum_512 = _mm512_fmadd_ps(x_k, x_k, x2_sum_512);
+        s_512 = _mm512_fmadd_ps(h_k, x_k, s_512);
+        h_p += num_elements;
+        x_p += num_elements;
+      }
+
+      x_p = &x[0];
+    }
+
+    // Sum components together.
+    const float x2_sum =
+        HorizontalSum(_mm512_add_ps(x2_sum_512, x2_sum_512_16));
+    const float s = HorizontalSum(_mm512_add_ps(s_512, s_512_16));
+
+    // Compute the matched filter error.
+    float e = y[i] - s;
+    const bool saturation = y[i] >= 32000.f || y[i] <= -32000.f;
+    (*error_sum) += e * e;
+
+    // Update the matched filter estimate in an NLMS manner.
+    if (x2_sum > x2_sum_threshold && !saturation) {
+      RTC_DCHECK_LT(0.f, x2_sum);
+      const float alpha = smoothing * e / x2_sum;
+      const __m512 alpha_512 = _mm512_set1_ps(alpha);
+
+      // filter = filter + smoothing * (y - filter * x) * x / x * x.
+      float* h_p = &h[0];
+      x_p = &x[x_start_index];
+
+      // Perform the loop in two chunks.
+      for (int limit : {chunk1, chunk2}) {
+        const int limit_by_16 = limit >> 4;
+        for (int k = limit_by_16; k > 0; --k, h_p += 16, x_p += 16) {
+          __m512 h_k = _mm512_loadu_ps(h_p);
+          const __m512 x_k = _mm512_loadu_ps(x_p);
+          // Compute h = h + alpha * x.
+          h_k = _mm512_fmadd_ps(x_k, alpha_512, h_k);
+          _mm512_storeu_ps(h_p, h_k);
+        }
+
+        // Process the remaining items using a masked vector operation.
+        const int num_remaining = limit - limit_by_16 * 16;
+        if (num_remaining > 0) {
+          const __mmask16 mask = FirstLanes(num_remaining);
+          __m512 h_k = _mm512_maskz_loadu_ps(mask, h_p);
+          const __m512 x_k = _mm512_maskz_loadu_ps(mask, x_p);
+          h_k = _mm512_fmadd_ps(x_k, alpha_512, h_k);
+          _mm512_mask_storeu_ps(h_p, mask, h_k);
+          h_p += num_remaining;
+          x_p += num_remaining;
+        }
+
+        x_p = &x[0];
+      }
+
+      *filters_updated = true;
+    }
+
+    x_start_index = x_start_index > 0 ? x_start_index - 1 : x_size - 1;
+  }
+}
+
+}  // namespace aec3
+}  // namespace webrtc
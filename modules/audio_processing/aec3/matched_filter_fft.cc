@@ -0,0 +1,246 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/matched_filter_fft.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "modules/audio_processing/aec3/downsampled_render_buffer.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// Smoothing factor of the recursive averaging of the spectra, applied once per
+// block.
+constexpr float kSmoothing = 0.7f;
+
+// Minimum ratio between the squared correlation at the peak and the average
+// squared correlation over all lags for the peak to be a candidate lag. For
+// uncorrelated signals, the ratio is about 2 * ln(max_lag).
+constexpr float kMinPeakToAverageRatio = 50.f;
+
+// Regularization of the spectral weighting.
+constexpr float kRegularization = 1.f;
+
+// Number of consecutive blocks in which the correlation peak has to be found at
+// the same lag, within one sub-block, for it to be a candidate lag.
+constexpr int kNumBlocksForStablePeak = 3;
+
+// Returns the number of capture samples per block, which is chosen to be about
+// half the lag range.
+size_t ComputeBlockSize(size_t sub_block_size, size_t max_lag) {
+  const size_t half_lag_range = (max_lag + 1) / 2;
+  const size_t num_sub_blocks = std::max<size_t>(
+      (half_lag_range + sub_block_size - 1) / sub_block_size, 1);
+  return num_sub_blocks * sub_block_size;
+}
+
+// Returns the smallest real FFT size supported by PFFFT that is at least
+// `min_size`.
+size_t ComputeFftSize(size_t min_size) {
+  size_t fft_size = 32;
+  while (fft_size < min_size ||
+         !Pffft::IsValidFftSize(fft_size, Pffft::FftType::kReal)) {
+    fft_size += 32;
+  }
+  return fft_size;
+}
+
+}  // namespace
+
+MatchedFilterFft::MatchedFilterFft(size_t sub_block_size,
+                                   size_t max_lag,
+                                   float excitation_limit)
+    : sub_block_size_(sub_block_size),
+      max_lag_(max_lag),
+      block_size_(ComputeBlockSize(sub_block_size, max_lag)),
+      fft_size_(ComputeFftSize(block_size_ + max_lag - 1)),
+      excitation_limit_(excitation_limit),
+      fft_(fft_size_, Pffft::FftType::kReal),
+      time_data_(fft_.CreateBuffer()),
+      capture_spectrum_(fft_.CreateBuffer()),
+      render_spectrum_(fft_.CreateBuffer()),
+      cross_spectrum_(fft_size_),
+      capture_power_(fft_size_ / 2 + 1),
+      render_power_(fft_size_ / 2 + 1),
+      render_history_(block_size_ + max_lag - 1),
+      capture_(block_size_) {
+  RTC_DCHECK_LT(0, sub_block_size);
+  RTC_DCHECK_LT(0, max_lag);
+  Reset();
+}
+
+MatchedFilterFft::~MatchedFilterFft() = default;
+
+void MatchedFilterFft::Reset() {
+  std::fill(cross_spectrum_.begin(), cross_spectrum_.end(), 0.f);
+  std::fill(capture_power_.begin(), capture_power_.end(), 0.f);
+  std::fill(render_power_.begin(), render_power_.end(), 0.f);
+  spectra_valid_ = false;
+  num_buffered_capture_samples_ = 0;
+  expected_read_ = -1;
+  peak_lag_ = absl::nullopt;
+  num_stable_peaks_ = 0;
+  candidate_lag_ = absl::nullopt;
+}
+
+void MatchedFilterFft::Update(const DownsampledRenderBuffer& render_buffer,
+                              rtc::ArrayView<const float> capture) {
+  RTC_DCHECK_EQ(sub_block_size_, capture.size());
+
+  // The render and capture data are only aligned as long as the render data is
+  // read one sub-block at a time. Restart the buffering otherwise.
+  const bool contiguous = render_buffer.read == expected_read_;
+  expected_read_ = render_buffer.OffsetIndex(
+      render_buffer.read, -static_cast<int>(sub_block_size_));
+  if (!contiguous) {
+    num_buffered_capture_samples_ = 0;
+  }
+  UpdateRenderHistory(render_buffer, /*full_copy=*/!contiguous);
+
+  std::copy(capture.begin(), capture.end(),
+            capture_.begin() + num_buffered_capture_samples_);
+  num_buffered_capture_samples_ += sub_block_size_;
+  if (num_buffered_capture_samples_ == block_size_) {
+    num_buffered_capture_samples_ = 0;
+    UpdateCorrelation();
+  }
+}
+
+void MatchedFilterFft::UpdateRenderHistory(
+    const DownsampledRenderBuffer& render_buffer,
+    bool full_copy) {
+  // As in the render buffer, the newest sample in the history is stored at the
+  // lowest index and the samples are inserted from the oldest to the newest.
+  const size_t history_size = render_history_.size();
+  size_t num_samples = sub_block_size_;
+  if (full_copy) {
+    std::fill(render_history_.begin(), render_history_.end(), 0.f);
+    num_samples = std::min(render_buffer.buffer.size(), history_size);
+  }
+  for (size_t k = num_samples; k > 0; --k) {
+    render_history_newest_ =
+        render_history_newest_ > 0 ? render_history_newest_ - 1
+                                   : history_size - 1;
+    render_history_[render_history_newest_] =
+        render_buffer.buffer[render_buffer.OffsetIndex(
+            render_buffer.read, static_cast<int>(k - 1))];
+  }
+}
+
+void MatchedFilterFft::UpdateCorrelation() {
+  // Only use blocks with render excitation, as the correlation is otherwise
+  // dominated by noise.
+  const size_t history_size = render_history_.size();
+  float x2_sum = 0.f;
+  for (float x_k : render_history_) {
+    x2_sum += x_k * x_k;
+  }
+  if (x2_sum < history_size * excitation_limit_ * excitation_limit_) {
+    return;
+  }
+
+  // The correlation between the capture block y and the render data x at lag
+  // l is sum_i y[i] * x[i - l]. With the capture block in chronological order
+  // and the render data ordered from the newest sample, it is the linear
+  // convolution of the two at index block_size_ - 1 + l. The FFT size is large
+  // enough for this part of the convolution not to be affected by the circular
+  // wrap-around.
+  rtc::ArrayView<float> time_data = time_data_->GetView();
+  std::copy(capture_.begin(), capture_.end(), time_data.begin());
+  std::fill(time_data.begin() + block_size_, time_data.end(), 0.f);
+  fft_.ForwardTransform(*time_data_, capture_spectrum_.get(),
+                        /*ordered=*/true);
+
+  auto render_newest = render_history_.begin() + render_history_newest_;
+  std::copy(render_newest, render_history_.end(), time_data.begin());
+  std::copy(render_history_.begin(), render_newest,
+            time_data.begin() + (render_history_.end() - render_newest));
+  std::fill(time_data.begin() + history_size, time_data.end(), 0.f);
+  fft_.ForwardTransform(*time_data_, render_spectrum_.get(),
+                        /*ordered=*/true);
+
+  // Smooth the spectra and weight the cross-spectrum by the inverse of the
+  // square root of the product of the power spectra. The weighted
+  // cross-spectrum replaces the capture spectrum. In the ordered layout, the
+  // real-valued DC and Nyquist bins are stored first, followed by the other
+  // bins as interleaved real and imaginary parts.
+  const float smoothing = spectra_valid_ ? kSmoothing : 0.f;
+  spectra_valid_ = true;
+  rtc::ArrayView<float> Y = capture_spectrum_->GetView();
+  rtc::ArrayView<const float> X = render_spectrum_->GetConstView();
+  const size_t num_bins = fft_size_ / 2;
+  for (size_t j = 0; j < 2; ++j) {
+    const size_t k = j == 0 ? 0 : num_bins;
+    cross_spectrum_[j] =
+        smoothing * cross_spectrum_[j] + (1.f - smoothing) * Y[j] * X[j];
+    capture_power_[k] =
+        smoothing * capture_power_[k] + (1.f - smoothing) * Y[j] * Y[j];
+    render_power_[k] =
+        smoothing * render_power_[k] + (1.f - smoothing) * X[j] * X[j];
+    Y[j] = cross_spectrum_[j] /
+           (std::sqrt(capture_power_[k] * render_power_[k]) + kRegularization);
+  }
+  for (size_t k = 1, j = 2; k < num_bins; ++k, j += 2) {
+    const float y_re = Y[j];
+    const float y_im = Y[j + 1];
+    const float x_re = X[j];
+    const float x_im = X[j + 1];
+    cross_spectrum_[j] = smoothing * cross_spectrum_[j] +
+                         (1.f - smoothing) * (y_re * x_re - y_im * x_im);
+    cross_spectrum_[j + 1] = smoothing * cross_spectrum_[j + 1] +
+                             (1.f - smoothing) * (y_re * x_im + y_im * x_re);
+    capture_power_[k] = smoothing * capture_power_[k] +
+                        (1.f - smoothing) * (y_re * y_re + y_im * y_im);
+    render_power_[k] = smoothing * render_power_[k] +
+                       (1.f - smoothing) * (x_re * x_re + x_im * x_im);
+    const float weight =
+        1.f /
+        (std::sqrt(capture_power_[k] * render_power_[k]) + kRegularization);
+    Y[j] = weight * cross_spectrum_[j];
+    Y[j + 1] = weight * cross_spectrum_[j + 1];
+  }
+  fft_.BackwardTransform(*capture_spectrum_, time_data_.get(),
+                         /*ordered=*/true);
+
+  // Find the correlation peak.
+  rtc::ArrayView<const float> r(&time_data[block_size_ - 1], max_lag_);
+  float r2_sum = 0.f;
+  float r2_max = 0.f;
+  size_t peak_lag = 0;
+  for (size_t l = 0; l < r.size(); ++l) {
+    const float r2 = r[l] * r[l];
+    r2_sum += r2;
+    if (r2 > r2_max) {
+      r2_max = r2;
+      peak_lag = l;
+    }
+  }
+  if (r2_max * max_lag_ <= kMinPeakToAverageRatio * r2_sum) {
+    peak_lag_ = absl::nullopt;
+    num_stable_peaks_ = 0;
+  } else {
+    const bool same_lag =
+        peak_lag_ &&
+        std::max(peak_lag, *peak_lag_) - std::min(peak_lag, *peak_lag_) <=
+            sub_block_size_;
+    num_stable_peaks_ = same_lag ? num_stable_peaks_ + 1 : 1;
+    peak_lag_ = peak_lag;
+  }
+  candidate_lag_ = absl::nullopt;
+  if (num_stable_peaks_ >= kNumBlocksForStablePeak) {
+    candidate_lag_ = peak_lag_;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_MATCHED_FILTER_FFT_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_MATCHED_FILTER_FFT_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/array_view.h"
+#include "modules/audio_processing/utility/pffft_wrapper.h"
+
+namespace webrtc {
+
+struct DownsampledRenderBuffer;
+
+// Frequency-domain cross-correlation of the down-sampled capture signal with
+// the down-sampled render signal over the full lag range of the matched
+// filters. It is used by MatchedFilter to select which matched filters to
+// update, so that the matched filter cost does not grow with the number of
+// filters.
+//
+// The capture signal is gathered in blocks of about half the lag range. For
+// each block, one real FFT of the block and one of the render data covering all
+// lags are computed, and the recursively smoothed cross-spectrum is weighted by
+// the smoothed auto-spectra (SCOT) before it is transformed back. As both the
+// block length and the FFT length are proportional to the lag range, the cost
+// per sample grows with the logarithm of the lag range.
+class MatchedFilterFft {
+ public:
+  // Creates a correlator for the lags [0, `max_lag`), counted in down-sampled
+  // samples. The render data of a block is only used when its average power is
+  // above `excitation_limit`^2.
+  MatchedFilterFft(size_t sub_block_size,
+                   size_t max_lag,
+                   float excitation_limit);
+
+  MatchedFilterFft() = delete;
+  MatchedFilterFft(const MatchedFilterFft&) = delete;
+  MatchedFilterFft& operator=(const MatchedFilterFft&) = delete;
+
+  ~MatchedFilterFft();
+
+  // Resets the correlation and the buffered data.
+  void Reset();
+
+  // Buffers a sub-block of capture data together with the render data at the
+  // read index of `render_buffer`. The correlation is updated whenever a full
+  // block of capture data has been buffered.
+  void Update(const DownsampledRenderBuffer& render_buffer,
+              rtc::ArrayView<const float> capture);
+
+  // Returns the lag of the correlation peak, if it is clearly above the
+  // correlation at the other lags and has been found at about the same lag for
+  // the last few blocks.
+  absl::optional<size_t> candidate_lag() const { return candidate_lag_; }
+
+  // Returns the number of capture samples per update of the correlation.
+  size_t block_size() const { return block_size_; }
+
+ private:
+  // Copies the render samples at the read index of `render_buffer` to the
+  // render history. All the data in the render buffer is copied when
+  // `full_copy` is true.
+  void UpdateRenderHistory(const DownsampledRenderBuffer& render_buffer,
+                           bool full_copy);
+  // Updates the correlation using the latest block of capture data.
+  void UpdateCorrelation();
+
+  const size_t sub_block_size_;
+  const size_t max_lag_;
+  const size_t block_size_;
+  const size_t fft_size_;
+  const float excitation_limit_;
+  Pffft fft_;
+  std::unique_ptr<Pffft::FloatBuffer> time_data_;
+  std::unique_ptr<Pffft::FloatBuffer> capture_spectrum_;
+  std::unique_ptr<Pffft::FloatBuffer> render_spectrum_;
+  // Smoothed cross-spectrum, in the ordered PFFFT layout, and smoothed power
+  // spectra of the capture and render data.
+  std::vector<float> cross_spectrum_;
+  std::vector<float> capture_power_;
+  std::vector<float> render_power_;
+  bool spectra_valid_ = false;
+  // Circular buffer of the latest render samples covering all lags for a
+  // block of capture data.
+  std::vector<float> render_history_;
+  size_t render_history_newest_ = 0;
+  std::vector<float> capture_;
+  size_t num_buffered_capture_samples_ = 0;
+  int expected_read_ = -1;
+  absl::optional<size_t> peak_lag_;
+  int num_stable_peaks_ = 0;
+  absl::optional<size_t> candidate_lag_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_MATCHED_FILTER_FFT_H_
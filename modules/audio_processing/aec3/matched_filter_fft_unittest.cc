@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/matched_filter_fft.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "modules/audio_processing/aec3/downsampled_render_buffer.h"
+#include "modules/audio_processing/test/echo_canceller_test_tools.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kSubBlockSize = 16;
+constexpr size_t kMaxLag = 1000;
+constexpr float kExcitationLimit = 150.f;
+constexpr size_t kNumBlocksForStablePeak = 3;
+
+// Inserts a render sub-block into the buffer in the same way as the render
+// delay buffer does, with the read index pointing to the newest data. The
+// render signal is lowpass filtered if `lowpass_state` is non-null.
+void InsertRenderSubBlock(Random* random_generator,
+                          float* lowpass_state,
+                          DownsampledRenderBuffer* render_buffer) {
+  std::vector<float> x(kSubBlockSize);
+  RandomizeSampleVector(random_generator, x);
+  if (lowpass_state) {
+    for (float& x_k : x) {
+      *lowpass_state = 0.9f * *lowpass_state + 0.1f * x_k;
+      x_k = *lowpass_state;
+    }
+  }
+  render_buffer->UpdateWriteIndex(-static_cast<int>(kSubBlockSize));
+  std::copy(x.rbegin(), x.rend(),
+            render_buffer->buffer.begin() + render_buffer->write);
+  render_buffer->read = render_buffer->write;
+}
+
+// Produces a capture sub-block that is a scaled and delayed version of the
+// latest render sub-block.
+void ProduceCaptureSubBlock(const DownsampledRenderBuffer& render_buffer,
+                            int delay,
+                            rtc::ArrayView<float> y) {
+  for (size_t j = 0; j < y.size(); ++j) {
+    y[j] = 0.8f * render_buffer.buffer[render_buffer.OffsetIndex(
+                      render_buffer.read,
+                      static_cast<int>(y.size() - 1 - j) + delay)];
+  }
+}
+
+}  // namespace
+
+// Verifies that the correlation is updated about every half lag range.
+TEST(MatchedFilterFft, BlockSize) {
+  EXPECT_EQ(512u, MatchedFilterFft(16, 1000, kExcitationLimit).block_size());
+  EXPECT_EQ(16u, MatchedFilterFft(16, 20, kExcitationLimit).block_size());
+  EXPECT_EQ(2048u, MatchedFilterFft(8, 4096, kExcitationLimit).block_size());
+}
+
+// Verifies that the candidate lag is the delay of the capture signal, for white
+// as well as for strongly colored render signals, and that it follows a change
+// of the delay.
+TEST(MatchedFilterFft, FindsDelay) {
+  for (bool colored_render : {false, true}) {
+    SCOPED_TRACE(colored_render ? "Colored render" : "White render");
+    Random random_generator(42U);
+    float lowpass_state = 0.f;
+    DownsampledRenderBuffer render_buffer(kSubBlockSize * 200);
+    MatchedFilterFft correlator(kSubBlockSize, kMaxLag, kExcitationLimit);
+    std::vector<float> y(kSubBlockSize);
+    for (int delay : {0, 150, 700, static_cast<int>(kMaxLag) - 1}) {
+      SCOPED_TRACE(delay);
+      for (size_t k = 0; k < 8 * correlator.block_size() / kSubBlockSize;
+           ++k) {
+        InsertRenderSubBlock(&random_generator,
+                             colored_render ? &lowpass_state : nullptr,
+                             &render_buffer);
+        ProduceCaptureSubBlock(render_buffer, delay, y);
+        correlator.Update(render_buffer, y);
+      }
+      ASSERT_TRUE(correlator.candidate_lag().has_value());
+      EXPECT_EQ(static_cast<size_t>(delay), *correlator.candidate_lag());
+    }
+  }
+}
+
+// Verifies that there is no candidate lag when the capture signal is not
+// correlated with the render signal, or when there is no render signal.
+TEST(MatchedFilterFft, NoCandidateWithoutCorrelation) {
+  Random random_generator(42U);
+  DownsampledRenderBuffer render_buffer(kSubBlockSize * 200);
+  MatchedFilterFft correlator(kSubBlockSize, kMaxLag, kExcitationLimit);
+  std::vector<float> y(kSubBlockSize);
+  for (size_t k = 0; k < 8 * correlator.block_size() / kSubBlockSize; ++k) {
+    InsertRenderSubBlock(&random_generator, nullptr, &render_buffer);
+    RandomizeSampleVector(&random_generator, y);
+    correlator.Update(render_buffer, y);
+  }
+  EXPECT_FALSE(correlator.candidate_lag().has_value());
+
+  DownsampledRenderBuffer silent_render_buffer(kSubBlockSize * 200);
+  for (size_t k = 0; k < 8 * correlator.block_size() / kSubBlockSize; ++k) {
+    silent_render_buffer.UpdateReadIndex(-static_cast<int>(kSubBlockSize));
+    RandomizeSampleVector(&random_generator, y);
+    correlator.Update(silent_render_buffer, y);
+  }
+  EXPECT_FALSE(correlator.candidate_lag().has_value());
+}
+
+// Verifies that the candidate lag is only produced once the correlation peak
+// has been found at the same lag in a few full blocks, that the buffering
+// restarts when the render data is not read contiguously, and that a reset
+// removes the candidate lag.
+TEST(MatchedFilterFft, BuffersFullBlocks) {
+  constexpr int kDelay = 300;
+  Random random_generator(42U);
+  DownsampledRenderBuffer render_buffer(kSubBlockSize * 200);
+  MatchedFilterFft correlator(kSubBlockSize, kMaxLag, kExcitationLimit);
+  const size_t num_sub_blocks_per_block =
+      correlator.block_size() / kSubBlockSize;
+  std::vector<float> y(kSubBlockSize);
+  auto update = [&]() {
+    InsertRenderSubBlock(&random_generator, nullptr, &render_buffer);
+    ProduceCaptureSubBlock(render_buffer, kDelay, y);
+    correlator.Update(render_buffer, y);
+  };
+
+  for (size_t k = 0; k < num_sub_blocks_per_block - 1; ++k) {
+    update();
+    EXPECT_FALSE(correlator.candidate_lag().has_value());
+  }
+  // Skip one sub-block of render data, which restarts the buffering.
+  InsertRenderSubBlock(&random_generator, nullptr, &render_buffer);
+  for (size_t k = 0;
+       k < kNumBlocksForStablePeak * num_sub_blocks_per_block - 1; ++k) {
+    update();
+    EXPECT_FALSE(correlator.candidate_lag().has_value());
+  }
+  update();
+  ASSERT_TRUE(correlator.candidate_lag().has_value());
+  EXPECT_EQ(static_cast<size_t>(kDelay), *correlator.candidate_lag());
+
+  correlator.Reset();
+  EXPECT_FALSE(correlator.candidate_lag().has_value());
+}
+
+}  // namespace webrtc
@@ -219,6 +219,59 @@ TEST_P(MatchedFilterTest, TestAvx2Optimizations) {
   }
 }
 
+TEST_P(MatchedFilterTest, TestAvx512Optimizations) {
+  bool use_avx512 = (GetCPUInfo(kAVX512) != 0);
+  const bool kComputeAccumulatederror = GetParam();
+  if (use_avx512) {
+    Random random_generator(42U);
+    constexpr float kSmoothing = 0.7f;
+    for (auto down_sampling_factor : kDownSamplingFactors) {
+      const size_t sub_block_size = kBlockSize / down_sampling_factor;
+      std::vector<float> x(2000);
+      RandomizeSampleVector(&random_generator, x);
+      std::vector<float> y(sub_block_size);
+      std::vector<float> h_AVX2(512);
+      std::vector<float> h_AVX512(512);
+      std::vector<float> accumulated_error_AVX2(512 / 4);
+      std::vector<float> accumulated_error_AVX512(512 / 4);
+      std::vector<float> scratch_memory(512);
+      int x_index = 0;
+      for (int k = 0; k < 1000; ++k) {
+        RandomizeSampleVector(&random_generator, y);
+        bool filters_updated_AVX2 = false;
+        float error_sum_AVX2 = 0.f;
+        bool filters_updated_AVX512 = false;
+        float error_sum_AVX512 = 0.f;
+        MatchedFilterCore_AVX512(x_index, h_AVX2.size() * 150.f * 150.f,
+                                 kSmoothing, x, y, h_AVX512,
+                                 &filters_updated_AVX512, &error_sum_AVX512,
+                                 kComputeAccumulatederror,
+                                 accumulated_error_AVX512, scratch_memory);
+        MatchedFilterCore_AVX2(x_index, h_AVX2.size() * 150.f * 150.f,
+                               kSmoothing, x, y, h_AVX2, &filters_updated_AVX2,
+                               &error_sum_AVX2, kComputeAccumulatederror,
+                               accumulated_error_AVX2, scratch_memory);
+        EXPECT_EQ(filters_updated_AVX2, filters_updated_AVX512);
+        EXPECT_NEAR(error_sum_AVX2, error_sum_AVX512,
+                    error_sum_AVX2 / 100000.f);
+        for (size_t j = 0; j < h_AVX2.size(); ++j) {
+          EXPECT_NEAR(h_AVX2[j], h_AVX512[j], 0.00001f);
+        }
+        for (size_t j = 0; j < accumulated_error_AVX2.size(); j += 4) {
+          float difference = std::abs(accumulated_error_AVX2[j] -
+                                      accumulated_error_AVX512[j]);
+          float relative_difference =
+              accumulated_error_AVX2[j] > 0
+                  ? difference / accumulated_error_AVX2[j]
+                  : difference;
+          EXPECT_NEAR(relative_difference, 0.0f, 0.00001f);
+        }
+        x_index = (x_index + sub_block_size) % x.size();
+      }
+    }
+  }
+}
+
 #endif
 
 // Verifies that the (optimized) function MaxSquarePeakIndex() produces output
@@ -252,144 +305,381 @@ TEST_P(MatchedFilterTest, LagEstimation) {
   constexpr int kSampleRateHz = 48000;
   constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
 
+  for (bool use_fft : {false, true}) {
+    for (auto down_sampling_factor : kDownSamplingFactors) {
+      const size_t sub_block_size = kBlockSize / down_sampling_factor;
+
+      Block render(kNumBands, kNumChannels);
+      std::vector<std::vector<float>> capture(
+          1, std::vector<float>(kBlockSize, 0.f));
+      ApmDataDumper data_dumper(0);
+      for (size_t delay_samples : {5, 64, 150, 200, 800, 1000}) {
+        SCOPED_TRACE(ProduceDebugText(delay_samples, down_sampling_factor));
+        EchoCanceller3Config config;
+        config.delay.down_sampling_factor = down_sampling_factor;
+        config.delay.num_filters = kNumMatchedFilters;
+        Decimator capture_decimator(down_sampling_factor);
+        DelayBuffer<float> signal_delay_buffer(down_sampling_factor *
+                                               delay_samples);
+        MatchedFilter filter(
+            &data_dumper, DetectOptimization(), sub_block_size,
+            kWindowSizeSubBlocks, kNumMatchedFilters, kAlignmentShiftSubBlocks,
+            150, config.delay.delay_estimate_smoothing,
+            config.delay.delay_estimate_smoothing_delay_found,
+            config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+            use_fft, /*use_tracking=*/false);
+
+        std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+            RenderDelayBuffer::Create(config, kSampleRateHz, kNumChannels));
+
+        // Analyze the correlation between render and capture.
+        for (size_t k = 0; k < (600 + delay_samples / sub_block_size); ++k) {
+          for (size_t band = 0; band < kNumBands; ++band) {
+            for (size_t channel = 0; channel < kNumChannels; ++channel) {
+              RandomizeSampleVector(&random_generator,
+                                    render.View(band, channel));
+            }
+          }
+          signal_delay_buffer.Delay(render.View(/*band=*/0, /*channel=*/0),
+                                    capture[0]);
+          render_delay_buffer->Insert(render);
+
+          if (k == 0) {
+            render_delay_buffer->Reset();
+          }
+
+          render_delay_buffer->PrepareCaptureProcessing();
+          std::array<float, kBlockSize> downsampled_capture_data;
+          rtc::ArrayView<float> downsampled_capture(
+              downsampled_capture_data.data(), sub_block_size);
+          capture_decimator.Decimate(capture[0], downsampled_capture);
+          filter.Update(render_delay_buffer->GetDownsampledRenderBuffer(),
+                        downsampled_capture, /*use_slow_smoothing=*/false);
+        }
+
+        // Obtain the lag estimates.
+        auto lag_estimate = filter.GetBestLagEstimate();
+        EXPECT_TRUE(lag_estimate.has_value());
+
+        // Verify that the expected most accurate lag estimate is correct.
+        if (lag_estimate.has_value()) {
+          EXPECT_EQ(delay_samples, lag_estimate->lag);
+          EXPECT_EQ(delay_samples, lag_estimate->pre_echo_lag);
+        }
+      }
+    }
+  }
+}
+
+// Verifies that the lag estimate converges as fast with the FFT lag correlator
+// as without it. Initially, all filters are updated until the correlator has
+// a stable candidate lag, so the lag estimates are identical. After a change of
+// the delay, the filters around the new delay have not been updated while the
+// correlator had a candidate lag at the old delay, so the lag estimate may
+// converge slightly faster or slower.
+TEST_P(MatchedFilterTest, LagEstimateConvergenceWithFft) {
+  const bool kDetectPreEcho = GetParam();
+  constexpr size_t kNumChannels = 1;
+  constexpr int kSampleRateHz = 48000;
+  constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
+  constexpr size_t kDelays[] = {150, 1200};
+  // Long enough for the lag correlator to find a stable candidate lag.
+  constexpr size_t kNumBlocksPerDelay = 1000;
+  constexpr size_t kMaxNumExtraBlocksAfterDelayChange = 25;
+
   for (auto down_sampling_factor : kDownSamplingFactors) {
+    SCOPED_TRACE(down_sampling_factor);
     const size_t sub_block_size = kBlockSize / down_sampling_factor;
-
-    Block render(kNumBands, kNumChannels);
-    std::vector<std::vector<float>> capture(
-        1, std::vector<float>(kBlockSize, 0.f));
-    ApmDataDumper data_dumper(0);
-    for (size_t delay_samples : {5, 64, 150, 200, 800, 1000}) {
-      SCOPED_TRACE(ProduceDebugText(delay_samples, down_sampling_factor));
+    // Number of blocks until the lag estimate is correct, for each delay, with
+    // and without the FFT lag correlator.
+    size_t num_blocks_to_converge[2][2];
+    for (bool use_fft : {false, true}) {
+      Random random_generator(42U);
+      Block render(kNumBands, kNumChannels);
+      std::vector<float> capture(kBlockSize, 0.f);
+      ApmDataDumper data_dumper(0);
       EchoCanceller3Config config;
       config.delay.down_sampling_factor = down_sampling_factor;
       config.delay.num_filters = kNumMatchedFilters;
       Decimator capture_decimator(down_sampling_factor);
-      DelayBuffer<float> signal_delay_buffer(down_sampling_factor *
-                                             delay_samples);
       MatchedFilter filter(
           &data_dumper, DetectOptimization(), sub_block_size,
           kWindowSizeSubBlocks, kNumMatchedFilters, kAlignmentShiftSubBlocks,
           150, config.delay.delay_estimate_smoothing,
           config.delay.delay_estimate_smoothing_delay_found,
-          config.delay.delay_candidate_detection_threshold, kDetectPreEcho);
-
+          config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+          use_fft, /*use_tracking=*/false);
       std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
           RenderDelayBuffer::Create(config, kSampleRateHz, kNumChannels));
 
-      // Analyze the correlation between render and capture.
-      for (size_t k = 0; k < (600 + delay_samples / sub_block_size); ++k) {
-        for (size_t band = 0; band < kNumBands; ++band) {
-          for (size_t channel = 0; channel < kNumChannels; ++channel) {
-            RandomizeSampleVector(&random_generator,
-                                  render.View(band, channel));
+      bool first_block = true;
+      for (size_t d = 0; d < 2; ++d) {
+        DelayBuffer<float> signal_delay_buffer(down_sampling_factor *
+                                               kDelays[d]);
+        num_blocks_to_converge[use_fft][d] = kNumBlocksPerDelay;
+        for (size_t k = 0; k < kNumBlocksPerDelay; ++k) {
+          RandomizeSampleVector(&random_generator,
+                                render.View(/*band=*/0, /*channel=*/0));
+          signal_delay_buffer.Delay(render.View(/*band=*/0, /*channel=*/0),
+                                    capture);
+          render_delay_buffer->Insert(render);
+          if (first_block) {
+            render_delay_buffer->Reset();
+            first_block = false;
+          }
+          render_delay_buffer->PrepareCaptureProcessing();
+          std::array<float, kBlockSize> downsampled_capture_data;
+          rtc::ArrayView<float> downsampled_capture(
+              downsampled_capture_data.data(), sub_block_size);
+          capture_decimator.Decimate(capture, downsampled_capture);
+          filter.Update(render_delay_buffer->GetDownsampledRenderBuffer(),
+                        downsampled_capture, /*use_slow_smoothing=*/false);
+
+          auto lag_estimate = filter.GetBestLagEstimate();
+          if (lag_estimate && lag_estimate->lag == kDelays[d] &&
+              num_blocks_to_converge[use_fft][d] == kNumBlocksPerDelay) {
+            num_blocks_to_converge[use_fft][d] = k;
           }
         }
+        ASSERT_LT(num_blocks_to_converge[use_fft][d], kNumBlocksPerDelay);
+      }
+    }
+    EXPECT_EQ(num_blocks_to_converge[false][0],
+              num_blocks_to_converge[true][0]);
+    EXPECT_LE(num_blocks_to_converge[true][1],
+              num_blocks_to_converge[false][1] +
+                  kMaxNumExtraBlocksAfterDelayChange);
+  }
+}
+
+// Verifies that the matched filter in tracking mode finds the lag of the
+// echo while only updating a few filters, that it detects a change of the delay
+// to a lag covered by a filter that is not tracked, and that a restart of the
+// full search updates all filters.
+TEST_P(MatchedFilterTest, LagEstimationWithTracking) {
+  const bool kDetectPreEcho = GetParam();
+  Random random_generator(42U);
+  constexpr size_t kNumChannels = 1;
+  constexpr int kSampleRateHz = 48000;
+  constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
+  constexpr size_t kDownSamplingFactor = 4;
+  constexpr size_t kSubBlockSize = kBlockSize / kDownSamplingFactor;
+
+  for (bool use_fft : {false, true}) {
+    SCOPED_TRACE(use_fft);
+    Block render(kNumBands, kNumChannels);
+    std::vector<float> capture(kBlockSize, 0.f);
+    ApmDataDumper data_dumper(0);
+    EchoCanceller3Config config;
+    config.delay.down_sampling_factor = kDownSamplingFactor;
+    config.delay.num_filters = kNumMatchedFilters;
+    Decimator capture_decimator(kDownSamplingFactor);
+    MatchedFilter filter(
+        &data_dumper, DetectOptimization(), kSubBlockSize, kWindowSizeSubBlocks,
+        kNumMatchedFilters, kAlignmentShiftSubBlocks, 150,
+        config.delay.delay_estimate_smoothing,
+        config.delay.delay_estimate_smoothing_delay_found,
+        config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+        use_fft, /*use_tracking=*/true);
+    std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+        RenderDelayBuffer::Create(config, kSampleRateHz, kNumChannels));
+
+    bool first_block = true;
+    for (size_t delay_samples : {150, 2000}) {
+      SCOPED_TRACE(delay_samples);
+      DelayBuffer<float> signal_delay_buffer(kDownSamplingFactor *
+                                             delay_samples);
+      for (size_t k = 0; k < 3000; ++k) {
+        RandomizeSampleVector(&random_generator,
+                              render.View(/*band=*/0, /*channel=*/0));
         signal_delay_buffer.Delay(render.View(/*band=*/0, /*channel=*/0),
-                                  capture[0]);
+                                  capture);
         render_delay_buffer->Insert(render);
-
-        if (k == 0) {
+        if (first_block) {
           render_delay_buffer->Reset();
+          first_block = false;
         }
 
         render_delay_buffer->PrepareCaptureProcessing();
         std::array<float, kBlockSize> downsampled_capture_data;
         rtc::ArrayView<float> downsampled_capture(
-            downsampled_capture_data.data(), sub_block_size);
-        capture_decimator.Decimate(capture[0], downsampled_capture);
+            downsampled_capture_data.data(), kSubBlockSize);
+        capture_decimator.Decimate(capture, downsampled_capture);
         filter.Update(render_delay_buffer->GetDownsampledRenderBuffer(),
-                      downsampled_capture, /*use_slow_smoothing=*/false);
+                      downsampled_capture, /*use_slow_smoothing=*/true);
       }
 
-      // Obtain the lag estimates.
       auto lag_estimate = filter.GetBestLagEstimate();
-      EXPECT_TRUE(lag_estimate.has_value());
-
-      // Verify that the expected most accurate lag estimate is correct.
-      if (lag_estimate.has_value()) {
-        EXPECT_EQ(delay_samples, lag_estimate->lag);
-        EXPECT_EQ(delay_samples, lag_estimate->pre_echo_lag);
-      }
+      ASSERT_TRUE(lag_estimate.has_value());
+      EXPECT_EQ(delay_samples, lag_estimate->lag);
+      // At most the tracked filter, its neighbors and one round-robin filter,
+      // or the tracked filter and the filters around the candidate lag of the
+      // lag correlator, are updated.
+      EXPECT_LE(filter.NumUpdatedFilters(), 4);
     }
+
+    // All filters are updated when the full search is restarted.
+    filter.RestartFullSearch();
+    render_delay_buffer->Insert(render);
+    render_delay_buffer->PrepareCaptureProcessing();
+    std::array<float, kBlockSize> downsampled_capture_data;
+    rtc::ArrayView<float> downsampled_capture(downsampled_capture_data.data(),
+                                              kSubBlockSize);
+    capture_decimator.Decimate(capture, downsampled_capture);
+    filter.Update(render_delay_buffer->GetDownsampledRenderBuffer(),
+                  downsampled_capture, /*use_slow_smoothing=*/true);
+    EXPECT_EQ(static_cast<int>(kNumMatchedFilters), filter.NumUpdatedFilters());
   }
 }
 
-// Test the pre echo estimation.
-TEST_P(MatchedFilterTest, PreEchoEstimation) {
+// Verifies that enabling the tracking, as done by the reduced delay estimation
+// compute tier, reduces the number of updated filters also when the lag
+// correlator is used and the capture signal stops matching the render signal.
+TEST_P(MatchedFilterTest, TrackingReducesUpdatesWithLagCorrelator) {
   const bool kDetectPreEcho = GetParam();
-  Random random_generator(42U);
   constexpr size_t kNumChannels = 1;
   constexpr int kSampleRateHz = 48000;
   constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
+  constexpr size_t kDownSamplingFactor = 4;
+  constexpr size_t kSubBlockSize = kBlockSize / kDownSamplingFactor;
+  constexpr size_t kDelaySamples = 150;
 
-  for (auto down_sampling_factor : kDownSamplingFactors) {
-    const size_t sub_block_size = kBlockSize / down_sampling_factor;
-
+  int num_updated_filters[2] = {0, 0};
+  for (bool use_tracking : {false, true}) {
+    SCOPED_TRACE(use_tracking);
+    Random random_generator(42U);
     Block render(kNumBands, kNumChannels);
-    std::vector<std::vector<float>> capture(
-        1, std::vector<float>(kBlockSize, 0.f));
-    std::vector<float> capture_with_pre_echo(kBlockSize, 0.f);
+    std::vector<float> capture(kBlockSize, 0.f);
     ApmDataDumper data_dumper(0);
-    // data_dumper.SetActivated(true);
-    size_t pre_echo_delay_samples = 20e-3 * 16000 / down_sampling_factor;
-    size_t echo_delay_samples = 50e-3 * 16000 / down_sampling_factor;
     EchoCanceller3Config config;
-    config.delay.down_sampling_factor = down_sampling_factor;
+    config.delay.down_sampling_factor = kDownSamplingFactor;
     config.delay.num_filters = kNumMatchedFilters;
-    Decimator capture_decimator(down_sampling_factor);
-    DelayBuffer<float> signal_echo_delay_buffer(down_sampling_factor *
-                                                echo_delay_samples);
-    DelayBuffer<float> signal_pre_echo_delay_buffer(down_sampling_factor *
-                                                    pre_echo_delay_samples);
+    Decimator capture_decimator(kDownSamplingFactor);
     MatchedFilter filter(
-        &data_dumper, DetectOptimization(), sub_block_size,
-        kWindowSizeSubBlocks, kNumMatchedFilters, kAlignmentShiftSubBlocks, 150,
+        &data_dumper, DetectOptimization(), kSubBlockSize, kWindowSizeSubBlocks,
+        kNumMatchedFilters, kAlignmentShiftSubBlocks, 150,
         config.delay.delay_estimate_smoothing,
         config.delay.delay_estimate_smoothing_delay_found,
-        config.delay.delay_candidate_detection_threshold, kDetectPreEcho);
+        config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+        /*use_fft=*/true, /*use_tracking=*/false);
+    filter.SetTracking(use_tracking);
     std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
         RenderDelayBuffer::Create(config, kSampleRateHz, kNumChannels));
-    // Analyze the correlation between render and capture.
-    for (size_t k = 0; k < (600 + echo_delay_samples / sub_block_size); ++k) {
-      for (size_t band = 0; band < kNumBands; ++band) {
-        for (size_t channel = 0; channel < kNumChannels; ++channel) {
-          RandomizeSampleVector(&random_generator, render.View(band, channel));
-        }
-      }
-      signal_echo_delay_buffer.Delay(render.View(0, 0), capture[0]);
-      signal_pre_echo_delay_buffer.Delay(render.View(0, 0),
-                                         capture_with_pre_echo);
-      for (size_t k = 0; k < capture[0].size(); ++k) {
-        constexpr float gain_pre_echo = 0.8f;
-        capture[0][k] += gain_pre_echo * capture_with_pre_echo[k];
+    DelayBuffer<float> signal_delay_buffer(kDownSamplingFactor *
+                                           kDelaySamples);
+
+    for (size_t k = 0; k < 4000; ++k) {
+      RandomizeSampleVector(&random_generator,
+                            render.View(/*band=*/0, /*channel=*/0));
+      if (k < 3000) {
+        signal_delay_buffer.Delay(render.View(/*band=*/0, /*channel=*/0),
+                                  capture);
+      } else {
+        RandomizeSampleVector(&random_generator, capture);
       }
       render_delay_buffer->Insert(render);
       if (k == 0) {
         render_delay_buffer->Reset();
       }
+
       render_delay_buffer->PrepareCaptureProcessing();
       std::array<float, kBlockSize> downsampled_capture_data;
       rtc::ArrayView<float> downsampled_capture(downsampled_capture_data.data(),
-                                                sub_block_size);
-      capture_decimator.Decimate(capture[0], downsampled_capture);
+                                                kSubBlockSize);
+      capture_decimator.Decimate(capture, downsampled_capture);
       filter.Update(render_delay_buffer->GetDownsampledRenderBuffer(),
-                    downsampled_capture, /*use_slow_smoothing=*/false);
+                    downsampled_capture, /*use_slow_smoothing=*/true);
+      if (k == 2999) {
+        auto lag_estimate = filter.GetBestLagEstimate();
+        ASSERT_TRUE(lag_estimate.has_value());
+        EXPECT_EQ(kDelaySamples, lag_estimate->lag);
+      } else if (k >= 3000) {
+        num_updated_filters[use_tracking] += filter.NumUpdatedFilters();
+      }
     }
-    // Obtain the lag estimates.
-    auto lag_estimate = filter.GetBestLagEstimate();
-    EXPECT_TRUE(lag_estimate.has_value());
-    // Verify that the expected most accurate lag estimate is correct.
-    if (lag_estimate.has_value()) {
-      EXPECT_EQ(echo_delay_samples, lag_estimate->lag);
-      if (kDetectPreEcho) {
-        // The pre echo delay is estimated in a subsampled domain and a larger
-        // error is allowed.
-        EXPECT_NEAR(pre_echo_delay_samples, lag_estimate->pre_echo_lag, 4);
-      } else {
-        // The pre echo delay fallback to the highest mached filter peak when
-        // its detection is disabled.
-        EXPECT_EQ(echo_delay_samples, lag_estimate->pre_echo_lag);
+  }
+  EXPECT_LT(2 * num_updated_filters[true], num_updated_filters[false]);
+}
+
+// Test the pre echo estimation.
+TEST_P(MatchedFilterTest, PreEchoEstimation) {
+  const bool kDetectPreEcho = GetParam();
+  Random random_generator(42U);
+  constexpr size_t kNumChannels = 1;
+  constexpr int kSampleRateHz = 48000;
+  constexpr size_t kNumBands = NumBandsForRate(kSampleRateHz);
+
+  for (bool use_fft : {false, true}) {
+    for (auto down_sampling_factor : kDownSamplingFactors) {
+      const size_t sub_block_size = kBlockSize / down_sampling_factor;
+
+      Block render(kNumBands, kNumChannels);
+      std::vector<std::vector<float>> capture(
+          1, std::vector<float>(kBlockSize, 0.f));
+      std::vector<float> capture_with_pre_echo(kBlockSize, 0.f);
+      ApmDataDumper data_dumper(0);
+      // data_dumper.SetActivated(true);
+      size_t pre_echo_delay_samples = 20e-3 * 16000 / down_sampling_factor;
+      size_t echo_delay_samples = 50e-3 * 16000 / down_sampling_factor;
+      EchoCanceller3Config config;
+      config.delay.down_sampling_factor = down_sampling_factor;
+      config.delay.num_filters = kNumMatchedFilters;
+      Decimator capture_decimator(down_sampling_factor);
+      DelayBuffer<float> signal_echo_delay_buffer(down_sampling_factor *
+                                                  echo_delay_samples);
+      DelayBuffer<float> signal_pre_echo_delay_buffer(down_sampling_factor *
+                                                      pre_echo_delay_samples);
+      MatchedFilter filter(
+          &data_dumper, DetectOptimization(), sub_block_size,
+          kWindowSizeSubBlocks, kNumMatchedFilters, kAlignmentShiftSubBlocks,
+          150, config.delay.delay_estimate_smoothing,
+          config.delay.delay_estimate_smoothing_delay_found,
+          config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+          use_fft, /*use_tracking=*/false);
+      std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+          RenderDelayBuffer::Create(config, kSampleRateHz, kNumChannels));
+      // Analyze the correlation between render and capture.
+      for (size_t k = 0; k < (600 + echo_delay_samples / sub_block_size); ++k) {
+        for (size_t band = 0; band < kNumBands; ++band) {
+          for (size_t channel = 0; channel < kNumChannels; ++channel) {
+            RandomizeSampleVector(&random_generator,
+                                  render.View(band, channel));
+          }
+        }
+        signal_echo_delay_buffer.Delay(render.View(0, 0), capture[0]);
+        signal_pre_echo_delay_buffer.Delay(render.View(0, 0),
+                                           capture_with_pre_echo);
+        for (size_t k = 0; k < capture[0].size(); ++k) {
+          constexpr float gain_pre_echo = 0.8f;
+          capture[0][k] += gain_pre_echo * capture_with_pre_echo[k];
+        }
+        render_delay_buffer->Insert(render);
+        if (k == 0) {
+          render_delay_buffer->Reset();
+        }
+        render_delay_buffer->PrepareCaptureProcessing();
+        std::array<float, kBlockSize> downsampled_capture_data;
+        rtc::ArrayView<float> downsampled_capture(
+            downsampled_capture_data.data(), sub_block_size);
+        capture_decimator.Decimate(capture[0], downsampled_capture);
+        filter.Update(render_delay_buffer->GetDownsampledRenderBuffer(),
+                      downsampled_capture, /*use_slow_smoothing=*/false);
+      }
+      // Obtain the lag estimates.
+      auto lag_estimate = filter.GetBestLagEstimate();
+      EXPECT_TRUE(lag_estimate.has_value());
+      // Verify that the expected most accurate lag estimate is correct.
+      if (lag_estimate.has_value()) {
+        EXPECT_EQ(echo_delay_samples, lag_estimate->lag);
+        if (kDetectPreEcho) {
+          // The pre echo delay is estimated in a subsampled domain and a larger
+          // error is allowed.
+          EXPECT_NEAR(pre_echo_delay_samples, lag_estimate->pre_echo_lag, 4);
+        } else {
+          // The pre echo delay fallback to the highest mached filter peak when
+          // its detection is disabled.
+          EXPECT_EQ(echo_delay_samples, lag_estimate->pre_echo_lag);
+        }
       }
     }
   }
@@ -421,7 +711,8 @@ TEST_P(MatchedFilterTest, LagNotReliableForUncorrelatedRenderAndCapture) {
         kWindowSizeSubBlocks, kNumMatchedFilters, kAlignmentShiftSubBlocks, 150,
         config.delay.delay_estimate_smoothing,
         config.delay.delay_estimate_smoothing_delay_found,
-        config.delay.delay_candidate_detection_threshold, kDetectPreEcho);
+        config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+        /*use_fft=*/false, /*use_tracking=*/false);
 
     // Analyze the correlation between render and capture.
     for (size_t k = 0; k < 100; ++k) {
@@ -462,7 +753,8 @@ TEST_P(MatchedFilterTest, LagNotUpdatedForLowLevelRender) {
         kWindowSizeSubBlocks, kNumMatchedFilters, kAlignmentShiftSubBlocks, 150,
         config.delay.delay_estimate_smoothing,
         config.delay.delay_estimate_smoothing_delay_found,
-        config.delay.delay_candidate_detection_threshold, kDetectPreEcho);
+        config.delay.delay_candidate_detection_threshold, kDetectPreEcho,
+        /*use_fft=*/false, /*use_tracking=*/false);
     std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
         RenderDelayBuffer::Create(EchoCanceller3Config(), kSampleRateHz,
                                   kNumChannels));
@@ -504,7 +796,8 @@ TEST_P(MatchedFilterDeathTest, ZeroWindowSize) {
                              150, config.delay.delay_estimate_smoothing,
                              config.delay.delay_estimate_smoothing_delay_found,
                              config.delay.delay_candidate_detection_threshold,
-                             kDetectPreEcho),
+                             kDetectPreEcho, /*use_fft=*/false,
+                             /*use_tracking=*/false),
                "");
 }
 
@@ -516,7 +809,8 @@ TEST_P(MatchedFilterDeathTest, NullDataDumper) {
                              config.delay.delay_estimate_smoothing,
                              config.delay.delay_estimate_smoothing_delay_found,
                              config.delay.delay_candidate_detection_threshold,
-                             kDetectPreEcho),
+                             kDetectPreEcho, /*use_fft=*/false,
+                             /*use_tracking=*/false),
                "");
 }
 
@@ -530,7 +824,8 @@ TEST_P(MatchedFilterDeathTest, DISABLED_BlockSizeMultipleOf4) {
                              150, config.delay.delay_estimate_smoothing,
                              config.delay.delay_estimate_smoothing_delay_found,
                              config.delay.delay_candidate_detection_threshold,
-                             kDetectPreEcho),
+                             kDetectPreEcho, /*use_fft=*/false,
+                             /*use_tracking=*/false),
                "");
 }
 
@@ -545,7 +840,8 @@ TEST_P(MatchedFilterDeathTest, DISABLED_SubBlockSizeAddsUpToBlockSize) {
                              150, config.delay.delay_estimate_smoothing,
                              config.delay.delay_estimate_smoothing_delay_found,
                              config.delay.delay_candidate_detection_threshold,
-                             kDetectPreEcho),
+                             kDetectPreEcho, /*use_fft=*/false,
+                             /*use_tracking=*/false),
                "");
 }
 
@@ -575,7 +871,8 @@ TEST(MatchedFilterFieldTrialTest, PreEchoConfigurationTest) {
       config.delay.delay_estimate_smoothing,
       config.delay.delay_estimate_smoothing_delay_found,
       config.delay.delay_candidate_detection_threshold,
-      config.delay.detect_pre_echo);
+      config.delay.detect_pre_echo, config.delay.use_fft_matched_filter,
+      config.delay.use_matched_filter_tracking);
 
   auto& pre_echo_config = matched_filter.GetPreEchoConfiguration();
   EXPECT_EQ(pre_echo_config.threshold, threshold_in);
@@ -602,7 +899,8 @@ TEST(MatchedFilterFieldTrialTest, WrongPreEchoConfigurationTest) {
       config.delay.delay_estimate_smoothing,
       config.delay.delay_estimate_smoothing_delay_found,
       config.delay.delay_candidate_detection_threshold,
-      config.delay.detect_pre_echo);
+      config.delay.detect_pre_echo, config.delay.use_fft_matched_filter,
+      config.delay.use_matched_filter_tracking);
 
   auto& pre_echo_config = matched_filter.GetPreEchoConfiguration();
   EXPECT_EQ(pre_echo_config.threshold, kDefaultThreshold);
@@ -12,6 +12,8 @@
 
 #include <cmath>
 
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
 #include "rtc_base/checks.h"
 #include "system_wrappers/include/metrics.h"
 
@@ -21,20 +23,26 @@ namespace {
 
 constexpr int kNumFramesPerSecond = 100;
 
-// Compares the left and right channels in the render `frame` to determine
-// whether the signal is a proper stereo signal. To allow for differences
-// introduced by hardware drivers, a threshold `detection_threshold` is used for
-// the detection.
-bool HasStereoContent(const std::vector<std::vector<std::vector<float>>>& frame,
+// Compares the left and right channels of a render frame with `num_bands`
+// bands and `num_channels` channels, whose channel `channel` in band `band` is
+// returned by `get_channel(band, channel)`, to determine whether the signal is
+// a proper stereo signal. To allow for differences introduced by hardware
+// drivers, a threshold `detection_threshold` is used for the detection.
+template <typename GetChannel>
+bool HasStereoContent(int num_bands,
+                      int num_channels,
+                      const GetChannel& get_channel,
                       float detection_threshold) {
-  if (frame[0].size() < 2) {
+  if (num_channels < 2) {
     return false;
   }
 
-  for (size_t band = 0; band < frame.size(); ++band) {
-    for (size_t k = 0; k < frame[band][0].size(); ++k) {
-      if (std::fabs(frame[band][0][k] - frame[band][1][k]) >
-          detection_threshold) {
+  for (int band = 0; band < num_bands; ++band) {
+    rtc::ArrayView<const float> left = get_channel(band, /*channel=*/0);
+    rtc::ArrayView<const float> right = get_channel(band, /*channel=*/1);
+    RTC_DCHECK_EQ(left.size(), right.size());
+    for (size_t k = 0; k < left.size(); ++k) {
+      if (std::fabs(left[k] - right[k]) > detection_threshold) {
         return true;
       }
     }
@@ -42,9 +50,37 @@ bool HasStereoContent(const std::vector<std::vector<std::vector<float>>>& frame,
   return false;
 }
 
+bool HasStereoContent(const std::vector<std::vector<std::vector<float>>>& frame,
+                      float detection_threshold) {
+  return HasStereoContent(
+      static_cast<int>(frame.size()), static_cast<int>(frame[0].size()),
+      [&frame](int band, int channel) {
+        return rtc::ArrayView<const float>(frame[band][channel]);
+      },
+      detection_threshold);
+}
+
+bool HasStereoContent(const RenderFrameView& frame, float detection_threshold) {
+  return HasStereoContent(
+      frame.NumBands(), frame.NumChannels(),
+      [&frame](int band, int channel) {
+        return rtc::ArrayView<const float>(frame.View(band, channel));
+      },
+      detection_threshold);
+}
+
 // In order to avoid logging metrics for very short lifetimes that are unlikely
 // to reflect real calls and that may dilute the "real" data, logging is limited
 // to lifetimes of at leats 5 seconds.
+bool HasStereoContent(const Block& block, float detection_threshold) {
+  return HasStereoContent(
+      block.NumBands(), block.NumChannels(),
+      [&block](int band, int channel) {
+        return rtc::ArrayView<const float>(block.View(band, channel));
+      },
+      detection_threshold);
+}
+
 constexpr int kMinNumberOfFramesRequiredToLogMetrics = 500;
 
 // Continuous metrics are logged every 10 seconds.
@@ -113,10 +149,43 @@ bool MultiChannelContentDetector::UpdateDetection(
     return false;
   }
 
+  return UpdateDetectionState(HasStereoContent(frame, detection_threshold_));
+}
+
+bool MultiChannelContentDetector::UpdateDetection(
+    const RenderFrameView& frame) {
+  if (!detect_stereo_content_) {
+    RTC_DCHECK_EQ(frame.NumChannels() > 1,
+                  persistent_multichannel_content_detected_);
+    return false;
+  }
+
+  return UpdateDetectionState(HasStereoContent(frame, detection_threshold_));
+}
+
+bool MultiChannelContentDetector::UpdateDetection(const Block& block) {
+  if (!detect_stereo_content_) {
+    RTC_DCHECK_EQ(block.NumChannels() > 1,
+                  persistent_multichannel_content_detected_);
+    return false;
+  }
+
+  stereo_detected_in_blocks_ = stereo_detected_in_blocks_ ||
+                               HasStereoContent(block, detection_threshold_);
+  num_block_samples_in_frame_ += kBlockSize;
+  if (num_block_samples_in_frame_ < kFrameSize) {
+    return false;
+  }
+  num_block_samples_in_frame_ -= kFrameSize;
+  const bool stereo_detected_in_frame = stereo_detected_in_blocks_;
+  stereo_detected_in_blocks_ = false;
+  return UpdateDetectionState(stereo_detected_in_frame);
+}
+
+bool MultiChannelContentDetector::UpdateDetectionState(
+    bool stereo_detected_in_frame) {
   const bool previous_persistent_multichannel_content_detected =
       persistent_multichannel_content_detected_;
-  const bool stereo_detected_in_frame =
-      HasStereoContent(frame, detection_threshold_);
 
   consecutive_frames_with_stereo_ =
       stereo_detected_in_frame ? consecutive_frames_with_stereo_ + 1 : 0;
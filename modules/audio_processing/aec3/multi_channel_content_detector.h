@@ -17,6 +17,8 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "modules/audio_processing/aec3/block.h"
+#include "modules/audio_processing/aec3/render_transfer_queue.h"
 
 namespace webrtc {
 
@@ -43,6 +45,13 @@ class MultiChannelContentDetector {
   bool UpdateDetection(
       const std::vector<std::vector<std::vector<float>>>& frame);
 
+  // As above, but for a frame stored in a RenderTransferQueue.
+  bool UpdateDetection(const RenderFrameView& frame);
+
+  // As above, but for a block. The detection state is updated once per 10 ms
+  // of blocks, so that the timeout and hysteresis are the same as for frames.
+  bool UpdateDetection(const Block& block);
+
   bool IsProperMultiChannelContentDetected() const {
     return persistent_multichannel_content_detected_;
   }
@@ -74,6 +83,10 @@ class MultiChannelContentDetector {
     bool any_multichannel_content_detected_ = false;
   };
 
+  // Updates the detection state given whether stereo content was detected in
+  // the latest frame.
+  bool UpdateDetectionState(bool stereo_detected_in_frame);
+
   const bool detect_stereo_content_;
   const float detection_threshold_;
   const absl::optional<int> detection_timeout_threshold_frames_;
@@ -88,6 +101,8 @@ class MultiChannelContentDetector {
   bool temporary_multichannel_content_detected_ = false;
   int64_t frames_since_stereo_detected_last_ = 0;
   int64_t consecutive_frames_with_stereo_ = 0;
+  size_t num_block_samples_in_frame_ = 0;
+  bool stereo_detected_in_blocks_ = false;
 };
 
 }  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/aec3/multi_channel_content_detector.h"
 
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/block.h"
 #include "system_wrappers/include/metrics.h"
 #include "test/gtest.h"
 
@@ -163,6 +165,35 @@ TEST(MultiChannelContentDetector, DetectionWithStereoAboveThreshold) {
   EXPECT_FALSE(mc.UpdateDetection(frame));
 }
 
+// Verifies that the detection state is updated once per 10 ms of blocks, and
+// that stereo content in any of the blocks is detected.
+TEST(MultiChannelContentDetector, DetectionWhenStereoInBlocks) {
+  MultiChannelContentDetector mc(
+      /*detect_stereo_content=*/true,
+      /*num_render_input_channels=*/2,
+      /*detection_threshold=*/0.0f,
+      /*stereo_detection_timeout_threshold_seconds=*/0,
+      /*stereo_detection_hysteresis_seconds=*/0.0f);
+  Block stereo_block(/*num_bands=*/1, /*num_channels=*/2);
+  std::fill(stereo_block.begin(/*band=*/0, /*channel=*/0),
+            stereo_block.end(/*band=*/0, /*channel=*/0), 100.0f);
+  std::fill(stereo_block.begin(/*band=*/0, /*channel=*/1),
+            stereo_block.end(/*band=*/0, /*channel=*/1), 101.0f);
+  Block fake_stereo_block(/*num_bands=*/1, /*num_channels=*/2, 100.0f);
+
+  size_t num_samples = 0;
+  for (const Block* block :
+       {&stereo_block, &fake_stereo_block, &fake_stereo_block}) {
+    num_samples += kBlockSize;
+    EXPECT_EQ(num_samples >= kFrameSize, mc.UpdateDetection(*block));
+    EXPECT_EQ(num_samples >= kFrameSize,
+              mc.IsProperMultiChannelContentDetected());
+  }
+
+  EXPECT_FALSE(mc.UpdateDetection(fake_stereo_block));
+  EXPECT_TRUE(mc.IsProperMultiChannelContentDetected());
+}
+
 class MultiChannelContentDetectorTimeoutBehavior
     : public ::testing::Test,
       public ::testing::WithParamInterface<std::tuple<bool, int>> {};
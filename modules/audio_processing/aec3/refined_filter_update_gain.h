@@ -55,6 +55,16 @@ class RefinedFilterUpdateGain {
                bool disallow_leakage_diverged,
                FftData* gain_fft);
 
+  // Returns the estimated filter misadjustment that controls the step size.
+  const std::array<float, kFftLengthBy2Plus1>& FilterError() const {
+    return H_error_;
+  }
+
+  // Sets the estimated filter misadjustment.
+  void SetFilterError(const std::array<float, kFftLengthBy2Plus1>& H_error) {
+    H_error_ = H_error;
+  }
+
   // Sets a new config.
   void SetConfig(
       const EchoCanceller3Config::Filter::RefinedConfiguration& config,
@@ -55,7 +55,7 @@ class RenderBuffer {
   }
 
   // Returns the circular fft buffer.
-  rtc::ArrayView<const std::vector<FftData>> GetFftBuffer() const {
+  const FftDataArray& GetFftBuffer() const {
     return fft_buffer_->buffer;
   }
 
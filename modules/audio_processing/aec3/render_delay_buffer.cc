@@ -14,23 +14,20 @@
 
 #include <algorithm>
 #include <atomic>
-#include <cmath>
 #include <memory>
 #include <numeric>
-#include <vector>
+#include <utility>
 
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
+#include "api/scoped_refptr.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
-#include "modules/audio_processing/aec3/aec3_fft.h"
-#include "modules/audio_processing/aec3/alignment_mixer.h"
 #include "modules/audio_processing/aec3/block_buffer.h"
-#include "modules/audio_processing/aec3/decimator.h"
 #include "modules/audio_processing/aec3/downsampled_render_buffer.h"
 #include "modules/audio_processing/aec3/fft_buffer.h"
-#include "modules/audio_processing/aec3/fft_data.h"
 #include "modules/audio_processing/aec3/render_buffer.h"
+#include "modules/audio_processing/aec3/shared_render_pipeline.h"
 #include "modules/audio_processing/aec3/spectrum_buffer.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
@@ -43,8 +40,7 @@ namespace {
 class RenderDelayBufferImpl final : public RenderDelayBuffer {
  public:
   RenderDelayBufferImpl(const EchoCanceller3Config& config,
-                        int sample_rate_hz,
-                        size_t num_render_channels);
+                        rtc::scoped_refptr<SharedRenderPipeline> pipeline);
   RenderDelayBufferImpl() = delete;
   ~RenderDelayBufferImpl() override;
 
@@ -71,23 +67,19 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
  private:
   static std::atomic<int> instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
-  const Aec3Optimization optimization_;
   const EchoCanceller3Config config_;
-  const float render_linear_amplitude_gain_;
   const rtc::LoggingSeverity delay_log_level_;
   size_t down_sampling_factor_;
   const int sub_block_size_;
+  const rtc::scoped_refptr<SharedRenderPipeline> pipeline_;
   BlockBuffer blocks_;
   SpectrumBuffer spectra_;
   FftBuffer ffts_;
   absl::optional<size_t> delay_;
   RenderBuffer echo_remover_buffer_;
   DownsampledRenderBuffer low_rate_;
-  AlignmentMixer render_mixer_;
-  Decimator render_decimator_;
-  const Aec3Fft fft_;
-  std::vector<float> render_ds_;
   const int buffer_headroom_;
+  int64_t num_inserted_blocks_ = 0;
   bool last_call_was_render_ = false;
   int num_api_calls_in_a_row_ = 0;
   int max_observed_jitter_ = 1;
@@ -103,7 +95,6 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
   int MapDelayToTotalDelay(size_t delay) const;
   int ComputeDelay() const;
   void ApplyTotalDelay(int delay);
-  void InsertBlock(const Block& block, int previous_write);
   bool DetectActiveRender(rtc::ArrayView<const float> x) const;
   bool DetectExcessRenderBlocks();
   void IncrementWriteIndices();
@@ -115,14 +106,11 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
 
 std::atomic<int> RenderDelayBufferImpl::instance_count_ = 0;
 
-RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
-                                             int sample_rate_hz,
-                                             size_t num_render_channels)
+RenderDelayBufferImpl::RenderDelayBufferImpl(
+    const EchoCanceller3Config& config,
+    rtc::scoped_refptr<SharedRenderPipeline> pipeline)
     : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
-      optimization_(DetectOptimization()),
       config_(config),
-      render_linear_amplitude_gain_(
-          std::pow(10.0f, config_.render_levels.render_power_gain_db / 20.f)),
       delay_log_level_(config_.delay.log_warning_on_delay_changes
                            ? rtc::LS_WARNING
                            : rtc::LS_VERBOSE),
@@ -130,21 +118,13 @@ RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
       sub_block_size_(static_cast<int>(down_sampling_factor_ > 0
                                            ? kBlockSize / down_sampling_factor_
                                            : kBlockSize)),
-      blocks_(GetRenderDelayBufferSize(down_sampling_factor_,
-                                       config.delay.num_filters,
-                                       config.filter.refined.length_blocks),
-              NumBandsForRate(sample_rate_hz),
-              num_render_channels),
-      spectra_(blocks_.buffer.size(), num_render_channels),
-      ffts_(blocks_.buffer.size(), num_render_channels),
+      pipeline_(std::move(pipeline)),
+      blocks_(pipeline_->blocks()),
+      spectra_(pipeline_->spectra()),
+      ffts_(pipeline_->ffts()),
       delay_(config_.delay.default_delay),
       echo_remover_buffer_(&blocks_, &spectra_, &ffts_),
-      low_rate_(GetDownSampledBufferSize(down_sampling_factor_,
-                                         config.delay.num_filters)),
-      render_mixer_(num_render_channels, config.delay.render_alignment_mixing),
-      render_decimator_(down_sampling_factor_),
-      fft_(),
-      render_ds_(sub_block_size_, 0.f),
+      low_rate_(pipeline_->low_rate()),
       buffer_headroom_(config.filter.refined.length_blocks) {
   RTC_DCHECK_EQ(blocks_.buffer.size(), ffts_.buffer.size());
   RTC_DCHECK_EQ(spectra_.buffer.size(), ffts_.buffer.size());
@@ -153,6 +133,8 @@ RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
     RTC_DCHECK_EQ(spectra_.buffer[i].size(), ffts_.buffer[i].size());
   }
 
+  num_inserted_blocks_ =
+      pipeline_->Attach(&blocks_, &spectra_, &ffts_, &low_rate_);
   Reset();
 }
 
@@ -217,7 +199,6 @@ RenderDelayBuffer::BufferingEvent RenderDelayBufferImpl::Insert(
   }
 
   // Increase the write indices to where the new blocks should be written.
-  const int previous_write = blocks_.write;
   IncrementWriteIndices();
 
   // Allow overrun and do a reset when render overrun occurrs due to more render
@@ -232,8 +213,9 @@ RenderDelayBuffer::BufferingEvent RenderDelayBufferImpl::Insert(
     render_activity_ = render_activity_counter_ >= 20;
   }
 
-  // Insert the new render block into the specified position.
-  InsertBlock(block, previous_write);
+  // Insert the new render block into the specified position, unless it has
+  // already been inserted by another user of the render pipeline.
+  pipeline_->Insert(num_inserted_blocks_++, block);
 
   if (event != BufferingEvent::kNone) {
     Reset();
@@ -380,52 +362,6 @@ void RenderDelayBufferImpl::AlignFromExternalDelay() {
   }
 }
 
-// Inserts a block into the render buffers.
-void RenderDelayBufferImpl::InsertBlock(const Block& block,
-                                        int previous_write) {
-  auto& b = blocks_;
-  auto& lr = low_rate_;
-  auto& ds = render_ds_;
-  auto& f = ffts_;
-  auto& s = spectra_;
-  const size_t num_bands = b.buffer[b.write].NumBands();
-  const size_t num_render_channels = b.buffer[b.write].NumChannels();
-  RTC_DCHECK_EQ(block.NumBands(), num_bands);
-  RTC_DCHECK_EQ(block.NumChannels(), num_render_channels);
-  for (size_t band = 0; band < num_bands; ++band) {
-    for (size_t ch = 0; ch < num_render_channels; ++ch) {
-      std::copy(block.begin(band, ch), block.end(band, ch),
-                b.buffer[b.write].begin(band, ch));
-    }
-  }
-
-  if (render_linear_amplitude_gain_ != 1.f) {
-    for (size_t band = 0; band < num_bands; ++band) {
-      for (size_t ch = 0; ch < num_render_channels; ++ch) {
-        rtc::ArrayView<float, kBlockSize> b_view =
-            b.buffer[b.write].View(band, ch);
-        for (float& sample : b_view) {
-          sample *= render_linear_amplitude_gain_;
-        }
-      }
-    }
-  }
-
-  std::array<float, kBlockSize> downmixed_render;
-  render_mixer_.ProduceOutput(b.buffer[b.write], downmixed_render);
-  render_decimator_.Decimate(downmixed_render, ds);
-  data_dumper_->DumpWav("aec3_render_decimator_output", ds.size(), ds.data(),
-                        16000 / down_sampling_factor_, 1);
-  std::copy(ds.rbegin(), ds.rend(), lr.buffer.begin() + lr.write);
-  for (int channel = 0; channel < b.buffer[b.write].NumChannels(); ++channel) {
-    fft_.PaddedFft(b.buffer[b.write].View(/*band=*/0, channel),
-                   b.buffer[previous_write].View(/*band=*/0, channel),
-                   &f.buffer[f.write][channel]);
-    f.buffer[f.write][channel].Spectrum(optimization_,
-                                        s.buffer[s.write][channel]);
-  }
-}
-
 bool RenderDelayBufferImpl::DetectActiveRender(
     rtc::ArrayView<const float> x) const {
   const float x_energy = std::inner_product(x.begin(), x.end(), x.begin(), 0.f);
@@ -503,7 +439,20 @@ bool RenderDelayBufferImpl::RenderUnderrun() {
 RenderDelayBuffer* RenderDelayBuffer::Create(const EchoCanceller3Config& config,
                                              int sample_rate_hz,
                                              size_t num_render_channels) {
-  return new RenderDelayBufferImpl(config, sample_rate_hz, num_render_channels);
+  return new RenderDelayBufferImpl(
+      config, SharedRenderPipeline::Create(config, sample_rate_hz,
+                                           num_render_channels));
+}
+
+RenderDelayBuffer* RenderDelayBuffer::Create(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    size_t num_render_channels,
+    rtc::scoped_refptr<SharedRenderPipeline> pipeline) {
+  RTC_DCHECK(pipeline);
+  RTC_DCHECK(
+      pipeline->IsCompatible(config, sample_rate_hz, num_render_channels));
+  return new RenderDelayBufferImpl(config, std::move(pipeline));
 }
 
 }  // namespace webrtc
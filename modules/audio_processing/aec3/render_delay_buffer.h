@@ -16,9 +16,11 @@
 #include <vector>
 
 #include "api/audio/echo_canceller3_config.h"
+#include "api/scoped_refptr.h"
 #include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/downsampled_render_buffer.h"
 #include "modules/audio_processing/aec3/render_buffer.h"
+#include "modules/audio_processing/aec3/shared_render_pipeline.h"
 
 namespace webrtc {
 
@@ -36,6 +38,13 @@ class RenderDelayBuffer {
   static RenderDelayBuffer* Create(const EchoCanceller3Config& config,
                                    int sample_rate_hz,
                                    size_t num_render_channels);
+  // Creates a buffer that reads the render data computed by `pipeline`, which
+  // may be shared with the buffers of other echo cancellers.
+  static RenderDelayBuffer* Create(
+      const EchoCanceller3Config& config,
+      int sample_rate_hz,
+      size_t num_render_channels,
+      rtc::scoped_refptr<SharedRenderPipeline> pipeline);
   virtual ~RenderDelayBuffer() = default;
 
   // Resets the buffer alignment.
@@ -49,6 +49,13 @@ class RenderDelayControllerImpl final : public RenderDelayController {
       size_t render_delay_buffer_delay,
       const Block& capture) override;
   bool HasClockdrift() const override;
+  absl::optional<size_t> DelaySamples() const override;
+  absl::optional<DelayEstimate> RestoreDelay(size_t delay_samples) override;
+  void HandleEchoPathChange(
+      const EchoPathVariability& echo_path_variability) override;
+  void SetComputeTier(Aec3ComputeTier tier) override {
+    delay_estimator_.SetComputeTier(tier);
+  }
 
  private:
   static std::atomic<int> instance_count_;
@@ -173,6 +180,31 @@ bool RenderDelayControllerImpl::HasClockdrift() const {
   return delay_estimator_.Clockdrift() != ClockdriftDetector::Level::kNone;
 }
 
+absl::optional<size_t> RenderDelayControllerImpl::DelaySamples() const {
+  return delay_samples_ ? absl::optional<size_t>(delay_samples_->delay)
+                        : absl::nullopt;
+}
+
+absl::optional<DelayEstimate> RenderDelayControllerImpl::RestoreDelay(
+    size_t delay_samples) {
+  // The restored delay is treated as a refined estimate so that hysteresis is
+  // applied to the subsequent estimates.
+  delay_samples_ =
+      DelayEstimate(DelayEstimate::Quality::kRefined, delay_samples);
+  delay_change_counter_ = 0;
+  delay_ = ComputeBufferDelay(absl::nullopt, 0, *delay_samples_);
+  last_delay_estimate_quality_ = DelayEstimate::Quality::kRefined;
+  return delay_;
+}
+
+void RenderDelayControllerImpl::HandleEchoPathChange(
+    const EchoPathVariability& echo_path_variability) {
+  if (echo_path_variability.delay_change !=
+      EchoPathVariability::DelayAdjustment::kNone) {
+    delay_estimator_.RestartFullSearch();
+  }
+}
+
 }  // namespace
 
 RenderDelayController* RenderDelayController::Create(
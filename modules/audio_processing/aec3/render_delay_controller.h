@@ -14,9 +14,11 @@
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/block.h"
 #include "modules/audio_processing/aec3/delay_estimate.h"
 #include "modules/audio_processing/aec3/downsampled_render_buffer.h"
+#include "modules/audio_processing/aec3/echo_path_variability.h"
 #include "modules/audio_processing/aec3/render_delay_buffer.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 
@@ -45,6 +47,25 @@ class RenderDelayController {
 
   // Returns true if clockdrift has been detected.
   virtual bool HasClockdrift() const = 0;
+
+  // Returns the estimated delay of the echo path in samples, if any.
+  virtual absl::optional<size_t> DelaySamples() const { return absl::nullopt; }
+
+  // Sets the estimated delay of the echo path to a previously estimated delay
+  // in samples and returns the corresponding render delay buffer delay, as
+  // GetDelay does.
+  virtual absl::optional<DelayEstimate> RestoreDelay(
+      size_t /*delay_samples*/) {
+    return absl::nullopt;
+  }
+
+  // Handles a change of the echo path. A change of the delay restarts the
+  // search for the delay over the full delay range.
+  virtual void HandleEchoPathChange(
+      const EchoPathVariability& /*echo_path_variability*/) {}
+
+  // Reduces the complexity of the delay estimation according to `tier`.
+  virtual void SetComputeTier(Aec3ComputeTier /*tier*/) {}
 };
 }  // namespace webrtc
 
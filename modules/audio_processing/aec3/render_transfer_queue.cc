@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/render_transfer_queue.h"
+
+#include <algorithm>
+
+namespace webrtc {
+
+namespace {
+
+constexpr size_t kFloatsPerAlignment =
+    kRenderTransferQueueAlignment / sizeof(float);
+
+// Returns the size of a slot, rounded up so that every slot starts on an
+// aligned address.
+size_t SlotSize(int num_bands, int num_channels, size_t frame_length) {
+  const size_t frame_size = num_bands * num_channels * frame_length;
+  return (frame_size + kFloatsPerAlignment - 1) / kFloatsPerAlignment *
+         kFloatsPerAlignment;
+}
+
+}  // namespace
+
+// One slot more than the capacity is allocated, as the producer always owns
+// the slot that it writes into.
+RenderTransferQueue::RenderTransferQueue(size_t capacity,
+                                         int num_bands,
+                                         int num_channels,
+                                         size_t frame_length)
+    : num_slots_(capacity + 1),
+      num_bands_(num_bands),
+      num_channels_(num_channels),
+      frame_length_(frame_length),
+      slot_size_(SlotSize(num_bands, num_channels, frame_length)),
+      data_(AlignedMalloc<float>(num_slots_ * slot_size_ * sizeof(float),
+                                 kRenderTransferQueueAlignment)) {
+  RTC_DCHECK_LT(0, capacity);
+  RTC_DCHECK_LT(0, num_bands);
+  RTC_DCHECK_LT(0, num_channels);
+  RTC_DCHECK(data_);
+  std::fill(data_.get(), data_.get() + num_slots_ * slot_size_, 0.f);
+}
+
+RenderTransferQueue::~RenderTransferQueue() = default;
+
+bool RenderTransferQueue::Insert() {
+  const size_t index = producer_.index.load(std::memory_order_relaxed);
+  const size_t next_index = Next(index);
+  if (next_index == producer_.cached_other_index) {
+    producer_.cached_other_index =
+        consumer_.index.load(std::memory_order_acquire);
+    if (next_index == producer_.cached_other_index) {
+      num_overflows_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  producer_.index.store(next_index, std::memory_order_release);
+  return true;
+}
+
+bool RenderTransferQueue::HasFrame() {
+  const size_t index = consumer_.index.load(std::memory_order_relaxed);
+  if (index == consumer_.cached_other_index) {
+    consumer_.cached_other_index =
+        producer_.index.load(std::memory_order_acquire);
+  }
+  return index != consumer_.cached_other_index;
+}
+
+void RenderTransferQueue::Remove() {
+  RTC_DCHECK(HasFrame());
+  const size_t index = consumer_.index.load(std::memory_order_relaxed);
+  consumer_.index.store(Next(index), std::memory_order_release);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_RENDER_TRANSFER_QUEUE_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_RENDER_TRANSFER_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+
+#include "api/array_view.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/memory/aligned_malloc.h"
+
+namespace webrtc {
+
+// Alignment of the frame slots in a RenderTransferQueue.
+constexpr size_t kRenderTransferQueueAlignment = 64;
+
+// View of one frame in a RenderTransferQueue. The layout matches that of
+// Block, with the samples of each band and channel stored contiguously and
+// the channels of a band adjacent in memory.
+class RenderFrameView {
+ public:
+  RenderFrameView(float* data,
+                  int num_bands,
+                  int num_channels,
+                  size_t frame_length)
+      : data_(data),
+        num_bands_(num_bands),
+        num_channels_(num_channels),
+        frame_length_(frame_length) {}
+
+  // Returns the number of bands.
+  int NumBands() const { return num_bands_; }
+
+  // Returns the number of channels.
+  int NumChannels() const { return num_channels_; }
+
+  // Returns the number of samples per band and channel.
+  size_t FrameLength() const { return frame_length_; }
+
+  // Access data via ArrayView.
+  rtc::ArrayView<float> View(int band, int channel) const {
+    RTC_DCHECK_LT(band, num_bands_);
+    RTC_DCHECK_LT(channel, num_channels_);
+    return rtc::ArrayView<float>(
+        &data_[(band * num_channels_ + channel) * frame_length_],
+        frame_length_);
+  }
+
+ private:
+  float* const data_;
+  const int num_bands_;
+  const int num_channels_;
+  const size_t frame_length_;
+};
+
+// Single-producer/single-consumer lock-free queue for transferring render
+// frames from the render thread to the capture thread. The frames are stored
+// in preallocated, cache line aligned slots, and the producer and the consumer
+// only exchange the slot indices, which are kept on separate cache lines.
+//
+// The producer writes into the slot returned by InsertionFrame() and then
+// publishes it using Insert(). The consumer reads and may modify the oldest
+// published frame through RemovalFrame() and then releases it using Remove().
+class RenderTransferQueue {
+ public:
+  RenderTransferQueue(size_t capacity,
+                      int num_bands,
+                      int num_channels,
+                      size_t frame_length);
+
+  RenderTransferQueue() = delete;
+  RenderTransferQueue(const RenderTransferQueue&) = delete;
+  RenderTransferQueue& operator=(const RenderTransferQueue&) = delete;
+
+  ~RenderTransferQueue();
+
+  // Producer side. Returns the frame to fill before the next call to Insert().
+  // The frame keeps its content if the insertion fails.
+  RenderFrameView InsertionFrame() {
+    return Frame(producer_.index.load(std::memory_order_relaxed));
+  }
+
+  // Producer side. Publishes the frame returned by InsertionFrame(). Returns
+  // false, and counts an overflow, if the queue is full, in which case the
+  // frame is dropped.
+  bool Insert();
+
+  // Consumer side. Returns whether there is a published frame to remove.
+  bool HasFrame();
+
+  // Consumer side. Returns the oldest published frame. Must only be called if
+  // HasFrame() returns true.
+  RenderFrameView RemovalFrame() {
+    RTC_DCHECK(HasFrame());
+    return Frame(consumer_.index.load(std::memory_order_relaxed));
+  }
+
+  // Consumer side. Releases the frame returned by RemovalFrame().
+  void Remove();
+
+  // Returns the number of frames that have been dropped since the queue was
+  // created because the queue was full. May be called from any thread.
+  int NumOverflows() const {
+    return num_overflows_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Indices owned by one side of the queue, together with the latest seen
+  // value of the index owned by the other side. Padded to avoid false sharing
+  // between the producer and the consumer.
+  struct alignas(kRenderTransferQueueAlignment) SideIndices {
+    std::atomic<size_t> index{0};
+    size_t cached_other_index = 0;
+  };
+
+  RenderFrameView Frame(size_t slot) const {
+    return RenderFrameView(&data_[slot * slot_size_], num_bands_,
+                           num_channels_, frame_length_);
+  }
+
+  size_t Next(size_t slot) const {
+    return slot + 1 == num_slots_ ? 0 : slot + 1;
+  }
+
+  const size_t num_slots_;
+  const int num_bands_;
+  const int num_channels_;
+  const size_t frame_length_;
+  const size_t slot_size_;
+  const std::unique_ptr<float[], AlignedFreeDeleter> data_;
+  SideIndices producer_;
+  SideIndices consumer_;
+  std::atomic<int> num_overflows_{0};
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_RENDER_TRANSFER_QUEUE_H_
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/render_transfer_queue.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumBands = 3;
+constexpr int kNumChannels = 2;
+constexpr size_t kFrameLength = 160;
+
+// Fills the frame with values that identify the frame, band and channel.
+void FillFrame(int frame_index, const RenderFrameView& frame) {
+  for (int band = 0; band < frame.NumBands(); ++band) {
+    for (int channel = 0; channel < frame.NumChannels(); ++channel) {
+      std::fill(frame.View(band, channel).begin(),
+                frame.View(band, channel).end(),
+                frame_index * 100.f + band * 10.f + channel);
+    }
+  }
+}
+
+// Verifies that the frame has the content produced by FillFrame().
+void VerifyFrame(int frame_index, const RenderFrameView& frame) {
+  for (int band = 0; band < frame.NumBands(); ++band) {
+    for (int channel = 0; channel < frame.NumChannels(); ++channel) {
+      for (float sample : frame.View(band, channel)) {
+        ASSERT_EQ(frame_index * 100.f + band * 10.f + channel, sample);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+// Verifies that the frames are stored contiguously, band-major, and that
+// every slot starts on a cache line boundary.
+TEST(RenderTransferQueue, Layout) {
+  RenderTransferQueue queue(/*capacity=*/4, kNumBands, kNumChannels,
+                            kFrameLength);
+  for (int k = 0; k < 6; ++k) {
+    const RenderFrameView frame = queue.InsertionFrame();
+    EXPECT_EQ(kNumBands, frame.NumBands());
+    EXPECT_EQ(kNumChannels, frame.NumChannels());
+    EXPECT_EQ(kFrameLength, frame.FrameLength());
+    const float* first = frame.View(0, 0).data();
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) %
+                      kRenderTransferQueueAlignment);
+    for (int band = 0; band < kNumBands; ++band) {
+      for (int channel = 0; channel < kNumChannels; ++channel) {
+        EXPECT_EQ(first + (band * kNumChannels + channel) * kFrameLength,
+                  frame.View(band, channel).data());
+      }
+    }
+    EXPECT_TRUE(queue.Insert());
+    ASSERT_TRUE(queue.HasFrame());
+    queue.Remove();
+  }
+}
+
+// Verifies that the frames are removed in the order that they are inserted,
+// including when the slot indices wrap around.
+TEST(RenderTransferQueue, FirstInFirstOut) {
+  RenderTransferQueue queue(/*capacity=*/3, kNumBands, kNumChannels,
+                            kFrameLength);
+  EXPECT_FALSE(queue.HasFrame());
+  int inserted = 0;
+  int removed = 0;
+  for (int round = 0; round < 10; ++round) {
+    for (int k = 0; k < 1 + round % 3; ++k) {
+      FillFrame(inserted, queue.InsertionFrame());
+      EXPECT_TRUE(queue.Insert());
+      ++inserted;
+    }
+    while (queue.HasFrame()) {
+      VerifyFrame(removed, queue.RemovalFrame());
+      queue.Remove();
+      ++removed;
+    }
+  }
+  EXPECT_EQ(inserted, removed);
+  EXPECT_EQ(0, queue.NumOverflows());
+}
+
+// Verifies that frames inserted into a full queue are dropped and counted.
+TEST(RenderTransferQueue, Overflow) {
+  constexpr size_t kCapacity = 4;
+  RenderTransferQueue queue(kCapacity, kNumBands, kNumChannels, kFrameLength);
+  for (size_t k = 0; k < kCapacity; ++k) {
+    FillFrame(k, queue.InsertionFrame());
+    EXPECT_TRUE(queue.Insert());
+  }
+  FillFrame(kCapacity, queue.InsertionFrame());
+  EXPECT_FALSE(queue.Insert());
+  EXPECT_FALSE(queue.Insert());
+  EXPECT_EQ(2, queue.NumOverflows());
+
+  // The frames in the queue are unaffected by the overflow.
+  for (size_t k = 0; k < kCapacity; ++k) {
+    ASSERT_TRUE(queue.HasFrame());
+    VerifyFrame(k, queue.RemovalFrame());
+    queue.Remove();
+  }
+  EXPECT_FALSE(queue.HasFrame());
+
+  // The producer slot kept its content and can be inserted once there is
+  // room.
+  EXPECT_TRUE(queue.Insert());
+  ASSERT_TRUE(queue.HasFrame());
+  VerifyFrame(kCapacity, queue.RemovalFrame());
+  queue.Remove();
+}
+
+// Verifies that all frames are transferred intact when the producer and the
+// consumer run concurrently. Both sides yield while waiting, so that the test
+// also completes when the threads share a single core.
+TEST(RenderTransferQueue, ConcurrentTransfer) {
+  constexpr int kNumFrames = 2000;
+  RenderTransferQueue queue(/*capacity=*/8, kNumBands, kNumChannels,
+                            kFrameLength);
+  std::thread producer([&queue] {
+    for (int k = 0; k < kNumFrames; ++k) {
+      FillFrame(k, queue.InsertionFrame());
+      while (!queue.Insert()) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int num_removed = 0;
+  while (num_removed < kNumFrames) {
+    if (!queue.HasFrame()) {
+      std::this_thread::yield();
+      continue;
+    }
+    VerifyFrame(num_removed, queue.RemovalFrame());
+    queue.Remove();
+    ++num_removed;
+  }
+
+  producer.join();
+  EXPECT_FALSE(queue.HasFrame());
+}
+
+}  // namespace webrtc
@@ -34,6 +34,8 @@ class ReverbDecayEstimator {
               int filter_delay_blocks,
               bool usable_linear_filter,
               bool stationary_signal);
+  // Sets the decay for the exponential model.
+  void SetDecay(float decay) { decay_ = decay; }
   // Returns the decay for the exponential model. The parameter `mild` indicates
   // which exponential decay to return, the default one or a milder one.
   float Decay(bool mild) const {
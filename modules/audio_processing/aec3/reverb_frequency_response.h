@@ -34,6 +34,12 @@ class ReverbFrequencyResponse {
               const absl::optional<float>& linear_filter_quality,
               bool stationary_block);
 
+  // Sets the frequency response estimate of the reverb.
+  void SetFrequencyResponse(
+      const std::array<float, kFftLengthBy2Plus1>& frequency_response) {
+    tail_response_ = frequency_response;
+  }
+
   // Returns the estimated frequency response for the reverb.
   rtc::ArrayView<const float> FrequencyResponse() const {
     return tail_response_;
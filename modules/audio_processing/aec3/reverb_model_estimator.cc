@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/aec3/reverb_model_estimator.h"
 
+#include <algorithm>
+
 namespace webrtc {
 
 ReverbModelEstimator::ReverbModelEstimator(const EchoCanceller3Config& config,
@@ -27,6 +29,32 @@ ReverbModelEstimator::ReverbModelEstimator(const EchoCanceller3Config& config,
 
 ReverbModelEstimator::~ReverbModelEstimator() = default;
 
+void ReverbModelEstimator::SaveWarmStartState(
+    Aec3WarmStartState* state) const {
+  RTC_DCHECK_EQ(state->capture_channels.size(),
+                reverb_decay_estimators_.size());
+  for (size_t ch = 0; ch < reverb_decay_estimators_.size(); ++ch) {
+    auto& channel = state->capture_channels[ch];
+    channel.reverb_decay = reverb_decay_estimators_[ch]->Decay(/*mild=*/false);
+    const auto frequency_response =
+        reverb_frequency_responses_[ch].FrequencyResponse();
+    std::copy(frequency_response.begin(), frequency_response.end(),
+              channel.reverb_frequency_response.begin());
+  }
+}
+
+void ReverbModelEstimator::RestoreWarmStartState(
+    const Aec3WarmStartState& state) {
+  RTC_DCHECK_EQ(state.capture_channels.size(),
+                reverb_decay_estimators_.size());
+  for (size_t ch = 0; ch < reverb_decay_estimators_.size(); ++ch) {
+    const auto& channel = state.capture_channels[ch];
+    reverb_decay_estimators_[ch]->SetDecay(channel.reverb_decay);
+    reverb_frequency_responses_[ch].SetFrequencyResponse(
+        channel.reverb_frequency_response);
+  }
+}
+
 void ReverbModelEstimator::Update(
     rtc::ArrayView<const std::vector<float>> impulse_responses,
     rtc::ArrayView<const std::vector<std::array<float, kFftLengthBy2Plus1>>>
@@ -21,6 +21,7 @@
 #include "modules/audio_processing/aec3/aec3_common.h"  // kFftLengthBy2Plus1
 #include "modules/audio_processing/aec3/reverb_decay_estimator.h"
 #include "modules/audio_processing/aec3/reverb_frequency_response.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 
 namespace webrtc {
 
@@ -57,6 +58,10 @@ class ReverbModelEstimator {
     return reverb_frequency_responses_[0].FrequencyResponse();
   }
 
+  // Saves and restores the estimated decays and frequency responses.
+  void SaveWarmStartState(Aec3WarmStartState* state) const;
+  void RestoreWarmStartState(const Aec3WarmStartState& state);
+
   // Dumps debug data.
   void Dump(ApmDataDumper* data_dumper) const {
     reverb_decay_estimators_[0]->Dump(data_dumper);
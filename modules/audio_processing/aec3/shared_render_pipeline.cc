@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/shared_render_pipeline.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "api/make_ref_counted.h"
+#include "modules/audio_processing/aec3/fft_data.h"
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+bool SameAlignmentMixing(
+    const EchoCanceller3Config::Delay::AlignmentMixing& a,
+    const EchoCanceller3Config::Delay::AlignmentMixing& b) {
+  return a.downmix == b.downmix &&
+         a.adaptive_selection == b.adaptive_selection &&
+         a.activity_power_threshold == b.activity_power_threshold &&
+         a.prefer_first_two_channels == b.prefer_first_two_channels;
+}
+
+}  // namespace
+
+std::atomic<int> SharedRenderPipeline::instance_count_(0);
+
+rtc::scoped_refptr<SharedRenderPipeline> SharedRenderPipeline::Create(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    size_t num_render_channels) {
+  return rtc::make_ref_counted<SharedRenderPipeline>(config, sample_rate_hz,
+                                                     num_render_channels);
+}
+
+SharedRenderPipeline::SharedRenderPipeline(const EchoCanceller3Config& config,
+                                           int sample_rate_hz,
+                                           size_t num_render_channels)
+    : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
+      optimization_(DetectOptimization()),
+      config_(config),
+      sample_rate_hz_(sample_rate_hz),
+      render_linear_amplitude_gain_(
+          std::pow(10.0f, config_.render_levels.render_power_gain_db / 20.f)),
+      down_sampling_factor_(config.delay.down_sampling_factor),
+      sub_block_size_(static_cast<int>(down_sampling_factor_ > 0
+                                           ? kBlockSize / down_sampling_factor_
+                                           : kBlockSize)),
+      blocks_(GetRenderDelayBufferSize(down_sampling_factor_,
+                                       config.delay.num_filters,
+                                       config.filter.refined.length_blocks),
+              NumBandsForRate(sample_rate_hz),
+              num_render_channels),
+      spectra_(blocks_.buffer.size(), num_render_channels),
+      ffts_(blocks_.buffer.size(), num_render_channels),
+      low_rate_(GetDownSampledBufferSize(down_sampling_factor_,
+                                         config.delay.num_filters)),
+      render_mixer_(num_render_channels, config.delay.render_alignment_mixing),
+      render_decimator_(down_sampling_factor_),
+      fft_(),
+      render_ds_(sub_block_size_, 0.f) {}
+
+SharedRenderPipeline::~SharedRenderPipeline() = default;
+
+bool SharedRenderPipeline::IsCompatible(const EchoCanceller3Config& config,
+                                        int sample_rate_hz,
+                                        size_t num_render_channels) const {
+  return sample_rate_hz == sample_rate_hz_ &&
+         num_render_channels ==
+             static_cast<size_t>(blocks_.buffer[0].NumChannels()) &&
+         config.delay.down_sampling_factor == down_sampling_factor_ &&
+         config.delay.num_filters == config_.delay.num_filters &&
+         config.filter.refined.length_blocks ==
+             config_.filter.refined.length_blocks &&
+         config.render_levels.render_power_gain_db ==
+             config_.render_levels.render_power_gain_db &&
+         SameAlignmentMixing(config.delay.render_alignment_mixing,
+                             config_.delay.render_alignment_mixing);
+}
+
+int64_t SharedRenderPipeline::Attach(BlockBuffer* blocks,
+                                     SpectrumBuffer* spectra,
+                                     FftBuffer* ffts,
+                                     DownsampledRenderBuffer* low_rate) const {
+  RTC_DCHECK(blocks);
+  RTC_DCHECK(spectra);
+  RTC_DCHECK(ffts);
+  RTC_DCHECK(low_rate);
+  RTC_DCHECK_EQ(&blocks_.buffer, &blocks->buffer);
+  RTC_DCHECK_EQ(&spectra_.buffer, &spectra->buffer);
+  RTC_DCHECK_EQ(&ffts_.buffer, &ffts->buffer);
+  RTC_DCHECK_EQ(&low_rate_.buffer, &low_rate->buffer);
+  MutexLock lock(&mutex_);
+  blocks->write = blocks_.write;
+  spectra->write = spectra_.write;
+  ffts->write = ffts_.write;
+  low_rate->write = low_rate_.write;
+  return num_inserted_blocks_;
+}
+
+void SharedRenderPipeline::Insert(int64_t block_index, const Block& block) {
+  MutexLock lock(&mutex_);
+  if (block_index < num_inserted_blocks_) {
+    return;
+  }
+  RTC_DCHECK_EQ(block_index, num_inserted_blocks_);
+  ++num_inserted_blocks_;
+
+  const int previous_write = blocks_.write;
+  low_rate_.UpdateWriteIndex(-sub_block_size_);
+  blocks_.IncWriteIndex();
+  spectra_.DecWriteIndex();
+  ffts_.DecWriteIndex();
+  InsertBlock(block, previous_write);
+}
+
+// Inserts a block into the render buffers.
+void SharedRenderPipeline::InsertBlock(const Block& block,
+                                       int previous_write) {
+  auto& b = blocks_;
+  auto& lr = low_rate_;
+  auto& ds = render_ds_;
+  auto& f = ffts_;
+  auto& s = spectra_;
+  const size_t num_bands = b.buffer[b.write].NumBands();
+  const size_t num_render_channels = b.buffer[b.write].NumChannels();
+  RTC_DCHECK_EQ(block.NumBands(), num_bands);
+  RTC_DCHECK_EQ(block.NumChannels(), num_render_channels);
+  for (size_t band = 0; band < num_bands; ++band) {
+    for (size_t ch = 0; ch < num_render_channels; ++ch) {
+      std::copy(block.begin(band, ch), block.end(band, ch),
+                b.buffer[b.write].begin(band, ch));
+    }
+  }
+
+  if (render_linear_amplitude_gain_ != 1.f) {
+    for (size_t band = 0; band < num_bands; ++band) {
+      for (size_t ch = 0; ch < num_render_channels; ++ch) {
+        rtc::ArrayView<float, kBlockSize> b_view =
+            b.buffer[b.write].View(band, ch);
+        for (float& sample : b_view) {
+          sample *= render_linear_amplitude_gain_;
+        }
+      }
+    }
+  }
+
+  std::array<float, kBlockSize> downmixed_render;
+  render_mixer_.ProduceOutput(b.buffer[b.write], downmixed_render);
+  render_decimator_.Decimate(downmixed_render, ds);
+  data_dumper_->DumpWav("aec3_render_decimator_output", ds.size(), ds.data(),
+                        16000 / down_sampling_factor_, 1);
+  std::copy(ds.rbegin(), ds.rend(), lr.buffer.begin() + lr.write);
+  FftData X;
+  for (int channel = 0; channel < b.buffer[b.write].NumChannels(); ++channel) {
+    fft_.PaddedFft(b.buffer[b.write].View(/*band=*/0, channel),
+                   b.buffer[previous_write].View(/*band=*/0, channel), &X);
+    f.buffer[f.write][channel].CopyFrom(X);
+    X.Spectrum(optimization_, s.buffer[s.write][channel]);
+  }
+}
+
+}  // namespace webrtc
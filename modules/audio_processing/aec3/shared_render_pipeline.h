@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_PIPELINE_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_PIPELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/audio/echo_canceller3_config.h"
+#include "api/scoped_refptr.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/aec3_fft.h"
+#include "modules/audio_processing/aec3/alignment_mixer.h"
+#include "modules/audio_processing/aec3/block.h"
+#include "modules/audio_processing/aec3/block_buffer.h"
+#include "modules/audio_processing/aec3/decimator.h"
+#include "modules/audio_processing/aec3/downsampled_render_buffer.h"
+#include "modules/audio_processing/aec3/fft_buffer.h"
+#include "modules/audio_processing/aec3/spectrum_buffer.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class ApmDataDumper;
+
+// Computes and stores the render data that is read through a
+// RenderDelayBuffer: the render blocks, their FFTs and spectra, and the
+// decimated render signal used for the delay estimation.
+//
+// A pipeline may be shared by the render delay buffers of several echo
+// cancellers that cancel the echo of the same render signal, e.g., those of
+// the capture streams of the participants in a conference. The render data is
+// then computed once, while each render delay buffer keeps its own read
+// indices and delay. All the users must insert the same sequence of render
+// blocks. A block is processed by the first user that inserts it, and the
+// other users only advance their write indices. The users may run on
+// different threads, but a user that lags behind the first one by more than
+// the headroom of the buffers reads overwritten data.
+class SharedRenderPipeline : public rtc::RefCountInterface {
+ public:
+  static rtc::scoped_refptr<SharedRenderPipeline> Create(
+      const EchoCanceller3Config& config,
+      int sample_rate_hz,
+      size_t num_render_channels);
+
+  SharedRenderPipeline(const EchoCanceller3Config& config,
+                       int sample_rate_hz,
+                       size_t num_render_channels);
+  ~SharedRenderPipeline() override;
+
+  SharedRenderPipeline(const SharedRenderPipeline&) = delete;
+  SharedRenderPipeline& operator=(const SharedRenderPipeline&) = delete;
+
+  // Returns whether the pipeline computes the render data of a render delay
+  // buffer with the specified setup.
+  bool IsCompatible(const EchoCanceller3Config& config,
+                    int sample_rate_hz,
+                    size_t num_render_channels) const;
+
+  // Sets the write indices of buffers that share the storage of the pipeline
+  // to where the next block will be written, and returns the index of that
+  // block in the sequence of inserted blocks.
+  int64_t Attach(BlockBuffer* blocks,
+                 SpectrumBuffer* spectra,
+                 FftBuffer* ffts,
+                 DownsampledRenderBuffer* low_rate) const;
+
+  // Inserts the render block with index `block_index` in the sequence of
+  // inserted blocks, unless it has already been inserted.
+  void Insert(int64_t block_index, const Block& block);
+
+  // Returns the buffers whose storage is shared by the users.
+  BlockBuffer* blocks() { return &blocks_; }
+  SpectrumBuffer* spectra() { return &spectra_; }
+  FftBuffer* ffts() { return &ffts_; }
+  DownsampledRenderBuffer* low_rate() { return &low_rate_; }
+
+ private:
+  void InsertBlock(const Block& block, int previous_write)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  static std::atomic<int> instance_count_;
+  std::unique_ptr<ApmDataDumper> data_dumper_;
+  const Aec3Optimization optimization_;
+  const EchoCanceller3Config config_;
+  const int sample_rate_hz_;
+  const float render_linear_amplitude_gain_;
+  const size_t down_sampling_factor_;
+  const int sub_block_size_;
+  mutable Mutex mutex_;
+  int64_t num_inserted_blocks_ RTC_GUARDED_BY(mutex_) = 0;
+  BlockBuffer blocks_;
+  SpectrumBuffer spectra_;
+  FftBuffer ffts_;
+  DownsampledRenderBuffer low_rate_;
+  AlignmentMixer render_mixer_ RTC_GUARDED_BY(mutex_);
+  Decimator render_decimator_ RTC_GUARDED_BY(mutex_);
+  const Aec3Fft fft_;
+  std::vector<float> render_ds_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_PIPELINE_H_
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/shared_render_pipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/render_delay_buffer.h"
+#include "rtc_base/random.h"
+#include "rtc_base/strings/string_builder.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumUsers = 3;
+
+std::string ProduceDebugText(int sample_rate_hz, size_t num_channels) {
+  rtc::StringBuilder ss;
+  ss << "Sample rate: " << sample_rate_hz;
+  ss << ", number of channels: " << num_channels;
+  return ss.Release();
+}
+
+void RandomizeBlock(Random* random_generator, Block* block) {
+  for (int band = 0; band < block->NumBands(); ++band) {
+    for (int ch = 0; ch < block->NumChannels(); ++ch) {
+      for (float& x : block->View(band, ch)) {
+        x = 32000.f * (random_generator->Rand<float>() - 0.5f);
+      }
+    }
+  }
+}
+
+// Verifies that two render delay buffers provide the same render data.
+void VerifyIdenticalBuffers(RenderDelayBuffer* a, RenderDelayBuffer* b) {
+  EXPECT_EQ(a->Delay(), b->Delay());
+
+  const RenderBuffer& render_a = *a->GetRenderBuffer();
+  const RenderBuffer& render_b = *b->GetRenderBuffer();
+  const Block& block_a = render_a.GetBlock(/*buffer_offset_blocks=*/0);
+  const Block& block_b = render_b.GetBlock(/*buffer_offset_blocks=*/0);
+  for (int band = 0; band < block_a.NumBands(); ++band) {
+    for (int ch = 0; ch < block_a.NumChannels(); ++ch) {
+      auto view_a = block_a.View(band, ch);
+      auto view_b = block_b.View(band, ch);
+      EXPECT_TRUE(std::equal(view_a.begin(), view_a.end(), view_b.begin()));
+    }
+  }
+
+  const auto spectrum_a = render_a.Spectrum(/*buffer_offset_ffts=*/0);
+  const auto spectrum_b = render_b.Spectrum(/*buffer_offset_ffts=*/0);
+  ASSERT_EQ(spectrum_a.size(), spectrum_b.size());
+  for (size_t ch = 0; ch < spectrum_a.size(); ++ch) {
+    EXPECT_EQ(spectrum_a[ch], spectrum_b[ch]);
+  }
+
+  const auto& fft_a = render_a.GetFftBuffer()[render_a.Position()];
+  const auto& fft_b = render_b.GetFftBuffer()[render_b.Position()];
+  ASSERT_EQ(fft_a.size(), fft_b.size());
+  for (size_t ch = 0; ch < fft_a.size(); ++ch) {
+    EXPECT_EQ(fft_a[ch].re, fft_b[ch].re);
+    EXPECT_EQ(fft_a[ch].im, fft_b[ch].im);
+  }
+
+  const DownsampledRenderBuffer& low_rate_a = a->GetDownsampledRenderBuffer();
+  const DownsampledRenderBuffer& low_rate_b = b->GetDownsampledRenderBuffer();
+  for (int k = 0; k < kBlockSize; ++k) {
+    EXPECT_EQ(
+        low_rate_a.buffer[low_rate_a.OffsetIndex(low_rate_a.read, k)],
+        low_rate_b.buffer[low_rate_b.OffsetIndex(low_rate_b.read, k)]);
+  }
+}
+
+}  // namespace
+
+// Verifies that render delay buffers sharing a pipeline provide the same
+// render data as render delay buffers with private pipelines, also when they
+// are aligned to different delays and insert the render blocks at different
+// times.
+TEST(SharedRenderPipeline, SharedBuffersMatchPrivateBuffers) {
+  const EchoCanceller3Config config;
+  Random random_generator(42U);
+  for (size_t num_channels : {1, 2}) {
+    for (int rate : {16000, 48000}) {
+      SCOPED_TRACE(ProduceDebugText(rate, num_channels));
+      rtc::scoped_refptr<SharedRenderPipeline> pipeline =
+          SharedRenderPipeline::Create(config, rate, num_channels);
+      std::vector<std::unique_ptr<RenderDelayBuffer>> shared_buffers(
+          kNumUsers);
+      std::vector<std::unique_ptr<RenderDelayBuffer>> private_buffers(
+          kNumUsers);
+      for (size_t user = 0; user < kNumUsers; ++user) {
+        shared_buffers[user].reset(
+            RenderDelayBuffer::Create(config, rate, num_channels, pipeline));
+        private_buffers[user].reset(
+            RenderDelayBuffer::Create(config, rate, num_channels));
+      }
+
+      Block block(NumBandsForRate(rate), num_channels);
+      Block previous_block(NumBandsForRate(rate), num_channels);
+      for (int k = 0; k < 300; ++k) {
+        previous_block = block;
+        RandomizeBlock(&random_generator, &block);
+        for (size_t user = 0; user < kNumUsers; ++user) {
+          // The last user inserts each render block one capture block later
+          // than the other users.
+          const bool late_user = user == kNumUsers - 1;
+          if (!late_user || k > 0) {
+            const Block& render = late_user ? previous_block : block;
+            EXPECT_EQ(shared_buffers[user]->Insert(render),
+                      private_buffers[user]->Insert(render));
+          }
+          EXPECT_EQ(shared_buffers[user]->PrepareCaptureProcessing(),
+                    private_buffers[user]->PrepareCaptureProcessing());
+          if (k == 100) {
+            shared_buffers[user]->AlignFromDelay(2 * user + 1);
+            private_buffers[user]->AlignFromDelay(2 * user + 1);
+          }
+          VerifyIdenticalBuffers(shared_buffers[user].get(),
+                                 private_buffers[user].get());
+        }
+      }
+    }
+  }
+}
+
+// Verifies that the pipeline only accepts render delay buffers with a
+// matching setup.
+TEST(SharedRenderPipeline, Compatibility) {
+  const EchoCanceller3Config config;
+  rtc::scoped_refptr<SharedRenderPipeline> pipeline =
+      SharedRenderPipeline::Create(config, 48000, 2);
+  EXPECT_TRUE(pipeline->IsCompatible(config, 48000, 2));
+  EXPECT_FALSE(pipeline->IsCompatible(config, 32000, 2));
+  EXPECT_FALSE(pipeline->IsCompatible(config, 48000, 1));
+
+  EchoCanceller3Config other_config = config;
+  other_config.delay.delay_headroom_samples += kBlockSize;
+  other_config.render_levels.active_render_limit += 1.f;
+  EXPECT_TRUE(pipeline->IsCompatible(other_config, 48000, 2));
+
+  other_config = config;
+  other_config.render_levels.render_power_gain_db += 6.f;
+  EXPECT_FALSE(pipeline->IsCompatible(other_config, 48000, 2));
+
+  other_config = config;
+  other_config.filter.refined.length_blocks += 1;
+  EXPECT_FALSE(pipeline->IsCompatible(other_config, 48000, 2));
+
+  other_config = config;
+  other_config.delay.render_alignment_mixing.downmix =
+      !config.delay.render_alignment_mixing.downmix;
+  EXPECT_FALSE(pipeline->IsCompatible(other_config, 48000, 2));
+}
+
+}  // namespace webrtc
@@ -16,8 +16,10 @@ namespace webrtc {
 
 SpectrumBuffer::SpectrumBuffer(size_t size, size_t num_channels)
     : size(static_cast<int>(size)),
-      buffer(size,
-             std::vector<std::array<float, kFftLengthBy2Plus1>>(num_channels)) {
+      buffer(storage_),
+      storage_(size,
+               std::vector<std::array<float, kFftLengthBy2Plus1>>(
+                   num_channels)) {
   for (auto& channel : buffer) {
     for (auto& c : channel) {
       std::fill(c.begin(), c.end(), 0.f);
@@ -25,6 +27,9 @@ SpectrumBuffer::SpectrumBuffer(size_t size, size_t num_channels)
   }
 }
 
+SpectrumBuffer::SpectrumBuffer(SpectrumBuffer* other)
+    : size(other->size), buffer(other->buffer) {}
+
 SpectrumBuffer::~SpectrumBuffer() = default;
 
 }  // namespace webrtc
@@ -25,6 +25,11 @@ namespace webrtc {
 // together with the read and write indices.
 struct SpectrumBuffer {
   SpectrumBuffer(size_t size, size_t num_channels);
+  // Creates a buffer with its own read and write indices that shares the
+  // stored spectra with `other`, which must outlive the created buffer.
+  explicit SpectrumBuffer(SpectrumBuffer* other);
+  SpectrumBuffer(const SpectrumBuffer&) = delete;
+  SpectrumBuffer& operator=(const SpectrumBuffer&) = delete;
   ~SpectrumBuffer();
 
   int IncIndex(int index) const {
@@ -52,9 +57,13 @@ struct SpectrumBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>> buffer;
+  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  // Holds the spectra unless they are shared with another buffer.
+  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>> storage_;
 };
 
 }  // namespace webrtc
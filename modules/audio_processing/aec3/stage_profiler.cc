@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/stage_profiler.h"
+
+#include <algorithm>
+
+#include "api/array_view.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+// The profiler bound to the current thread.
+thread_local Aec3StageProfiler* bound_profiler = nullptr;
+#endif
+
+// Returns the smallest duration that has at least `fraction` of the durations
+// in `counts` at or below it.
+int64_t Percentile(rtc::ArrayView<const uint32_t> counts,
+                   int64_t total,
+                   float fraction) {
+  const int64_t rank = std::max<int64_t>(
+      1, static_cast<int64_t>(fraction * static_cast<double>(total) + 0.5));
+  int64_t accumulated = 0;
+  for (size_t k = 0; k < counts.size(); ++k) {
+    accumulated += counts[k];
+    if (accumulated >= rank) {
+      return StageHistogram::BucketUpperBound(k);
+    }
+  }
+  return StageHistogram::BucketUpperBound(counts.size() - 1);
+}
+
+}  // namespace
+
+const char* Aec3StageName(Aec3Stage stage) {
+  switch (stage) {
+    case Aec3Stage::kPrepareCaptureProcessing:
+      return "PrepareCaptureProcessing";
+    case Aec3Stage::kGetDelay:
+      return "GetDelay";
+    case Aec3Stage::kSubtractor:
+      return "Subtractor";
+    case Aec3Stage::kCaptureFft:
+      return "CaptureFft";
+    case Aec3Stage::kResidualEchoEstimator:
+      return "ResidualEchoEstimator";
+    case Aec3Stage::kSuppressionGain:
+      return "SuppressionGain";
+    case Aec3Stage::kSuppressionFilter:
+      return "SuppressionFilter";
+    case Aec3Stage::kNumStages:
+      break;
+  }
+  RTC_DCHECK_NOTREACHED();
+  return "";
+}
+
+StageHistogram::StageHistogram() : max_ns_(0) {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t StageHistogram::BucketIndex(int64_t duration_ns) {
+  const uint64_t value =
+      static_cast<uint64_t>(std::max<int64_t>(0, duration_ns));
+  if (value < kNumLinearBuckets) {
+    return static_cast<size_t>(value);
+  }
+  int exponent = 63;
+  while (!(value >> exponent)) {
+    --exponent;
+  }
+  const size_t sub_bucket =
+      (value >> (exponent - kSubBucketBits)) & ((1 << kSubBucketBits) - 1);
+  return kNumLinearBuckets +
+         static_cast<size_t>(exponent - kSubBucketBits - 1) *
+             (1 << kSubBucketBits) +
+         sub_bucket;
+}
+
+int64_t StageHistogram::BucketUpperBound(size_t index) {
+  RTC_DCHECK_GT(kNumBuckets, index);
+  if (index < kNumLinearBuckets) {
+    return static_cast<int64_t>(index);
+  }
+  const size_t octave = (index - kNumLinearBuckets) >> kSubBucketBits;
+  const uint64_t sub_bucket =
+      (index - kNumLinearBuckets) & ((1 << kSubBucketBits) - 1);
+  const int shift = static_cast<int>(octave) + 1;
+  return static_cast<int64_t>(
+      (((1ull << kSubBucketBits) + sub_bucket + 1) << shift) - 1);
+}
+
+void StageHistogram::Add(int64_t duration_ns) {
+  buckets_[BucketIndex(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+  int64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (duration_ns > max_ns &&
+         !max_ns_.compare_exchange_weak(max_ns, duration_ns,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+Aec3StageStats::Stage StageHistogram::GetStats() const {
+  std::array<uint32_t, kNumBuckets> counts;
+  int64_t total = 0;
+  for (size_t k = 0; k < kNumBuckets; ++k) {
+    counts[k] = buckets_[k].load(std::memory_order_relaxed);
+    total += counts[k];
+  }
+
+  Aec3StageStats::Stage stats;
+  stats.count = total;
+  if (total == 0) {
+    return stats;
+  }
+  stats.max_ns = max_ns_.load(std::memory_order_relaxed);
+  stats.p50_ns = std::min(stats.max_ns, Percentile(counts, total, 0.5f));
+  stats.p99_ns = std::min(stats.max_ns, Percentile(counts, total, 0.99f));
+  stats.p999_ns = std::min(stats.max_ns, Percentile(counts, total, 0.999f));
+  return stats;
+}
+
+Aec3StageStats Aec3StageProfiler::GetStats() const {
+  Aec3StageStats stats;
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  stats.enabled = true;
+  for (size_t k = 0; k < kNumAec3Stages; ++k) {
+    stats.stages[k] = histograms_[k].GetStats();
+  }
+#endif
+  return stats;
+}
+
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+ScopedStageProfilerBinding::ScopedStageProfilerBinding(
+    Aec3StageProfiler* profiler)
+    : previous_(bound_profiler) {
+  bound_profiler = profiler;
+}
+
+ScopedStageProfilerBinding::~ScopedStageProfilerBinding() {
+  bound_profiler = previous_;
+}
+
+ScopedStageTimer::ScopedStageTimer(Aec3Stage stage)
+    : profiler_(bound_profiler),
+      stage_(stage),
+      start_ns_(profiler_ ? rtc::TimeNanos() : 0) {}
+
+ScopedStageTimer::~ScopedStageTimer() {
+  if (profiler_) {
+    profiler_->Add(stage_, rtc::TimeNanos() - start_ns_);
+  }
+}
+#endif
+
+}  // namespace webrtc
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_STAGE_PROFILER_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_STAGE_PROFILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#if !defined(WEBRTC_AEC3_STAGE_PROFILING)
+#define WEBRTC_AEC3_STAGE_PROFILING 0
+#endif
+
+// Check to verify that the define is properly set.
+#if WEBRTC_AEC3_STAGE_PROFILING != 0 && WEBRTC_AEC3_STAGE_PROFILING != 1
+#error "Set WEBRTC_AEC3_STAGE_PROFILING to either 0 or 1"
+#endif
+
+namespace webrtc {
+
+// Processing stages of the capture path whose execution times are profiled.
+enum class Aec3Stage {
+  kPrepareCaptureProcessing = 0,
+  kGetDelay,
+  kSubtractor,
+  kCaptureFft,
+  kResidualEchoEstimator,
+  kSuppressionGain,
+  kSuppressionFilter,
+  kNumStages
+};
+
+constexpr size_t kNumAec3Stages = static_cast<size_t>(Aec3Stage::kNumStages);
+
+// Returns a printable name of the stage.
+const char* Aec3StageName(Aec3Stage stage);
+
+// Execution time statistics of the profiled stages. The percentiles are upper
+// bounds with a relative resolution of 1/8.
+struct Aec3StageStats {
+  struct Stage {
+    int64_t count = 0;
+    int64_t p50_ns = 0;
+    int64_t p99_ns = 0;
+    int64_t p999_ns = 0;
+    int64_t max_ns = 0;
+  };
+  // Whether the stages are profiled, i.e., whether the code was built with
+  // WEBRTC_AEC3_STAGE_PROFILING set to 1.
+  bool enabled = false;
+  std::array<Stage, kNumAec3Stages> stages;
+};
+
+// Histogram of durations with logarithmically spaced buckets, each octave
+// divided into 8 buckets. Adding values is lock-free and may be done
+// concurrently with reading the statistics.
+class StageHistogram {
+ public:
+  StageHistogram();
+
+  // Adds a duration.
+  void Add(int64_t duration_ns);
+
+  // Returns the statistics of the added durations.
+  Aec3StageStats::Stage GetStats() const;
+
+  // Returns the bucket index of a duration, and the largest duration in a
+  // bucket. Exposed for testing.
+  static size_t BucketIndex(int64_t duration_ns);
+  static int64_t BucketUpperBound(size_t index);
+
+ private:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr size_t kNumLinearBuckets = 2 << kSubBucketBits;
+  static constexpr size_t kNumBuckets =
+      kNumLinearBuckets + (63 - kSubBucketBits - 1) * (1 << kSubBucketBits);
+
+  std::array<std::atomic<uint32_t>, kNumBuckets> buckets_;
+  std::atomic<int64_t> max_ns_;
+};
+
+// Per-instance profiler of the capture path stages. The stages are timed by
+// ScopedStageTimer objects on the thread that is bound to the profiler using
+// a ScopedStageProfilerBinding. Without WEBRTC_AEC3_STAGE_PROFILING the
+// profiler holds no state and the timers compile to nothing.
+class Aec3StageProfiler {
+ public:
+  Aec3StageProfiler() = default;
+  Aec3StageProfiler(const Aec3StageProfiler&) = delete;
+  Aec3StageProfiler& operator=(const Aec3StageProfiler&) = delete;
+
+  // Adds an execution time of a stage.
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  void Add(Aec3Stage stage, int64_t duration_ns) {
+    histograms_[static_cast<size_t>(stage)].Add(duration_ns);
+  }
+#else
+  void Add(Aec3Stage /*stage*/, int64_t /*duration_ns*/) {}
+#endif
+
+  // Returns the statistics of all stages. May be called from any thread.
+  Aec3StageStats GetStats() const;
+
+ private:
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  std::array<StageHistogram, kNumAec3Stages> histograms_;
+#endif
+};
+
+// Binds a profiler to the current thread for the lifetime of the object.
+class ScopedStageProfilerBinding {
+ public:
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  explicit ScopedStageProfilerBinding(Aec3StageProfiler* profiler);
+  ~ScopedStageProfilerBinding();
+#else
+  explicit ScopedStageProfilerBinding(Aec3StageProfiler* /*profiler*/) {}
+#endif
+  ScopedStageProfilerBinding(const ScopedStageProfilerBinding&) = delete;
+  ScopedStageProfilerBinding& operator=(const ScopedStageProfilerBinding&) =
+      delete;
+
+ private:
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  Aec3StageProfiler* const previous_;
+#endif
+};
+
+// Measures the time from construction to destruction and adds it to the
+// profiler bound to the current thread, if any.
+class ScopedStageTimer {
+ public:
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  explicit ScopedStageTimer(Aec3Stage stage);
+  ~ScopedStageTimer();
+#else
+  explicit ScopedStageTimer(Aec3Stage /*stage*/) {}
+#endif
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+ private:
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  Aec3StageProfiler* const profiler_;
+  const Aec3Stage stage_;
+  const int64_t start_ns_;
+#endif
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_STAGE_PROFILER_H_
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/stage_profiler.h"
+
+#include <limits>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+// Verifies that every duration falls into a bucket whose bounds are within
+// the stated resolution.
+TEST(StageHistogram, BucketResolution) {
+  for (int64_t value = 0; value < (int64_t{1} << 40);
+       value = value * 9 / 8 + 1) {
+    const size_t index = StageHistogram::BucketIndex(value);
+    const int64_t upper = StageHistogram::BucketUpperBound(index);
+    EXPECT_LE(value, upper);
+    EXPECT_LE(static_cast<double>(upper - value), value / 8.0);
+    if (index > 0) {
+      EXPECT_LT(StageHistogram::BucketUpperBound(index - 1), value);
+    }
+  }
+  const int64_t max_value = std::numeric_limits<int64_t>::max();
+  EXPECT_EQ(max_value, StageHistogram::BucketUpperBound(
+                           StageHistogram::BucketIndex(max_value)));
+}
+
+TEST(StageHistogram, Percentiles) {
+  StageHistogram histogram;
+  EXPECT_EQ(0, histogram.GetStats().count);
+
+  // 1000 durations of 1 to 1000 us.
+  for (int k = 1; k <= 1000; ++k) {
+    histogram.Add(k * 1000);
+  }
+  const Aec3StageStats::Stage stats = histogram.GetStats();
+  EXPECT_EQ(1000, stats.count);
+  EXPECT_EQ(1000000, stats.max_ns);
+  EXPECT_LE(500000, stats.p50_ns);
+  EXPECT_GE(500000 * 9 / 8, stats.p50_ns);
+  EXPECT_LE(990000, stats.p99_ns);
+  EXPECT_GE(1000000, stats.p99_ns);
+  EXPECT_LE(stats.p99_ns, stats.p999_ns);
+  EXPECT_GE(stats.max_ns, stats.p999_ns);
+}
+
+// Verifies that the timers report to the profiler bound to the thread, and
+// only when profiling is compiled in.
+TEST(Aec3StageProfiler, ScopedTimers) {
+  Aec3StageProfiler profiler;
+  { ScopedStageTimer unbound_timer(Aec3Stage::kSubtractor); }
+  {
+    ScopedStageProfilerBinding binding(&profiler);
+    { ScopedStageTimer timer(Aec3Stage::kSubtractor); }
+    { ScopedStageTimer timer(Aec3Stage::kSuppressionGain); }
+    { ScopedStageTimer timer(Aec3Stage::kSuppressionGain); }
+  }
+  { ScopedStageTimer unbound_timer(Aec3Stage::kSuppressionGain); }
+
+  const Aec3StageStats stats = profiler.GetStats();
+  const auto& subtractor =
+      stats.stages[static_cast<size_t>(Aec3Stage::kSubtractor)];
+  const auto& suppression_gain =
+      stats.stages[static_cast<size_t>(Aec3Stage::kSuppressionGain)];
+  const auto& get_delay =
+      stats.stages[static_cast<size_t>(Aec3Stage::kGetDelay)];
+#if WEBRTC_AEC3_STAGE_PROFILING == 1
+  EXPECT_TRUE(stats.enabled);
+  EXPECT_EQ(1, subtractor.count);
+  EXPECT_EQ(2, suppression_gain.count);
+#else
+  EXPECT_FALSE(stats.enabled);
+  EXPECT_EQ(0, subtractor.count);
+  EXPECT_EQ(0, suppression_gain.count);
+#endif
+  EXPECT_EQ(0, get_delay.count);
+}
+
+}  // namespace webrtc
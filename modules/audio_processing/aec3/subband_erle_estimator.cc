@@ -71,6 +71,18 @@ void SubbandErleEstimator::Reset() {
   ResetAccumulatedSpectra();
 }
 
+void SubbandErleEstimator::SetErle(
+    size_t channel,
+    const std::array<float, kFftLengthBy2Plus1>& erle,
+    const std::array<float, kFftLengthBy2Plus1>& erle_onset_compensated,
+    const std::array<float, kFftLengthBy2Plus1>& erle_unbounded) {
+  RTC_DCHECK_LT(channel, erle_.size());
+  erle_[channel] = erle;
+  erle_onset_compensated_[channel] = erle_onset_compensated;
+  erle_unbounded_[channel] = erle_unbounded;
+  hold_counters_[channel].fill(0);
+}
+
 void SubbandErleEstimator::Update(
     rtc::ArrayView<const float, kFftLengthBy2Plus1> X2,
     rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> Y2,
@@ -40,6 +40,13 @@ class SubbandErleEstimator {
               rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> E2,
               const std::vector<bool>& converged_filters);
 
+  // Sets the ERLE estimates of a capture channel.
+  void SetErle(
+      size_t channel,
+      const std::array<float, kFftLengthBy2Plus1>& erle,
+      const std::array<float, kFftLengthBy2Plus1>& erle_onset_compensated,
+      const std::array<float, kFftLengthBy2Plus1>& erle_unbounded);
+
   // Returns the ERLE estimate.
   rtc::ArrayView<const std::array<float, kFftLengthBy2Plus1>> Erle(
       bool onset_compensated) const {
@@ -92,7 +92,9 @@ Subtractor::Subtractor(const EchoCanceller3Config& config,
                                  config_.filter.refined_initial.length_blocks,
                                  config_.filter.refined.length_blocks)),
                              0.f)),
-      coarse_impulse_responses_(0) {
+      coarse_impulse_responses_(0),
+      refined_filter_size_partitions_(
+          config_.filter.refined_initial.length_blocks) {
   // Set up the storing of coarse impulse responses if data dumping is
   // available.
   if (ApmDataDumper::IsAvailable()) {
@@ -145,11 +147,11 @@ void Subtractor::HandleEchoPathChange(
       coarse_gains_[ch]->HandleEchoPathChange();
       refined_gains_[ch]->SetConfig(config_.filter.refined_initial, true);
       coarse_gains_[ch]->SetConfig(config_.filter.coarse_initial, true);
-      refined_filters_[ch]->SetSizePartitions(
-          config_.filter.refined_initial.length_blocks, true);
       coarse_filter_[ch]->SetSizePartitions(
           config_.filter.coarse_initial.length_blocks, true);
     }
+    SetRefinedFilterSizePartitions(
+        config_.filter.refined_initial.length_blocks, true);
   };
 
   if (echo_path_variability.delay_change !=
@@ -168,11 +170,62 @@ void Subtractor::ExitInitialState() {
   for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
     refined_gains_[ch]->SetConfig(config_.filter.refined, false);
     coarse_gains_[ch]->SetConfig(config_.filter.coarse, false);
-    refined_filters_[ch]->SetSizePartitions(
-        config_.filter.refined.length_blocks, false);
     coarse_filter_[ch]->SetSizePartitions(config_.filter.coarse.length_blocks,
                                           false);
   }
+  SetRefinedFilterSizePartitions(config_.filter.refined.length_blocks, false);
+}
+
+void Subtractor::SaveWarmStartState(Aec3WarmStartState* state) const {
+  RTC_DCHECK_EQ(state->capture_channels.size(), num_capture_channels_);
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    auto& channel = state->capture_channels[ch];
+    channel.refined_filter = refined_filters_[ch]->GetCoefficients();
+    channel.coarse_filter = coarse_filter_[ch]->GetCoefficients();
+    channel.refined_filter_error = refined_gains_[ch]->FilterError();
+  }
+}
+
+void Subtractor::RestoreWarmStartState(const Aec3WarmStartState& state) {
+  RTC_DCHECK_EQ(state.capture_channels.size(), num_capture_channels_);
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    const auto& channel = state.capture_channels[ch];
+    refined_gains_[ch]->SetConfig(config_.filter.refined, true);
+    coarse_gains_[ch]->SetConfig(config_.filter.coarse, true);
+    refined_gains_[ch]->SetFilterError(channel.refined_filter_error);
+
+    // Restore the filters with their saved sizes and let them transition to
+    // the configured sizes as when exiting the initial state.
+    refined_filters_[ch]->SetCoefficients(channel.refined_filter);
+    coarse_filter_[ch]->SetCoefficients(channel.coarse_filter);
+    coarse_filter_[ch]->SetSizePartitions(config_.filter.coarse.length_blocks,
+                                          false);
+  }
+  SetRefinedFilterSizePartitions(config_.filter.refined.length_blocks, false);
+}
+
+void Subtractor::SetComputeTier(Aec3ComputeTier tier) {
+  const bool reduced_filter_length_changed =
+      (tier >= Aec3ComputeTier::kReducedFilterLength) !=
+      (compute_tier_ >= Aec3ComputeTier::kReducedFilterLength);
+  compute_tier_ = tier;
+  if (tier < Aec3ComputeTier::kReducedCoarseAdaptation) {
+    skip_coarse_filter_adaptation_ = false;
+  }
+  if (reduced_filter_length_changed) {
+    SetRefinedFilterSizePartitions(refined_filter_size_partitions_, false);
+  }
+}
+
+void Subtractor::SetRefinedFilterSizePartitions(size_t size_partitions,
+                                                bool immediate_effect) {
+  refined_filter_size_partitions_ = size_partitions;
+  if (compute_tier_ >= Aec3ComputeTier::kReducedFilterLength) {
+    size_partitions = std::max<size_t>(size_partitions / 2, 1);
+  }
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    refined_filters_[ch]->SetSizePartitions(size_partitions, immediate_effect);
+  }
 }
 
 void Subtractor::Process(const RenderBuffer& render_buffer,
@@ -275,34 +328,37 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
       data_dumper_->DumpRaw("aec3_subtractor_G_refined", G.im);
     }
 
-    // Update the coarse filter.
-    poor_coarse_filter_counters_[ch] =
-        output.e2_refined < output.e2_coarse
-            ? poor_coarse_filter_counters_[ch] + 1
-            : 0;
-    if (poor_coarse_filter_counters_[ch] < 5) {
-      coarse_gains_[ch]->Compute(X2_coarse, render_signal_analyzer, E_coarse,
-                                 coarse_filter_[ch]->SizePartitions(),
-                                 aec_state.SaturatedCapture(), &G);
-      coarse_filter_reset_hangover_[ch] =
-          std::max(coarse_filter_reset_hangover_[ch] - 1, 0);
-    } else {
-      poor_coarse_filter_counters_[ch] = 0;
-      coarse_filter_[ch]->SetFilter(refined_filters_[ch]->SizePartitions(),
-                                    refined_filters_[ch]->GetFilter());
-      coarse_gains_[ch]->Compute(X2_coarse, render_signal_analyzer, E_refined,
-                                 coarse_filter_[ch]->SizePartitions(),
-                                 aec_state.SaturatedCapture(), &G);
-      coarse_filter_reset_hangover_[ch] =
-          config_.filter.coarse_reset_hangover_blocks;
-    }
+    // Update the coarse filter. With a reduced compute tier the coarse filter
+    // is only adapted every other block.
+    if (!skip_coarse_filter_adaptation_) {
+      poor_coarse_filter_counters_[ch] =
+          output.e2_refined < output.e2_coarse
+              ? poor_coarse_filter_counters_[ch] + 1
+              : 0;
+      if (poor_coarse_filter_counters_[ch] < 5) {
+        coarse_gains_[ch]->Compute(X2_coarse, render_signal_analyzer, E_coarse,
+                                   coarse_filter_[ch]->SizePartitions(),
+                                   aec_state.SaturatedCapture(), &G);
+        coarse_filter_reset_hangover_[ch] =
+            std::max(coarse_filter_reset_hangover_[ch] - 1, 0);
+      } else {
+        poor_coarse_filter_counters_[ch] = 0;
+        coarse_filter_[ch]->SetFilter(refined_filters_[ch]->SizePartitions(),
+                                      refined_filters_[ch]->GetFilter());
+        coarse_gains_[ch]->Compute(X2_coarse, render_signal_analyzer, E_refined,
+                                   coarse_filter_[ch]->SizePartitions(),
+                                   aec_state.SaturatedCapture(), &G);
+        coarse_filter_reset_hangover_[ch] =
+            config_.filter.coarse_reset_hangover_blocks;
+      }
 
-    if (ApmDataDumper::IsAvailable()) {
-      RTC_DCHECK_LT(ch, coarse_impulse_responses_.size());
-      coarse_filter_[ch]->Adapt(render_buffer, G,
-                                &coarse_impulse_responses_[ch]);
-    } else {
-      coarse_filter_[ch]->Adapt(render_buffer, G);
+      if (ApmDataDumper::IsAvailable()) {
+        RTC_DCHECK_LT(ch, coarse_impulse_responses_.size());
+        coarse_filter_[ch]->Adapt(render_buffer, G,
+                                  &coarse_impulse_responses_[ch]);
+      } else {
+        coarse_filter_[ch]->Adapt(render_buffer, G);
+      }
     }
 
     if (ch == 0) {
@@ -322,6 +378,10 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
                             &e_coarse[0], 16000, 1);
     }
   }
+
+  if (compute_tier_ >= Aec3ComputeTier::kReducedCoarseAdaptation) {
+    skip_coarse_filter_adaptation_ = !skip_coarse_filter_adaptation_;
+  }
 }
 
 void Subtractor::FilterMisadjustmentEstimator::Update(
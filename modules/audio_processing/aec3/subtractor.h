@@ -30,6 +30,7 @@
 #include "modules/audio_processing/aec3/render_buffer.h"
 #include "modules/audio_processing/aec3/render_signal_analyzer.h"
 #include "modules/audio_processing/aec3/subtractor_output.h"
+#include "modules/audio_processing/aec3/warm_start_state.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 
@@ -59,6 +60,17 @@ class Subtractor {
   // Exits the initial state.
   void ExitInitialState();
 
+  // Saves the coefficients of the adaptive filters and the estimated
+  // misadjustment of the refined filters into `state`.
+  void SaveWarmStartState(Aec3WarmStartState* state) const;
+
+  // Restores the adaptive filters from `state` and exits the initial state.
+  // The filters must fit within the maximum filter sizes of the config.
+  void RestoreWarmStartState(const Aec3WarmStartState& state);
+
+  // Reduces the complexity of the adaptive filtering according to `tier`.
+  void SetComputeTier(Aec3ComputeTier tier);
+
   // Returns the block-wise frequency responses for the refined adaptive
   // filters.
   const std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>&
@@ -143,6 +155,16 @@ class Subtractor {
       refined_frequency_responses_;
   std::vector<std::vector<float>> refined_impulse_responses_;
   std::vector<std::vector<float>> coarse_impulse_responses_;
+
+  // Size of the refined filters before the compute tier is applied.
+  size_t refined_filter_size_partitions_;
+  Aec3ComputeTier compute_tier_ = Aec3ComputeTier::kFull;
+  bool skip_coarse_filter_adaptation_ = false;
+
+  // Sets the size of the refined filters to `size_partitions`, as limited by
+  // the compute tier.
+  void SetRefinedFilterSizePartitions(size_t size_partitions,
+                                      bool immediate_effect);
 };
 
 }  // namespace webrtc
@@ -0,0 +1,215 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/warm_start_state.h"
+
+#include <string.h>
+
+#include <cmath>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'A', 'E', 'C', '3'};
+constexpr uint8_t kVersion = 1;
+
+// Bounds on the dimensions, used for rejecting corrupt data before
+// allocating.
+constexpr uint32_t kMaxNumChannels = 128;
+constexpr uint32_t kMaxFilterSize = 1 << 20;
+
+class Writer {
+ public:
+  explicit Writer(std::vector<uint8_t>* data) : data_(data) {}
+
+  void WriteUint8(uint8_t value) { data_->push_back(value); }
+
+  void WriteUint32(uint32_t value) {
+    for (int k = 0; k < 4; ++k) {
+      data_->push_back(static_cast<uint8_t>(value >> (8 * k)));
+    }
+  }
+
+  void WriteFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteUint32(bits);
+  }
+
+  void WriteFloats(rtc::ArrayView<const float> values) {
+    for (float value : values) {
+      WriteFloat(value);
+    }
+  }
+
+ private:
+  std::vector<uint8_t>* const data_;
+};
+
+class Reader {
+ public:
+  explicit Reader(rtc::ArrayView<const uint8_t> data) : data_(data) {}
+
+  bool ReadUint8(uint8_t* value) {
+    if (position_ + 1 > data_.size()) {
+      return false;
+    }
+    *value = data_[position_++];
+    return true;
+  }
+
+  bool ReadUint32(uint32_t* value) {
+    if (position_ + 4 > data_.size()) {
+      return false;
+    }
+    *value = 0;
+    for (int k = 0; k < 4; ++k) {
+      *value |= static_cast<uint32_t>(data_[position_++]) << (8 * k);
+    }
+    return true;
+  }
+
+  bool ReadFloat(float* value) {
+    uint32_t bits;
+    if (!ReadUint32(&bits)) {
+      return false;
+    }
+    memcpy(value, &bits, sizeof(bits));
+    return std::isfinite(*value);
+  }
+
+  bool ReadFloats(rtc::ArrayView<float> values) {
+    for (float& value : values) {
+      if (!ReadFloat(&value)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reads a length-prefixed filter.
+  bool ReadFilter(std::vector<float>* filter) {
+    uint32_t size;
+    if (!ReadUint32(&size) || size > kMaxFilterSize ||
+        size > (data_.size() - position_) / 4) {
+      return false;
+    }
+    filter->resize(size);
+    return ReadFloats(*filter);
+  }
+
+  bool AtEnd() const { return position_ == data_.size(); }
+
+ private:
+  const rtc::ArrayView<const uint8_t> data_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+std::vector<uint8_t> SerializeAec3WarmStartState(
+    const Aec3WarmStartState& state) {
+  std::vector<uint8_t> data;
+  Writer writer(&data);
+  for (uint8_t byte : kMagic) {
+    writer.WriteUint8(byte);
+  }
+  writer.WriteUint8(kVersion);
+  writer.WriteUint32(static_cast<uint32_t>(state.num_render_channels));
+  writer.WriteUint32(static_cast<uint32_t>(state.capture_channels.size()));
+  writer.WriteUint8(state.delay_samples ? 1 : 0);
+  writer.WriteUint32(
+      static_cast<uint32_t>(state.delay_samples ? *state.delay_samples : 0));
+  writer.WriteFloats(state.erl);
+  writer.WriteFloat(state.erl_time_domain);
+  for (const auto& channel : state.capture_channels) {
+    writer.WriteUint32(static_cast<uint32_t>(channel.refined_filter.size()));
+    writer.WriteFloats(channel.refined_filter);
+    writer.WriteUint32(static_cast<uint32_t>(channel.coarse_filter.size()));
+    writer.WriteFloats(channel.coarse_filter);
+    writer.WriteFloats(channel.refined_filter_error);
+    writer.WriteFloats(channel.erle);
+    writer.WriteFloats(channel.erle_onset_compensated);
+    writer.WriteFloats(channel.erle_unbounded);
+    writer.WriteFloat(channel.fullband_erle_log2);
+    writer.WriteFloat(channel.reverb_decay);
+    writer.WriteFloats(channel.reverb_frequency_response);
+  }
+  return data;
+}
+
+bool DeserializeAec3WarmStartState(rtc::ArrayView<const uint8_t> data,
+                                   Aec3WarmStartState* state) {
+  RTC_DCHECK(state);
+  Reader reader(data);
+  for (uint8_t expected_byte : kMagic) {
+    uint8_t byte;
+    if (!reader.ReadUint8(&byte) || byte != expected_byte) {
+      return false;
+    }
+  }
+  uint8_t version;
+  if (!reader.ReadUint8(&version) || version != kVersion) {
+    return false;
+  }
+
+  Aec3WarmStartState parsed;
+  uint32_t num_render_channels;
+  uint32_t num_capture_channels;
+  uint8_t has_delay;
+  uint32_t delay_samples;
+  if (!reader.ReadUint32(&num_render_channels) ||
+      !reader.ReadUint32(&num_capture_channels) ||
+      !reader.ReadUint8(&has_delay) || !reader.ReadUint32(&delay_samples) ||
+      num_render_channels == 0 || num_render_channels > kMaxNumChannels ||
+      num_capture_channels == 0 || num_capture_channels > kMaxNumChannels ||
+      has_delay > 1) {
+    return false;
+  }
+  parsed.num_render_channels = num_render_channels;
+  if (has_delay) {
+    parsed.delay_samples = delay_samples;
+  }
+  if (!reader.ReadFloats(parsed.erl) ||
+      !reader.ReadFloat(&parsed.erl_time_domain)) {
+    return false;
+  }
+
+  const size_t filter_granularity =
+      num_render_channels * Aec3WarmStartState::kPartitionSize;
+  parsed.capture_channels.resize(num_capture_channels);
+  for (auto& channel : parsed.capture_channels) {
+    if (!reader.ReadFilter(&channel.refined_filter) ||
+        !reader.ReadFilter(&channel.coarse_filter) ||
+        channel.refined_filter.size() % filter_granularity != 0 ||
+        channel.coarse_filter.size() % filter_granularity != 0 ||
+        !reader.ReadFloats(channel.refined_filter_error) ||
+        !reader.ReadFloats(channel.erle) ||
+        !reader.ReadFloats(channel.erle_onset_compensated) ||
+        !reader.ReadFloats(channel.erle_unbounded) ||
+        !reader.ReadFloat(&channel.fullband_erle_log2) ||
+        !reader.ReadFloat(&channel.reverb_decay) ||
+        !reader.ReadFloats(channel.reverb_frequency_response)) {
+      return false;
+    }
+  }
+  if (!reader.AtEnd()) {
+    return false;
+  }
+
+  *state = std::move(parsed);
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_WARM_START_STATE_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_WARM_START_STATE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+
+namespace webrtc {
+
+// Converged state of an echo canceller. Restoring it into a new echo canceller
+// with the same setup that cancels the echo of the same echo path lets the new
+// echo canceller skip the initial filter convergence and delay search.
+struct Aec3WarmStartState {
+  struct CaptureChannel {
+    // Coefficients of the refined and coarse filters. For each partition of
+    // the filter and each render channel, the real parts of the
+    // kFftLengthBy2Plus1 frequency bins are followed by the imaginary parts.
+    std::vector<float> refined_filter;
+    std::vector<float> coarse_filter;
+    // Estimated misadjustment of the refined filter, which controls its
+    // adaptation step size.
+    std::array<float, kFftLengthBy2Plus1> refined_filter_error;
+    std::array<float, kFftLengthBy2Plus1> erle;
+    std::array<float, kFftLengthBy2Plus1> erle_onset_compensated;
+    std::array<float, kFftLengthBy2Plus1> erle_unbounded;
+    float fullband_erle_log2 = 0.f;
+    float reverb_decay = 0.f;
+    std::array<float, kFftLengthBy2Plus1> reverb_frequency_response;
+  };
+
+  // Number of filter coefficients per partition and render channel.
+  static constexpr size_t kPartitionSize = 2 * kFftLengthBy2Plus1;
+
+  size_t num_render_channels = 0;
+  // Estimated delay of the echo path in samples.
+  absl::optional<size_t> delay_samples;
+  std::array<float, kFftLengthBy2Plus1> erl;
+  float erl_time_domain = 0.f;
+  std::vector<CaptureChannel> capture_channels;
+};
+
+// Serializes the state into a compact, versioned binary format that does not
+// depend on the byte order of the platform.
+std::vector<uint8_t> SerializeAec3WarmStartState(
+    const Aec3WarmStartState& state);
+
+// Parses data produced by SerializeAec3WarmStartState. Returns false if the
+// data is malformed or of an unsupported version.
+bool DeserializeAec3WarmStartState(rtc::ArrayView<const uint8_t> data,
+                                   Aec3WarmStartState* state);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_WARM_START_STATE_H_
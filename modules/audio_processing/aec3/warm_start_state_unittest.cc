@@ -0,0 +1,245 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/warm_start_state.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "api/audio/echo_canceller3_config.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/block.h"
+#include "modules/audio_processing/aec3/block_processor.h"
+#include "modules/audio_processing/aec3/echo_canceller3.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 16000;
+constexpr size_t kDelayBlocks = 10;
+
+Aec3WarmStartState CreateState(size_t num_render_channels,
+                               size_t num_capture_channels,
+                               size_t num_partitions) {
+  Aec3WarmStartState state;
+  state.num_render_channels = num_render_channels;
+  state.delay_samples = 700;
+  state.erl.fill(0.5f);
+  state.erl_time_domain = 0.25f;
+  state.capture_channels.resize(num_capture_channels);
+  float value = 0.f;
+  for (auto& channel : state.capture_channels) {
+    channel.refined_filter.resize(num_partitions * num_render_channels *
+                                  Aec3WarmStartState::kPartitionSize);
+    channel.coarse_filter.resize(channel.refined_filter.size());
+    for (size_t k = 0; k < channel.refined_filter.size(); ++k) {
+      channel.refined_filter[k] = value;
+      channel.coarse_filter[k] = -value;
+      value += 0.125f;
+    }
+    channel.refined_filter_error.fill(1.f);
+    channel.erle.fill(2.f);
+    channel.erle_onset_compensated.fill(3.f);
+    channel.erle_unbounded.fill(4.f);
+    channel.fullband_erle_log2 = 5.f;
+    channel.reverb_decay = 0.75f;
+    channel.reverb_frequency_response.fill(0.125f);
+  }
+  return state;
+}
+
+void ExpectEqualStates(const Aec3WarmStartState& a,
+                       const Aec3WarmStartState& b) {
+  EXPECT_EQ(a.num_render_channels, b.num_render_channels);
+  EXPECT_EQ(a.delay_samples, b.delay_samples);
+  EXPECT_EQ(a.erl, b.erl);
+  EXPECT_EQ(a.erl_time_domain, b.erl_time_domain);
+  ASSERT_EQ(a.capture_channels.size(), b.capture_channels.size());
+  for (size_t ch = 0; ch < a.capture_channels.size(); ++ch) {
+    const auto& channel_a = a.capture_channels[ch];
+    const auto& channel_b = b.capture_channels[ch];
+    EXPECT_EQ(channel_a.refined_filter, channel_b.refined_filter);
+    EXPECT_EQ(channel_a.coarse_filter, channel_b.coarse_filter);
+    EXPECT_EQ(channel_a.refined_filter_error, channel_b.refined_filter_error);
+    EXPECT_EQ(channel_a.erle, channel_b.erle);
+    EXPECT_EQ(channel_a.erle_onset_compensated,
+              channel_b.erle_onset_compensated);
+    EXPECT_EQ(channel_a.erle_unbounded, channel_b.erle_unbounded);
+    EXPECT_EQ(channel_a.fullband_erle_log2, channel_b.fullband_erle_log2);
+    EXPECT_EQ(channel_a.reverb_decay, channel_b.reverb_decay);
+    EXPECT_EQ(channel_a.reverb_frequency_response,
+              channel_b.reverb_frequency_response);
+  }
+}
+
+// Feeds the block processor with a noise render signal and a capture signal
+// that is the render signal delayed by kDelayBlocks blocks, and returns the
+// energy of the echo remaining in the linear filter output.
+float ProcessEcho(int num_blocks,
+                  Random* random_generator,
+                  BlockProcessor* block_processor) {
+  Block render(NumBandsForRate(kSampleRateHz), 1);
+  Block capture(NumBandsForRate(kSampleRateHz), 1);
+  Block linear_output(/*num_bands=*/1, 1);
+  std::vector<std::vector<float>> render_history(
+      kDelayBlocks + 1, std::vector<float>(kBlockSize, 0.f));
+  float output_energy = 0.f;
+  for (int k = 0; k < num_blocks; ++k) {
+    std::vector<float>& x = render_history[k % render_history.size()];
+    for (float& sample : x) {
+      sample = 10000.f * (random_generator->Rand<float>() - 0.5f);
+    }
+    const std::vector<float>& y =
+        render_history[(k + 1) % render_history.size()];
+    std::copy(x.begin(), x.end(), render.begin(/*band=*/0, /*channel=*/0));
+    std::copy(y.begin(), y.end(), capture.begin(/*band=*/0, /*channel=*/0));
+
+    block_processor->BufferRender(render);
+    block_processor->ProcessCapture(/*echo_path_gain_change=*/false,
+                                    /*capture_signal_saturation=*/false,
+                                    &linear_output, &capture);
+    for (float sample : linear_output.View(/*band=*/0, /*channel=*/0)) {
+      output_energy += sample * sample;
+    }
+  }
+  return output_energy;
+}
+
+}  // namespace
+
+TEST(Aec3WarmStartState, SerializationRoundTrip) {
+  for (size_t num_render_channels : {1, 2}) {
+    for (size_t num_capture_channels : {1, 3}) {
+      const Aec3WarmStartState state =
+          CreateState(num_render_channels, num_capture_channels,
+                      /*num_partitions=*/4);
+      Aec3WarmStartState parsed;
+      ASSERT_TRUE(DeserializeAec3WarmStartState(
+          SerializeAec3WarmStartState(state), &parsed));
+      ExpectEqualStates(state, parsed);
+    }
+  }
+
+  Aec3WarmStartState state = CreateState(1, 1, /*num_partitions=*/1);
+  state.delay_samples = absl::nullopt;
+  Aec3WarmStartState parsed;
+  ASSERT_TRUE(DeserializeAec3WarmStartState(
+      SerializeAec3WarmStartState(state), &parsed));
+  EXPECT_FALSE(parsed.delay_samples);
+}
+
+TEST(Aec3WarmStartState, RejectsMalformedData) {
+  const std::vector<uint8_t> data =
+      SerializeAec3WarmStartState(CreateState(2, 2, /*num_partitions=*/2));
+  Aec3WarmStartState parsed;
+
+  for (size_t size : {size_t{0}, size_t{4}, data.size() / 2, data.size() - 1}) {
+    std::vector<uint8_t> truncated(data.begin(), data.begin() + size);
+    EXPECT_FALSE(DeserializeAec3WarmStartState(truncated, &parsed));
+  }
+
+  std::vector<uint8_t> extended = data;
+  extended.push_back(0);
+  EXPECT_FALSE(DeserializeAec3WarmStartState(extended, &parsed));
+
+  std::vector<uint8_t> wrong_magic = data;
+  wrong_magic[0] = 'X';
+  EXPECT_FALSE(DeserializeAec3WarmStartState(wrong_magic, &parsed));
+
+  std::vector<uint8_t> wrong_version = data;
+  ++wrong_version[4];
+  EXPECT_FALSE(DeserializeAec3WarmStartState(wrong_version, &parsed));
+
+  Aec3WarmStartState non_finite = CreateState(1, 1, /*num_partitions=*/1);
+  non_finite.capture_channels[0].erle[3] =
+      std::numeric_limits<float>::quiet_NaN();
+  EXPECT_FALSE(DeserializeAec3WarmStartState(
+      SerializeAec3WarmStartState(non_finite), &parsed));
+}
+
+// Verifies that a block processor that restores the state of a converged
+// block processor saves the same state and removes the echo right away.
+TEST(Aec3WarmStartState, BlockProcessorRestoresConvergedState) {
+  const EchoCanceller3Config config;
+  Random random_generator(42U);
+  std::unique_ptr<BlockProcessor> converged(
+      BlockProcessor::Create(config, kSampleRateHz, 1, 1));
+  ProcessEcho(5 * kNumBlocksPerSecond, &random_generator, converged.get());
+  Aec3WarmStartState state;
+  converged->SaveWarmStartState(&state);
+  ASSERT_TRUE(state.delay_samples);
+  ASSERT_EQ(state.capture_channels.size(), 1u);
+  EXPECT_EQ(state.capture_channels[0].refined_filter.size(),
+            config.filter.refined.length_blocks *
+                Aec3WarmStartState::kPartitionSize);
+
+  std::unique_ptr<BlockProcessor> warm(
+      BlockProcessor::Create(config, kSampleRateHz, 1, 1));
+  warm->RestoreWarmStartState(state);
+  Aec3WarmStartState restored;
+  warm->SaveWarmStartState(&restored);
+  // The delay is only restored when the capture processing starts.
+  EXPECT_FALSE(restored.delay_samples);
+  restored.delay_samples = state.delay_samples;
+  ExpectEqualStates(state, restored);
+
+  std::unique_ptr<BlockProcessor> cold(
+      BlockProcessor::Create(config, kSampleRateHz, 1, 1));
+  Random warm_generator(7U);
+  Random cold_generator(7U);
+  const float warm_energy =
+      ProcessEcho(kNumBlocksPerSecond / 2, &warm_generator, warm.get());
+  const float cold_energy =
+      ProcessEcho(kNumBlocksPerSecond / 2, &cold_generator, cold.get());
+  EXPECT_LT(warm_energy, 0.1f * cold_energy);
+
+  EchoControl::Metrics converged_metrics;
+  EchoControl::Metrics warm_metrics;
+  converged->GetMetrics(&converged_metrics);
+  warm->GetMetrics(&warm_metrics);
+  EXPECT_EQ(converged_metrics.delay_ms, warm_metrics.delay_ms);
+}
+
+TEST(Aec3WarmStartState, EchoCancellerValidatesState) {
+  EchoCanceller3 mono(EchoCanceller3Config(), absl::nullopt, kSampleRateHz,
+                      1, 1);
+  const std::vector<uint8_t> mono_state = mono.GetWarmStartState();
+  EXPECT_TRUE(mono.SetWarmStartState(mono_state));
+
+  EchoCanceller3 stereo_capture(EchoCanceller3Config(), absl::nullopt,
+                                kSampleRateHz, 1, 2);
+  EXPECT_FALSE(stereo_capture.SetWarmStartState(mono_state));
+  EXPECT_TRUE(
+      stereo_capture.SetWarmStartState(stereo_capture.GetWarmStartState()));
+
+  EchoCanceller3Config short_filter_config;
+  short_filter_config.filter.refined.length_blocks = 10;
+  short_filter_config.filter.refined_initial.length_blocks = 10;
+  EchoCanceller3 short_filter(short_filter_config, absl::nullopt,
+                              kSampleRateHz, 1, 1);
+  Aec3WarmStartState state = CreateState(1, 1, /*num_partitions=*/12);
+  EXPECT_FALSE(
+      short_filter.SetWarmStartState(SerializeAec3WarmStartState(state)));
+  state = CreateState(1, 1, /*num_partitions=*/10);
+  EXPECT_TRUE(
+      short_filter.SetWarmStartState(SerializeAec3WarmStartState(state)));
+
+  const std::vector<uint8_t> truncated(mono_state.begin(),
+                                       mono_state.end() - 1);
+  EXPECT_FALSE(mono.SetWarmStartState(truncated));
+}
+
+}  // namespace webrtc
@@ -51,6 +51,11 @@ class AudioBuffer {
   // Specify that downmixing should be done by averaging all channels,.
   void set_downmixing_by_averaging();
 
+  // Specify whether the split into two bands at 32 kHz should be done using the
+  // floating-point QMF filter bank instead of the fixed-point one. Resets the
+  // state of the band splitting, so it should be set before any processing.
+  void set_float_band_splitting(bool enable);
+
   // Set the number of channels in the buffer. The specified number of channels
   // cannot be larger than the specified buffer_num_channels. The number is also
   // reset at each call to CopyFrom or InterleaveFrom.
@@ -90,4 +90,39 @@ TEST(AudioBufferTest, CopyWithResampling) {
   // Verify that energies match.
   EXPECT_NEAR(energy_ab1, energy_ab2 * 32000.f / 48000.f, .01f * energy_ab1);
 }
+
+TEST(AudioBufferTest, FloatBandSplittingMatchesFixedPoint) {
+  AudioBuffer ab1(32000, 2, 32000, 2, 32000, 2);
+  AudioBuffer ab2(32000, 2, 32000, 2, 32000, 2);
+  ab2.set_float_band_splitting(true);
+  const float pi = std::acos(-1.f);
+  for (size_t frame = 0; frame < 5; ++frame) {
+    for (size_t ch = 0; ch < ab1.num_channels(); ++ch) {
+      for (size_t i = 0; i < ab1.num_frames(); ++i) {
+        const size_t n = frame * ab1.num_frames() + i;
+        ab1.channels()[ch][i] =
+            4000.f * std::sin(2 * pi * (500.f + 6000.f * ch) / 32000.f * n);
+        ab2.channels()[ch][i] = ab1.channels()[ch][i];
+      }
+    }
+    ab1.SplitIntoFrequencyBands();
+    ab2.SplitIntoFrequencyBands();
+    for (size_t ch = 0; ch < ab1.num_channels(); ++ch) {
+      for (size_t band = 0; band < ab1.num_bands(); ++band) {
+        for (size_t i = 0; i < ab1.num_frames_per_band(); ++i) {
+          EXPECT_NEAR(ab1.split_bands(ch)[band][i],
+                      ab2.split_bands(ch)[band][i], 2.f);
+        }
+      }
+    }
+    ab1.MergeFrequencyBands();
+    ab2.MergeFrequencyBands();
+    for (size_t ch = 0; ch < ab1.num_channels(); ++ch) {
+      for (size_t i = 0; i < ab1.num_frames(); ++i) {
+        EXPECT_NEAR(ab1.channels()[ch][i], ab2.channels()[ch][i], 3.f);
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -12,7 +12,15 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 namespace {
@@ -20,6 +28,14 @@ namespace {
 // Parameter controlling the adaptation speed.
 constexpr float kAlpha = 0.001f;
 
+bool IsSse2Supported() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace
 
 void NormalizedCovarianceEstimator::Update(float x,
@@ -40,4 +56,67 @@ void NormalizedCovarianceEstimator::Clear() {
   normalized_cross_correlation_ = 0.f;
 }
 
+NormalizedCovarianceEstimatorBank::NormalizedCovarianceEstimatorBank(
+    size_t num_estimators)
+    : use_sse2_(IsSse2Supported()),
+      normalized_cross_correlations_(num_estimators, 0.f),
+      covariances_(num_estimators, 0.f) {}
+
+NormalizedCovarianceEstimatorBank::~NormalizedCovarianceEstimatorBank() =
+    default;
+
+void NormalizedCovarianceEstimatorBank::Update(
+    float x,
+    float x_mean,
+    float x_sigma,
+    rtc::ArrayView<const float> y,
+    rtc::ArrayView<const float> y_mean,
+    rtc::ArrayView<const float> y_sigma) {
+  RTC_DCHECK_EQ(y.size(), covariances_.size());
+  RTC_DCHECK_EQ(y_mean.size(), covariances_.size());
+  RTC_DCHECK_EQ(y_sigma.size(), covariances_.size());
+  const size_t num_estimators = covariances_.size();
+  // The operations are done in the same order as in
+  // NormalizedCovarianceEstimator::Update().
+  const float x_deviation = x - x_mean;
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    const __m128 one_minus_alpha = _mm_set1_ps(1.f - kAlpha);
+    const __m128 alpha_x_deviation = _mm_set1_ps(kAlpha * x_deviation);
+    const __m128 x_sigma_v = _mm_set1_ps(x_sigma);
+    const __m128 regularization = _mm_set1_ps(.0001f);
+    for (; k + 4 <= num_estimators; k += 4) {
+      const __m128 y_deviation =
+          _mm_sub_ps(_mm_loadu_ps(&y[k]), _mm_loadu_ps(&y_mean[k]));
+      const __m128 covariance = _mm_add_ps(
+          _mm_mul_ps(one_minus_alpha, _mm_loadu_ps(&covariances_[k])),
+          _mm_mul_ps(alpha_x_deviation, y_deviation));
+      const __m128 sigma_product = _mm_add_ps(
+          _mm_mul_ps(x_sigma_v, _mm_loadu_ps(&y_sigma[k])), regularization);
+      _mm_storeu_ps(&covariances_[k], covariance);
+      _mm_storeu_ps(&normalized_cross_correlations_[k],
+                    _mm_div_ps(covariance, sigma_product));
+    }
+  }
+#endif
+  for (; k < num_estimators; ++k) {
+    covariances_[k] = (1.f - kAlpha) * covariances_[k] +
+                      kAlpha * x_deviation * (y[k] - y_mean[k]);
+    normalized_cross_correlations_[k] =
+        covariances_[k] / (x_sigma * y_sigma[k] + .0001f);
+  }
+  RTC_DCHECK(std::all_of(covariances_.begin(), covariances_.end(),
+                         [](float c) { return isfinite(c); }));
+  RTC_DCHECK(std::all_of(normalized_cross_correlations_.begin(),
+                         normalized_cross_correlations_.end(),
+                         [](float c) { return isfinite(c); }));
+}
+
+void NormalizedCovarianceEstimatorBank::Clear() {
+  std::fill(covariances_.begin(), covariances_.end(), 0.f);
+  std::fill(normalized_cross_correlations_.begin(),
+            normalized_cross_correlations_.end(), 0.f);
+}
+
 }  // namespace webrtc
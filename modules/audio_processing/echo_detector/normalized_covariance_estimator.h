@@ -11,6 +11,12 @@
 #ifndef MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_ESTIMATOR_H_
 #define MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_ESTIMATOR_H_
 
+#include <stddef.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+
 namespace webrtc {
 
 // This class iteratively estimates the normalized covariance between two
@@ -38,6 +44,36 @@ class NormalizedCovarianceEstimator {
   float covariance_ = 0.f;
 };
 
+// This class estimates the normalized covariances between one signal and a
+// number of other signals, such as differently delayed versions of the same
+// signal. The estimates are updated together, using SSE2 when available, and
+// are identical to those of one NormalizedCovarianceEstimator per signal.
+class NormalizedCovarianceEstimatorBank {
+ public:
+  explicit NormalizedCovarianceEstimatorBank(size_t num_estimators);
+  ~NormalizedCovarianceEstimatorBank();
+
+  // Updates estimate k using x and y[k], for all k.
+  void Update(float x,
+              float x_mean,
+              float x_sigma,
+              rtc::ArrayView<const float> y,
+              rtc::ArrayView<const float> y_mean,
+              rtc::ArrayView<const float> y_sigma);
+  rtc::ArrayView<const float> normalized_cross_correlations() const {
+    return normalized_cross_correlations_;
+  }
+  rtc::ArrayView<const float> covariances() const { return covariances_; }
+  size_t size() const { return covariances_.size(); }
+  // This function resets the estimated values to zero.
+  void Clear();
+
+ private:
+  const bool use_sse2_;
+  std::vector<float> normalized_cross_correlations_;
+  std::vector<float> covariances_;
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_ESTIMATOR_H_
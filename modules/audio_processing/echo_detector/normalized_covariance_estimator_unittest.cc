@@ -11,6 +11,8 @@
 
 #include "modules/audio_processing/echo_detector/normalized_covariance_estimator.h"
 
+#include <vector>
+
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -38,4 +40,34 @@ TEST(NormalizedCovarianceEstimatorTests, OppositeSignalTest) {
   EXPECT_NEAR(-1.f, test_estimator.normalized_cross_correlation(), 0.01f);
 }
 
+// Verifies that the estimates of the bank are identical to those of separate
+// estimators, also for a number of estimators that is not a multiple of 4.
+TEST(NormalizedCovarianceEstimatorTests, BankMatchesSeparateEstimators) {
+  constexpr size_t kNumEstimators = 11;
+  NormalizedCovarianceEstimatorBank bank(kNumEstimators);
+  std::vector<NormalizedCovarianceEstimator> estimators(kNumEstimators);
+  std::vector<float> y(kNumEstimators);
+  std::vector<float> y_mean(kNumEstimators);
+  std::vector<float> y_sigma(kNumEstimators);
+  for (size_t i = 0; i < 1000; i++) {
+    const float x = (i * 7919) % 101;
+    for (size_t k = 0; k < kNumEstimators; ++k) {
+      y[k] = ((i + k) * 104729) % 97;
+      y_mean[k] = 40.f + k;
+      y_sigma[k] = 20.f + 0.5f * k;
+    }
+    bank.Update(x, 50.f, 30.f, y, y_mean, y_sigma);
+    for (size_t k = 0; k < kNumEstimators; ++k) {
+      estimators[k].Update(x, 50.f, 30.f, y[k], y_mean[k], y_sigma[k]);
+      ASSERT_EQ(estimators[k].covariance(), bank.covariances()[k]);
+      ASSERT_EQ(estimators[k].normalized_cross_correlation(),
+                bank.normalized_cross_correlations()[k]);
+    }
+  }
+  bank.Clear();
+  for (size_t k = 0; k < kNumEstimators; ++k) {
+    EXPECT_EQ(0.f, bank.normalized_cross_correlations()[k]);
+  }
+}
+
 }  // namespace webrtc
@@ -30,15 +30,18 @@ class HighPassFilter {
 
   void Process(AudioBuffer* audio, bool use_split_band_data);
   void Process(std::vector<std::vector<float>>* audio);
+  // Processes the audio of a single channel in-place.
+  void Process(size_t channel, rtc::ArrayView<float> audio);
   void Reset();
   void Reset(size_t num_channels);
 
   int sample_rate_hz() const { return sample_rate_hz_; }
-  size_t num_channels() const { return filters_.size(); }
+  size_t num_channels() const { return filter_->num_channels(); }
 
  private:
   const int sample_rate_hz_;
-  std::vector<std::unique_ptr<CascadedBiQuadFilter>> filters_;
+  std::unique_ptr<MultiChannelCascadedBiQuadFilter> filter_;
+  std::vector<float*> channel_pointers_;
 };
 }  // namespace webrtc
 
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/logging/apm_data_dump_reader.h"
+
+#include <string.h>
+
+#include <memory>
+#include <utility>
+
+#include "common_audio/wav_file.h"
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// Bound on the size of a chunk, used for rejecting corrupt files before
+// allocating.
+constexpr uint64_t kMaxChunkSize = uint64_t{1} << 32;
+
+}  // namespace
+
+ApmDataDumpReader::ApmDataDumpReader(absl::string_view file_name)
+    : file_(FileWrapper::OpenReadOnly(file_name)) {
+  if (file_.is_open()) {
+    char magic[sizeof(kApmDataDumpFileMagic)];
+    is_open_ = file_.Read(magic, sizeof(magic)) == sizeof(magic) &&
+               memcmp(magic, kApmDataDumpFileMagic, sizeof(magic)) == 0;
+  }
+}
+
+ApmDataDumpReader::~ApmDataDumpReader() = default;
+
+bool ApmDataDumpReader::ReadNext(const Stream** stream,
+                                 std::vector<uint8_t>* data) {
+  RTC_DCHECK(stream);
+  RTC_DCHECK(data);
+  if (!is_open_) {
+    return false;
+  }
+  while (true) {
+    ApmDataDumpChunkHeader chunk;
+    const size_t num_read = file_.Read(&chunk, sizeof(chunk));
+    if (num_read == 0 && file_.ReadEof()) {
+      reached_end_ = true;
+      return false;
+    }
+    if (num_read != sizeof(chunk) || chunk.size > kMaxChunkSize) {
+      return false;
+    }
+
+    if (chunk.type == ApmDataDumpChunkHeader::Type::kStream) {
+      if (!ReadStreamDefinition(chunk.stream_id, chunk.size)) {
+        return false;
+      }
+      continue;
+    }
+
+    auto it = streams_.find(chunk.stream_id);
+    if (chunk.type != ApmDataDumpChunkHeader::Type::kData ||
+        it == streams_.end()) {
+      return false;
+    }
+    data->resize(chunk.size);
+    if (file_.Read(data->data(), data->size()) != data->size()) {
+      return false;
+    }
+    *stream = &it->second;
+    return true;
+  }
+}
+
+bool ApmDataDumpReader::ReadStreamDefinition(uint32_t stream_id,
+                                             uint64_t size) {
+  ApmDataDumpStreamDefinition definition;
+  if (size < sizeof(definition) ||
+      file_.Read(&definition, sizeof(definition)) != sizeof(definition) ||
+      size != sizeof(definition) + definition.name_length ||
+      (definition.format != ApmDataDumpFormat::kRaw &&
+       definition.format != ApmDataDumpFormat::kWav) ||
+      streams_.count(stream_id) > 0) {
+    return false;
+  }
+  Stream stream;
+  stream.name.resize(definition.name_length);
+  if (file_.Read(&stream.name[0], stream.name.size()) != stream.name.size()) {
+    return false;
+  }
+  stream.instance_index = definition.instance_index;
+  stream.recording_set_index = definition.recording_set_index;
+  stream.format = definition.format;
+  stream.sample_rate_hz = definition.sample_rate_hz;
+  stream.num_channels = definition.num_channels;
+  streams_.emplace(stream_id, std::move(stream));
+  return true;
+}
+
+bool SplitApmDataDump(absl::string_view dump_file_name,
+                      absl::string_view output_dir) {
+  ApmDataDumpReader reader(dump_file_name);
+  if (!reader.is_open()) {
+    RTC_LOG(LS_ERROR) << "Cannot read the dump file " << dump_file_name << ".";
+    return false;
+  }
+
+  std::map<const ApmDataDumpReader::Stream*, FileWrapper> raw_files;
+  std::map<const ApmDataDumpReader::Stream*, std::unique_ptr<WavWriter>>
+      wav_files;
+  const ApmDataDumpReader::Stream* stream;
+  std::vector<uint8_t> data;
+  while (reader.ReadNext(&stream, &data)) {
+    if (stream->format == ApmDataDumpFormat::kWav) {
+      auto& file = wav_files[stream];
+      if (!file) {
+        file = std::make_unique<WavWriter>(
+            ApmDataDumper::FormFileName(output_dir, stream->name,
+                                        stream->instance_index,
+                                        stream->recording_set_index, ".wav"),
+            stream->sample_rate_hz, stream->num_channels,
+            WavFile::SampleFormat::kFloat);
+      }
+      file->WriteSamples(reinterpret_cast<const float*>(data.data()),
+                         data.size() / sizeof(float));
+    } else {
+      auto& file = raw_files[stream];
+      if (!file.is_open()) {
+        const std::string file_name = ApmDataDumper::FormFileName(
+            output_dir, stream->name, stream->instance_index,
+            stream->recording_set_index, ".dat");
+        file = FileWrapper::OpenWriteOnly(file_name);
+        if (!file.is_open()) {
+          RTC_LOG(LS_ERROR) << "Cannot write to " << file_name << ".";
+          return false;
+        }
+      }
+      file.Write(data.data(), data.size());
+    }
+  }
+
+  if (!reader.ReachedEnd()) {
+    RTC_LOG(LS_ERROR) << "The dump file " << dump_file_name << " is corrupt.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_READER_H_
+#define MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "modules/audio_processing/logging/apm_data_dump_writer.h"
+#include "rtc_base/system/file_wrapper.h"
+
+namespace webrtc {
+
+// Reads the dump files written by ApmDataDumpWriter.
+class ApmDataDumpReader {
+ public:
+  struct Stream {
+    std::string name;
+    int instance_index = 0;
+    int recording_set_index = 0;
+    ApmDataDumpFormat format = ApmDataDumpFormat::kRaw;
+    int sample_rate_hz = 0;
+    int num_channels = 0;
+  };
+
+  explicit ApmDataDumpReader(absl::string_view file_name);
+  ~ApmDataDumpReader();
+
+  ApmDataDumpReader(const ApmDataDumpReader&) = delete;
+  ApmDataDumpReader& operator=(const ApmDataDumpReader&) = delete;
+
+  // Returns whether the file could be opened and starts with a valid header.
+  bool is_open() const { return is_open_; }
+
+  // Reads the data of the next dump call. Returns false at the end of the
+  // file or if the file is corrupt.
+  bool ReadNext(const Stream** stream, std::vector<uint8_t>* data);
+
+  // Returns whether the whole file has been read without errors.
+  bool ReachedEnd() const { return reached_end_; }
+
+ private:
+  bool ReadStreamDefinition(uint32_t stream_id, uint64_t size);
+
+  FileWrapper file_;
+  bool is_open_ = false;
+  bool reached_end_ = false;
+  std::map<uint32_t, Stream> streams_;
+};
+
+// Splits a file written by ApmDataDumpWriter into the per-variable .dat and
+// .wav files that ApmDataDumper writes when no writer is used, in
+// `output_dir`. Returns false if the dump file could not be read completely.
+bool SplitApmDataDump(absl::string_view dump_file_name,
+                      absl::string_view output_dir);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_READER_H_
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/logging/apm_data_dump_ring.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+static_assert(sizeof(ApmDataDumpRecordHeader) % ApmDataDumpRing::kAlignment ==
+                  0,
+              "Record headers must keep the records aligned");
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t power_of_two = ApmDataDumpRing::kAlignment;
+  while (power_of_two < value) {
+    power_of_two <<= 1;
+  }
+  return power_of_two;
+}
+
+size_t AlignedSize(size_t size) {
+  return (size + ApmDataDumpRing::kAlignment - 1) &
+         ~(ApmDataDumpRing::kAlignment - 1);
+}
+
+}  // namespace
+
+ApmDataDumpRing::ApmDataDumpRing(size_t capacity_bytes)
+    : capacity_(RoundUpToPowerOfTwo(
+          std::max(capacity_bytes, 2 * sizeof(ApmDataDumpRecordHeader)))),
+      mask_(capacity_ - 1),
+      buffer_(new uint8_t[capacity_]) {}
+
+ApmDataDumpRing::~ApmDataDumpRing() = default;
+
+uint8_t* ApmDataDumpRing::Reserve(absl::string_view name,
+                                  ApmDataDumpFormat format,
+                                  int instance_index,
+                                  int recording_set_index,
+                                  int sample_rate_hz,
+                                  int num_channels,
+                                  size_t data_size) {
+  RTC_DCHECK_NE(format, ApmDataDumpFormat::kPadding);
+  RTC_DCHECK_LE(name.size(), std::numeric_limits<uint16_t>::max());
+  const size_t record_size =
+      AlignedSize(sizeof(ApmDataDumpRecordHeader) + name.size() + data_size);
+
+  const uint64_t read_position = read_position_.load(std::memory_order_acquire);
+  uint64_t write_position = pending_write_position_;
+  const size_t offset = write_position & mask_;
+  const size_t contiguous_size = capacity_ - offset;
+  // Records are never split across the end of the buffer; the remainder of
+  // the buffer is then filled with a padding record.
+  const size_t padding_size =
+      record_size > contiguous_size ? contiguous_size : 0;
+  if (write_position + padding_size + record_size - read_position >
+      capacity_) {
+    num_dropped_records_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  if (padding_size > 0) {
+    // Only the first fields of the header are written, as the remainder of the
+    // buffer may be shorter than a header.
+    auto* padding =
+        reinterpret_cast<ApmDataDumpRecordHeader*>(&buffer_[offset]);
+    padding->record_size = static_cast<uint32_t>(padding_size);
+    padding->format = ApmDataDumpFormat::kPadding;
+    write_position += padding_size;
+  }
+
+  auto* header = reinterpret_cast<ApmDataDumpRecordHeader*>(
+      &buffer_[write_position & mask_]);
+  header->record_size = static_cast<uint32_t>(record_size);
+  header->format = format;
+  header->reserved = 0;
+  header->name_length = static_cast<uint16_t>(name.size());
+  header->instance_index = instance_index;
+  header->recording_set_index = recording_set_index;
+  header->sample_rate_hz = sample_rate_hz;
+  header->num_channels = num_channels;
+  header->data_size = data_size;
+  uint8_t* name_destination = reinterpret_cast<uint8_t*>(header + 1);
+  memcpy(name_destination, name.data(), name.size());
+  pending_write_position_ = write_position + record_size;
+  return name_destination + name.size();
+}
+
+void ApmDataDumpRing::Commit() {
+  write_position_.store(pending_write_position_, std::memory_order_release);
+}
+
+void ApmDataDumpRing::Write(absl::string_view name,
+                            ApmDataDumpFormat format,
+                            int instance_index,
+                            int recording_set_index,
+                            int sample_rate_hz,
+                            int num_channels,
+                            rtc::ArrayView<const uint8_t> data) {
+  uint8_t* destination =
+      Reserve(name, format, instance_index, recording_set_index,
+              sample_rate_hz, num_channels, data.size());
+  if (destination) {
+    memcpy(destination, data.data(), data.size());
+    Commit();
+  }
+}
+
+}  // namespace webrtc
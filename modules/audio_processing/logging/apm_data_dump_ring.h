@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_RING_H_
+#define MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+
+namespace webrtc {
+
+// Format of the data in an ApmDataDumper record.
+enum class ApmDataDumpFormat : uint8_t { kPadding = 0, kRaw = 1, kWav = 2 };
+
+// Header of a record in an ApmDataDumpRing. The header is followed by the
+// name of the dumped variable and the dumped data.
+struct ApmDataDumpRecordHeader {
+  // Size of the record including the header and the padding that aligns the
+  // next record.
+  uint32_t record_size;
+  ApmDataDumpFormat format;
+  uint8_t reserved;
+  uint16_t name_length;
+  int32_t instance_index;
+  int32_t recording_set_index;
+  // Only used for the kWav format.
+  int32_t sample_rate_hz;
+  int32_t num_channels;
+  uint64_t data_size;
+};
+
+// Lock-free single-producer single-consumer ring buffer of dump records. The
+// producer, i.e., the thread that dumps the data of an ApmDataDumper, only
+// copies the records into the ring, and the consumer drains them on another
+// thread. Records that do not fit are dropped and counted.
+class ApmDataDumpRing {
+ public:
+  static constexpr size_t kAlignment = 8;
+
+  // The capacity is rounded up to a power of two.
+  explicit ApmDataDumpRing(size_t capacity_bytes);
+  ~ApmDataDumpRing();
+
+  ApmDataDumpRing(const ApmDataDumpRing&) = delete;
+  ApmDataDumpRing& operator=(const ApmDataDumpRing&) = delete;
+
+  // Producer side. Reserves a record with room for `data_size` bytes of data
+  // and returns a pointer to where the data is to be written, or nullptr if
+  // the ring is full. The record is made available to the consumer by
+  // Commit().
+  uint8_t* Reserve(absl::string_view name,
+                   ApmDataDumpFormat format,
+                   int instance_index,
+                   int recording_set_index,
+                   int sample_rate_hz,
+                   int num_channels,
+                   size_t data_size);
+  void Commit();
+
+  // Producer side. Writes a record holding a copy of `data`.
+  void Write(absl::string_view name,
+             ApmDataDumpFormat format,
+             int instance_index,
+             int recording_set_index,
+             int sample_rate_hz,
+             int num_channels,
+             rtc::ArrayView<const uint8_t> data);
+
+  // Consumer side. Calls `callback` for each committed record and releases the
+  // records. Returns the number of records read.
+  template <typename Callback>
+  size_t Read(Callback callback) {
+    const uint64_t write_position =
+        write_position_.load(std::memory_order_acquire);
+    uint64_t read_position = read_position_.load(std::memory_order_relaxed);
+    size_t num_records = 0;
+    while (read_position < write_position) {
+      const auto* header = reinterpret_cast<const ApmDataDumpRecordHeader*>(
+          &buffer_[read_position & mask_]);
+      if (header->format != ApmDataDumpFormat::kPadding) {
+        const char* name = reinterpret_cast<const char*>(header + 1);
+        callback(*header, absl::string_view(name, header->name_length),
+                 rtc::ArrayView<const uint8_t>(
+                     reinterpret_cast<const uint8_t*>(name) +
+                         header->name_length,
+                     header->data_size));
+        ++num_records;
+      }
+      read_position += header->record_size;
+    }
+    read_position_.store(read_position, std::memory_order_release);
+    return num_records;
+  }
+
+  // Returns the number of records that have been dropped since the ring was
+  // full. May be called from any thread.
+  size_t NumDroppedRecords() const {
+    return num_dropped_records_.load(std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  const size_t capacity_;
+  const uint64_t mask_;
+  std::unique_ptr<uint8_t[]> buffer_;
+  // Monotonically increasing positions in the ring.
+  alignas(64) std::atomic<uint64_t> write_position_{0};
+  alignas(64) std::atomic<uint64_t> read_position_{0};
+  // Producer state.
+  uint64_t pending_write_position_ = 0;
+  std::atomic<size_t> num_dropped_records_{0};
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_RING_H_
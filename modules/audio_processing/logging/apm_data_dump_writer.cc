@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/logging/apm_data_dump_writer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "api/units/time_delta.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Period with which the background thread drains the rings.
+constexpr TimeDelta kDrainPeriod = TimeDelta::Millis(10);
+
+}  // namespace
+
+ApmDataDumpWriter::ApmDataDumpWriter(absl::string_view file_name,
+                                     size_t ring_capacity_bytes)
+    : ring_capacity_bytes_(ring_capacity_bytes),
+      file_(FileWrapper::OpenWriteOnly(file_name)),
+      is_open_(file_.is_open()) {
+  if (!is_open_) {
+    return;
+  }
+  {
+    MutexLock lock(&file_mutex_);
+    file_.Write(kApmDataDumpFileMagic, sizeof(kApmDataDumpFileMagic));
+  }
+  thread_ = rtc::PlatformThread::SpawnJoinable(
+      [this] { Run(); }, "ApmDataDumpWriter",
+      rtc::ThreadAttributes().SetPriority(rtc::ThreadPriority::kLow));
+}
+
+ApmDataDumpWriter::~ApmDataDumpWriter() {
+  stop_.store(true, std::memory_order_relaxed);
+  wake_up_.Set();
+  thread_.Finalize();
+  MutexLock lock(&file_mutex_);
+  DrainRings();
+  file_.Close();
+}
+
+ApmDataDumpRing* ApmDataDumpWriter::CreateRing() {
+  MutexLock lock(&rings_mutex_);
+  rings_.push_back(std::make_unique<ApmDataDumpRing>(ring_capacity_bytes_));
+  return rings_.back().get();
+}
+
+void ApmDataDumpWriter::DestroyRing(ApmDataDumpRing* ring) {
+  MutexLock lock(&rings_mutex_);
+  auto it = std::find_if(
+      rings_.begin(), rings_.end(),
+      [ring](const std::unique_ptr<ApmDataDumpRing>& r) {
+        return r.get() == ring;
+      });
+  RTC_DCHECK(it != rings_.end());
+  if (it == rings_.end()) {
+    return;
+  }
+  // No records are written to the ring after this point, so its number of
+  // dropped records is final.
+  num_dropped_records_of_destroyed_rings_ += ring->NumDroppedRecords();
+  destroyed_rings_.push_back(std::move(*it));
+  rings_.erase(it);
+}
+
+void ApmDataDumpWriter::Flush() {
+  MutexLock lock(&file_mutex_);
+  DrainRings();
+  file_.Flush();
+}
+
+size_t ApmDataDumpWriter::NumDroppedRecords() const {
+  MutexLock lock(&rings_mutex_);
+  size_t num_dropped_records = num_dropped_records_of_destroyed_rings_;
+  for (const auto& ring : rings_) {
+    num_dropped_records += ring->NumDroppedRecords();
+  }
+  return num_dropped_records;
+}
+
+void ApmDataDumpWriter::Run() {
+  while (!stop_.load(std::memory_order_relaxed)) {
+    wake_up_.Wait(kDrainPeriod);
+    MutexLock lock(&file_mutex_);
+    DrainRings();
+  }
+}
+
+void ApmDataDumpWriter::DrainRings() {
+  // The rings are drained outside of `rings_mutex_`. This is safe since the
+  // rings are only deleted below, with `file_mutex_` held.
+  std::vector<ApmDataDumpRing*> rings;
+  std::vector<std::unique_ptr<ApmDataDumpRing>> destroyed_rings;
+  {
+    MutexLock lock(&rings_mutex_);
+    rings.reserve(rings_.size());
+    for (const auto& ring : rings_) {
+      rings.push_back(ring.get());
+    }
+    destroyed_rings.swap(destroyed_rings_);
+  }
+  for (ApmDataDumpRing* ring : rings) {
+    DrainRing(ring);
+  }
+  for (const auto& ring : destroyed_rings) {
+    DrainRing(ring.get());
+  }
+}
+
+void ApmDataDumpWriter::DrainRing(ApmDataDumpRing* ring) {
+  if (!is_open_) {
+    ring->Read([](const ApmDataDumpRecordHeader&, absl::string_view,
+                  rtc::ArrayView<const uint8_t>) {});
+    return;
+  }
+  FileWrapper* file = &file_;
+  std::map<StreamKey, uint32_t>* stream_ids = &stream_ids_;
+  ring->Read([file, stream_ids](const ApmDataDumpRecordHeader& header,
+                                absl::string_view name,
+                                rtc::ArrayView<const uint8_t> data) {
+    StreamKey key(std::string(name), header.instance_index,
+                  header.recording_set_index, header.sample_rate_hz,
+                  header.num_channels, static_cast<uint8_t>(header.format));
+    auto it = stream_ids->find(key);
+    if (it == stream_ids->end()) {
+      const uint32_t stream_id = static_cast<uint32_t>(stream_ids->size());
+      it = stream_ids->emplace(std::move(key), stream_id).first;
+
+      ApmDataDumpStreamDefinition definition = {};
+      definition.instance_index = header.instance_index;
+      definition.recording_set_index = header.recording_set_index;
+      definition.sample_rate_hz = header.sample_rate_hz;
+      definition.num_channels = header.num_channels;
+      definition.format = header.format;
+      definition.name_length = static_cast<uint32_t>(name.size());
+      const ApmDataDumpChunkHeader chunk = {
+          ApmDataDumpChunkHeader::Type::kStream, stream_id,
+          sizeof(definition) + name.size()};
+      file->Write(&chunk, sizeof(chunk));
+      file->Write(&definition, sizeof(definition));
+      file->Write(name.data(), name.size());
+    }
+
+    const ApmDataDumpChunkHeader chunk = {ApmDataDumpChunkHeader::Type::kData,
+                                          it->second, data.size()};
+    file->Write(&chunk, sizeof(chunk));
+    file->Write(data.data(), data.size());
+  });
+}
+
+}  // namespace webrtc
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_WRITER_H_
+#define MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+#include "modules/audio_processing/logging/apm_data_dump_ring.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/system/file_wrapper.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Layout of the dump file written by ApmDataDumpWriter. The file starts with
+// kApmDataDumpFileMagic, followed by chunks that each start with a
+// ApmDataDumpChunkHeader. A kStream chunk assigns an id to a dumped variable
+// of an ApmDataDumper instance, and is followed by an
+// ApmDataDumpStreamDefinition and the name of the variable. A kData chunk
+// holds the data of one dump call of the stream with the id in the chunk
+// header. The values are stored in the byte order of the platform, as in the
+// files written by ApmDataDumper.
+constexpr char kApmDataDumpFileMagic[8] = {'A', 'P', 'M', 'D',
+                                           'U', 'M', 'P', '1'};
+
+struct ApmDataDumpChunkHeader {
+  enum class Type : uint32_t { kStream = 1, kData = 2 };
+  Type type;
+  uint32_t stream_id;
+  // Size of the chunk following the header.
+  uint64_t size;
+};
+
+struct ApmDataDumpStreamDefinition {
+  int32_t instance_index;
+  int32_t recording_set_index;
+  int32_t sample_rate_hz;
+  int32_t num_channels;
+  ApmDataDumpFormat format;
+  uint8_t reserved[3];
+  uint32_t name_length;
+};
+
+// Writes the records of the ApmDataDumpRing of each ApmDataDumper into a
+// single file on a background thread, so that the dumping threads only copy
+// the data into the rings. The writer must outlive the rings it creates.
+class ApmDataDumpWriter {
+ public:
+  static constexpr size_t kDefaultRingCapacityBytes = 1 << 20;
+
+  explicit ApmDataDumpWriter(
+      absl::string_view file_name,
+      size_t ring_capacity_bytes = kDefaultRingCapacityBytes);
+  ~ApmDataDumpWriter();
+
+  ApmDataDumpWriter(const ApmDataDumpWriter&) = delete;
+  ApmDataDumpWriter& operator=(const ApmDataDumpWriter&) = delete;
+
+  bool is_open() const { return is_open_; }
+
+  // Creates a ring whose records are written to the file. The ring is owned by
+  // the writer.
+  ApmDataDumpRing* CreateRing();
+
+  // Hands `ring` back to the writer, which writes its remaining records and
+  // destroys it on the background thread. Does not wait for any file writes,
+  // and `ring` must not be written to after the call.
+  void DestroyRing(ApmDataDumpRing* ring);
+
+  // Writes the records that have been committed to the rings.
+  void Flush();
+
+  // Returns the number of records that were dropped since a ring was full.
+  size_t NumDroppedRecords() const;
+
+ private:
+  using StreamKey = std::tuple<std::string, int, int, int, int, uint8_t>;
+
+  void Run();
+  // Writes the committed records of all rings and destroys the rings that have
+  // been handed back.
+  void DrainRings() RTC_EXCLUSIVE_LOCKS_REQUIRED(file_mutex_);
+  // Writes the committed records of `ring` and releases them.
+  void DrainRing(ApmDataDumpRing* ring)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(file_mutex_);
+
+  const size_t ring_capacity_bytes_;
+  // Held while writing to the file. The rings are only drained, and the
+  // destroyed rings only deleted, with this mutex held. When both mutexes are
+  // taken, `file_mutex_` is taken first.
+  Mutex file_mutex_;
+  // Guards the lists of rings. Never held during file writes, so that the
+  // dumping threads do not block on the file.
+  mutable Mutex rings_mutex_;
+  FileWrapper file_ RTC_GUARDED_BY(file_mutex_);
+  bool is_open_;
+  std::map<StreamKey, uint32_t> stream_ids_ RTC_GUARDED_BY(file_mutex_);
+  std::vector<std::unique_ptr<ApmDataDumpRing>> rings_
+      RTC_GUARDED_BY(rings_mutex_);
+  std::vector<std::unique_ptr<ApmDataDumpRing>> destroyed_rings_
+      RTC_GUARDED_BY(rings_mutex_);
+  size_t num_dropped_records_of_destroyed_rings_
+      RTC_GUARDED_BY(rings_mutex_) = 0;
+  std::atomic<bool> stop_{false};
+  rtc::Event wake_up_;
+  rtc::PlatformThread thread_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_LOGGING_APM_DATA_DUMP_WRITER_H_
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/logging/apm_data_dump_writer.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/logging/apm_data_dump_reader.h"
+#include "modules/audio_processing/logging/apm_data_dump_ring.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+std::vector<uint8_t> CreateData(size_t size, uint8_t offset) {
+  std::vector<uint8_t> data(size);
+  for (size_t k = 0; k < size; ++k) {
+    data[k] = static_cast<uint8_t>(k + offset);
+  }
+  return data;
+}
+
+}  // namespace
+
+// Verifies that the records read from the ring match the written ones also
+// when the records wrap around the end of the ring.
+TEST(ApmDataDumpRing, RecordsSurviveWrapAround) {
+  ApmDataDumpRing ring(1000);
+  EXPECT_EQ(ring.capacity(), 1024u);
+
+  for (int k = 0; k < 100; ++k) {
+    const std::vector<uint8_t> data = CreateData(100 + k % 7, k);
+    ring.Write("var", ApmDataDumpFormat::kRaw, 1, 2, 0, 0, data);
+    ring.Write("wav", ApmDataDumpFormat::kWav, 1, 2, 16000, 1, data);
+    size_t num_records = ring.Read([&](const ApmDataDumpRecordHeader& header,
+                                       absl::string_view name,
+                                       rtc::ArrayView<const uint8_t> read) {
+      EXPECT_EQ(header.instance_index, 1);
+      EXPECT_EQ(header.recording_set_index, 2);
+      if (header.format == ApmDataDumpFormat::kWav) {
+        EXPECT_EQ(name, "wav");
+        EXPECT_EQ(header.sample_rate_hz, 16000);
+        EXPECT_EQ(header.num_channels, 1);
+      } else {
+        EXPECT_EQ(name, "var");
+      }
+      EXPECT_EQ(std::vector<uint8_t>(read.begin(), read.end()), data);
+    });
+    EXPECT_EQ(num_records, 2u);
+  }
+  EXPECT_EQ(ring.NumDroppedRecords(), 0u);
+}
+
+// Verifies that the records that do not fit into the ring are dropped and
+// counted, and that the ring can be used again once it has been drained.
+TEST(ApmDataDumpRing, CountsDroppedRecords) {
+  ApmDataDumpRing ring(256);
+  const std::vector<uint8_t> data = CreateData(64, 0);
+  for (int k = 0; k < 10; ++k) {
+    ring.Write("var", ApmDataDumpFormat::kRaw, 0, 0, 0, 0, data);
+  }
+  EXPECT_GT(ring.NumDroppedRecords(), 0u);
+  const size_t num_written = 10 - ring.NumDroppedRecords();
+  EXPECT_EQ(ring.Read([](const ApmDataDumpRecordHeader& header,
+                         absl::string_view name,
+                         rtc::ArrayView<const uint8_t> read) {}),
+            num_written);
+
+  ring.Write("var", ApmDataDumpFormat::kRaw, 0, 0, 0, 0, data);
+  EXPECT_EQ(ring.Read([](const ApmDataDumpRecordHeader& header,
+                         absl::string_view name,
+                         rtc::ArrayView<const uint8_t> read) {}),
+            1u);
+
+  // Records that are larger than the ring are always dropped.
+  const size_t num_dropped = ring.NumDroppedRecords();
+  EXPECT_EQ(ring.Reserve("var", ApmDataDumpFormat::kRaw, 0, 0, 0, 0, 256),
+            nullptr);
+  EXPECT_EQ(ring.NumDroppedRecords(), num_dropped + 1);
+}
+
+// Verifies that the dumps written through the writer are read back by the
+// reader, in order and with the stream properties intact.
+TEST(ApmDataDumpWriter, ReaderReturnsWrittenRecords) {
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "apm_data_dump");
+  constexpr int kNumRecords = 500;
+  {
+    ApmDataDumpWriter writer(file_name, 1 << 16);
+    ASSERT_TRUE(writer.is_open());
+    ApmDataDumpRing* ring_1 = writer.CreateRing();
+    ApmDataDumpRing* ring_2 = writer.CreateRing();
+    for (int k = 0; k < kNumRecords; ++k) {
+      ring_1->Write("a", ApmDataDumpFormat::kRaw, 0, 0, 0, 0,
+                    CreateData(40, k));
+      ring_2->Write("b", ApmDataDumpFormat::kWav, 1, 3, 48000, 2,
+                    CreateData(80, k));
+      if (k % 100 == 0) {
+        writer.Flush();
+      }
+    }
+    writer.DestroyRing(ring_2);
+    EXPECT_EQ(writer.NumDroppedRecords(), 0u);
+  }
+
+  ApmDataDumpReader reader(file_name);
+  ASSERT_TRUE(reader.is_open());
+  int num_a = 0;
+  int num_b = 0;
+  const ApmDataDumpReader::Stream* stream;
+  std::vector<uint8_t> data;
+  while (reader.ReadNext(&stream, &data)) {
+    if (stream->name == "a") {
+      EXPECT_EQ(stream->format, ApmDataDumpFormat::kRaw);
+      EXPECT_EQ(stream->instance_index, 0);
+      EXPECT_EQ(data, CreateData(40, num_a));
+      ++num_a;
+    } else {
+      ASSERT_EQ(stream->name, "b");
+      EXPECT_EQ(stream->format, ApmDataDumpFormat::kWav);
+      EXPECT_EQ(stream->instance_index, 1);
+      EXPECT_EQ(stream->recording_set_index, 3);
+      EXPECT_EQ(stream->sample_rate_hz, 48000);
+      EXPECT_EQ(stream->num_channels, 2);
+      EXPECT_EQ(data, CreateData(80, num_b));
+      ++num_b;
+    }
+  }
+  EXPECT_TRUE(reader.ReachedEnd());
+  EXPECT_EQ(num_a, kNumRecords);
+  EXPECT_EQ(num_b, kNumRecords);
+  test::RemoveFile(file_name);
+}
+
+}  // namespace webrtc
@@ -22,19 +22,34 @@
 namespace webrtc {
 namespace {
 
-#if WEBRTC_APM_DEBUG_DUMP == 1
-
 #if defined(WEBRTC_WIN)
 constexpr char kPathDelimiter = '\\';
 #else
 constexpr char kPathDelimiter = '/';
 #endif
 
-std::string FormFileName(absl::string_view output_dir,
-                         absl::string_view name,
-                         int instance_index,
-                         int reinit_index,
-                         absl::string_view suffix) {
+}  // namespace
+
+#if WEBRTC_APM_DEBUG_DUMP == 1
+ApmDataDumper::ApmDataDumper(int instance_index)
+    : instance_index_(instance_index) {}
+
+ApmDataDumper::~ApmDataDumper() {
+  if (ring_) {
+    ring_writer_->DestroyRing(ring_);
+  }
+}
+#else
+ApmDataDumper::ApmDataDumper(int instance_index) {}
+
+ApmDataDumper::~ApmDataDumper() = default;
+#endif
+
+std::string ApmDataDumper::FormFileName(absl::string_view output_dir,
+                                        absl::string_view name,
+                                        int instance_index,
+                                        int reinit_index,
+                                        absl::string_view suffix) {
   char buf[1024];
   rtc::SimpleStringBuilder ss(buf);
   if (!output_dir.empty()) {
@@ -46,23 +61,26 @@ std::string FormFileName(absl::string_view output_dir,
   ss << name << "_" << instance_index << "-" << reinit_index << suffix;
   return ss.str();
 }
-#endif
-
-}  // namespace
-
-#if WEBRTC_APM_DEBUG_DUMP == 1
-ApmDataDumper::ApmDataDumper(int instance_index)
-    : instance_index_(instance_index) {}
-#else
-ApmDataDumper::ApmDataDumper(int instance_index) {}
-#endif
-
-ApmDataDumper::~ApmDataDumper() = default;
 
 #if WEBRTC_APM_DEBUG_DUMP == 1
 bool ApmDataDumper::recording_activated_ = false;
 absl::optional<int> ApmDataDumper::dump_set_to_use_;
 char ApmDataDumper::output_dir_[] = "";
+ApmDataDumpWriter* ApmDataDumper::async_writer_ = nullptr;
+
+void ApmDataDumper::WriteRaw(absl::string_view name,
+                             const void* data,
+                             size_t size) {
+  if (ApmDataDumpRing* ring = GetRing()) {
+    ring->Write(name, ApmDataDumpFormat::kRaw, instance_index_,
+                recording_set_index_, 0, 0,
+                rtc::ArrayView<const uint8_t>(
+                    static_cast<const uint8_t*>(data), size));
+    return;
+  }
+  FILE* file = GetRawFile(name);
+  fwrite(data, 1, size, file);
+}
 
 FILE* ApmDataDumper::GetRawFile(absl::string_view name) {
   std::string filename = FormFileName(output_dir_, name, instance_index_,
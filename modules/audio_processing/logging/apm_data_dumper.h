@@ -16,9 +16,12 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <string>
+
 #if WEBRTC_APM_DEBUG_DUMP == 1
+#include <string.h>
+
 #include <memory>
-#include <string>
 #include <unordered_map>
 #endif
 
@@ -27,6 +30,7 @@
 #include "api/array_view.h"
 #if WEBRTC_APM_DEBUG_DUMP == 1
 #include "common_audio/wav_file.h"
+#include "modules/audio_processing/logging/apm_data_dump_writer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/string_utils.h"
 #endif
@@ -39,6 +43,8 @@
 
 namespace webrtc {
 
+class ApmDataDumpWriter;
+
 #if WEBRTC_APM_DEBUG_DUMP == 1
 // Functor used to use as a custom deleter in the map of file pointers to raw
 // files.
@@ -89,6 +95,25 @@ class ApmDataDumper {
 #endif
   }
 
+  // Sends the dumps of all the instances to `writer`, which writes them into a
+  // single file on a background thread, instead of writing one file per
+  // dumped variable on the dumping thread. Each instance uses the writer that
+  // is set when it first dumps data, and the writer must outlive the
+  // instances. Pass nullptr to write the dumps of new instances directly.
+  static void SetAsyncWriter(ApmDataDumpWriter* writer) {
+#if WEBRTC_APM_DEBUG_DUMP == 1
+    async_writer_ = writer;
+#endif
+  }
+
+  // Returns the name of the file that ApmDataDumper writes the data dumped
+  // under `name` into.
+  static std::string FormFileName(absl::string_view output_dir,
+                                  absl::string_view name,
+                                  int instance_index,
+                                  int reinit_index,
+                                  absl::string_view suffix);
+
   // Set an optional output directory.
   static void SetOutputDirectory(absl::string_view output_dir) {
 #if WEBRTC_APM_DEBUG_DUMP == 1
@@ -115,8 +140,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(&v, sizeof(v), 1, file);
+      WriteRaw(name, &v, sizeof(v));
     }
 #endif
   }
@@ -130,8 +154,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(v, sizeof(v[0]), v_length, file);
+      WriteRaw(name, v, v_length * sizeof(v[0]));
     }
 #endif
   }
@@ -157,8 +180,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(&v, sizeof(v), 1, file);
+      WriteRaw(name, &v, sizeof(v));
     }
 #endif
   }
@@ -172,8 +194,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(v, sizeof(v[0]), v_length, file);
+      WriteRaw(name, v, v_length * sizeof(v[0]));
     }
 #endif
   }
@@ -211,6 +232,19 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
+      if (ApmDataDumpRing* ring = GetRing()) {
+        uint8_t* data = ring->Reserve(name, ApmDataDumpFormat::kRaw,
+                                      instance_index_, recording_set_index_, 0,
+                                      0, v_length * sizeof(int16_t));
+        if (data) {
+          for (size_t k = 0; k < v_length; ++k) {
+            int16_t value = static_cast<int16_t>(v[k]);
+            memcpy(data + k * sizeof(value), &value, sizeof(value));
+          }
+          ring->Commit();
+        }
+        return;
+      }
       FILE* file = GetRawFile(name);
       for (size_t k = 0; k < v_length; ++k) {
         int16_t value = static_cast<int16_t>(v[k]);
@@ -241,8 +275,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(&v, sizeof(v), 1, file);
+      WriteRaw(name, &v, sizeof(v));
     }
 #endif
   }
@@ -256,8 +289,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(v, sizeof(v[0]), v_length, file);
+      WriteRaw(name, v, v_length * sizeof(v[0]));
     }
 #endif
   }
@@ -283,8 +315,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(&v, sizeof(v), 1, file);
+      WriteRaw(name, &v, sizeof(v));
     }
 #endif
   }
@@ -298,8 +329,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(v, sizeof(v[0]), v_length, file);
+      WriteRaw(name, v, v_length * sizeof(v[0]));
     }
 #endif
   }
@@ -312,8 +342,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(&v, sizeof(v), 1, file);
+      WriteRaw(name, &v, sizeof(v));
     }
 #endif
   }
@@ -327,8 +356,7 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
-      FILE* file = GetRawFile(name);
-      fwrite(v, sizeof(v[0]), v_length, file);
+      WriteRaw(name, v, v_length * sizeof(v[0]));
     }
 #endif
   }
@@ -368,6 +396,14 @@ class ApmDataDumper {
       return;
 
     if (recording_activated_) {
+      if (ApmDataDumpRing* ring = GetRing()) {
+        ring->Write(name, ApmDataDumpFormat::kWav, instance_index_,
+                    recording_set_index_, sample_rate_hz, num_channels,
+                    rtc::ArrayView<const uint8_t>(
+                        reinterpret_cast<const uint8_t*>(v),
+                        v_length * sizeof(v[0])));
+        return;
+      }
       WavWriter* file = GetWavFile(name, sample_rate_hz, num_channels,
                                    WavFile::SampleFormat::kFloat);
       file->WriteSamples(v, v_length);
@@ -396,12 +432,28 @@ class ApmDataDumper {
   static absl::optional<int> dump_set_to_use_;
   static constexpr size_t kOutputDirMaxLength = 1024;
   static char output_dir_[kOutputDirMaxLength];
+  static ApmDataDumpWriter* async_writer_;
   const int instance_index_;
   int recording_set_index_ = 0;
+  ApmDataDumpWriter* ring_writer_ = nullptr;
+  ApmDataDumpRing* ring_ = nullptr;
   std::unordered_map<std::string, std::unique_ptr<FILE, RawFileCloseFunctor>>
       raw_files_;
   std::unordered_map<std::string, std::unique_ptr<WavWriter>> wav_files_;
 
+  // Returns the ring to write the dumps into, or nullptr if the dumps are
+  // written directly to the files.
+  ApmDataDumpRing* GetRing() {
+    if (!ring_ && async_writer_) {
+      ring_writer_ = async_writer_;
+      ring_ = ring_writer_->CreateRing();
+    }
+    return ring_;
+  }
+
+  // Writes `size` bytes of raw data.
+  void WriteRaw(absl::string_view name, const void* data, size_t size);
+
   FILE* GetRawFile(absl::string_view name);
   WavWriter* GetWavFile(absl::string_view name,
                         int sample_rate_hz,
@@ -0,0 +1,25 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Splits a dump file written by ApmDataDumpWriter into the per-variable .dat
+// and .wav files that ApmDataDumper writes without a writer, so that the
+// existing analysis scripts can be used on them.
+
+#include <stdio.h>
+
+#include "modules/audio_processing/logging/apm_data_dump_reader.h"
+
+int main(int argc, char* argv[]) {
+  if (argc != 2 && argc != 3) {
+    fprintf(stderr, "Usage: %s <dump file> [output directory]\n", argv[0]);
+    return 1;
+  }
+  return webrtc::SplitApmDataDump(argv[1], argc == 3 ? argv[2] : "") ? 0 : 1;
+}
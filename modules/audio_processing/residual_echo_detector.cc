@@ -42,14 +42,24 @@ namespace webrtc {
 
 std::atomic<int> ResidualEchoDetector::instance_count_(0);
 
-ResidualEchoDetector::ResidualEchoDetector()
+ResidualEchoDetector::ResidualEchoDetector() : ResidualEchoDetector(1) {}
+
+ResidualEchoDetector::ResidualEchoDetector(size_t delay_stride)
     : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
       render_buffer_(kRenderBufferSize),
-      render_power_(kLookbackFrames),
-      render_power_mean_(kLookbackFrames),
-      render_power_std_dev_(kLookbackFrames),
-      covariances_(kLookbackFrames),
-      recent_likelihood_max_(kAggregationBufferSize) {}
+      delay_stride_(delay_stride),
+      render_power_(2 * kLookbackFrames),
+      render_power_mean_(2 * kLookbackFrames),
+      render_power_std_dev_(2 * kLookbackFrames),
+      covariances_((kLookbackFrames + delay_stride - 1) / delay_stride),
+      recent_likelihood_max_(kAggregationBufferSize) {
+  RTC_DCHECK_LT(0, delay_stride);
+  if (delay_stride_ > 1) {
+    strided_render_power_.resize(covariances_.size());
+    strided_render_power_mean_.resize(covariances_.size());
+    strided_render_power_std_dev_.resize(covariances_.size());
+  }
+}
 
 ResidualEchoDetector::~ResidualEchoDetector() = default;
 
@@ -99,10 +109,12 @@ void ResidualEchoDetector::AnalyzeCaptureAudio(
   // Update the render statistics, and store the statistics in circular buffers.
   render_statistics_.Update(*buffered_render_power);
   RTC_DCHECK_LT(next_insertion_index_, kLookbackFrames);
-  render_power_[next_insertion_index_] = *buffered_render_power;
-  render_power_mean_[next_insertion_index_] = render_statistics_.mean();
-  render_power_std_dev_[next_insertion_index_] =
-      render_statistics_.std_deviation();
+  for (size_t index :
+       {next_insertion_index_, next_insertion_index_ + kLookbackFrames}) {
+    render_power_[index] = *buffered_render_power;
+    render_power_mean_[index] = render_statistics_.mean();
+    render_power_std_dev_[index] = render_statistics_.std_deviation();
+  }
 
   // Get the next capture value, update capture statistics and add the relevant
   // values to the buffers.
@@ -112,22 +124,38 @@ void ResidualEchoDetector::AnalyzeCaptureAudio(
   const float capture_std_deviation = capture_statistics_.std_deviation();
 
   // Update the covariance values and determine the new echo likelihood.
-  echo_likelihood_ = 0.f;
-  size_t read_index = next_insertion_index_;
+  rtc::ArrayView<const float> render_power(
+      &render_power_[next_insertion_index_], kLookbackFrames);
+  rtc::ArrayView<const float> render_power_mean(
+      &render_power_mean_[next_insertion_index_], kLookbackFrames);
+  rtc::ArrayView<const float> render_power_std_dev(
+      &render_power_std_dev_[next_insertion_index_], kLookbackFrames);
+  if (delay_stride_ > 1) {
+    for (size_t k = 0; k < covariances_.size(); ++k) {
+      strided_render_power_[k] = render_power[k * delay_stride_];
+      strided_render_power_mean_[k] = render_power_mean[k * delay_stride_];
+      strided_render_power_std_dev_[k] =
+          render_power_std_dev[k * delay_stride_];
+    }
+    covariances_.Update(capture_power, capture_mean, capture_std_deviation,
+                        strided_render_power_, strided_render_power_mean_,
+                        strided_render_power_std_dev_);
+  } else {
+    covariances_.Update(capture_power, capture_mean, capture_std_deviation,
+                        render_power, render_power_mean, render_power_std_dev);
+  }
 
+  // The first delay with the largest correlation is chosen.
+  echo_likelihood_ = 0.f;
   int best_delay = -1;
-  for (size_t delay = 0; delay < covariances_.size(); ++delay) {
-    RTC_DCHECK_LT(read_index, render_power_.size());
-    covariances_[delay].Update(capture_power, capture_mean,
-                               capture_std_deviation, render_power_[read_index],
-                               render_power_mean_[read_index],
-                               render_power_std_dev_[read_index]);
-    read_index = read_index > 0 ? read_index - 1 : kLookbackFrames - 1;
-
-    if (covariances_[delay].normalized_cross_correlation() > echo_likelihood_) {
-      echo_likelihood_ = covariances_[delay].normalized_cross_correlation();
-      best_delay = static_cast<int>(delay);
-    }
+  rtc::ArrayView<const float> correlations =
+      covariances_.normalized_cross_correlations();
+  const auto max_correlation =
+      std::max_element(correlations.begin(), correlations.end());
+  if (max_correlation != correlations.end() && *max_correlation > 0.f) {
+    echo_likelihood_ = *max_correlation;
+    best_delay = static_cast<int>(
+        (max_correlation - correlations.begin()) * delay_stride_);
   }
   // This is a temporary log message to help find the underlying cause for echo
   // likelihoods > 1.0.
@@ -135,24 +163,20 @@ void ResidualEchoDetector::AnalyzeCaptureAudio(
   if (echo_likelihood_ > 1.1f) {
     // Make sure we don't spam the log.
     if (log_counter_ < 5 && best_delay != -1) {
-      size_t read_index = kLookbackFrames + next_insertion_index_ - best_delay;
-      if (read_index >= kLookbackFrames) {
-        read_index -= kLookbackFrames;
-      }
-      RTC_DCHECK_LT(read_index, render_power_.size());
       RTC_LOG_F(LS_ERROR) << "Echo detector internal state: {"
                              "Echo likelihood: "
                           << echo_likelihood_ << ", Best Delay: " << best_delay
                           << ", Covariance: "
-                          << covariances_[best_delay].covariance()
+                          << covariances_.covariances()[best_delay /
+                                                        delay_stride_]
                           << ", Last capture power: " << capture_power
                           << ", Capture mean: " << capture_mean
                           << ", Capture_standard deviation: "
                           << capture_std_deviation << ", Last render power: "
-                          << render_power_[read_index]
-                          << ", Render mean: " << render_power_mean_[read_index]
+                          << render_power[best_delay]
+                          << ", Render mean: " << render_power_mean[best_delay]
                           << ", Render standard deviation: "
-                          << render_power_std_dev_[read_index]
+                          << render_power_std_dev[best_delay]
                           << ", Reliability: " << reliability_ << "}";
       log_counter_++;
     }
@@ -172,9 +196,8 @@ void ResidualEchoDetector::AnalyzeCaptureAudio(
   recent_likelihood_max_.Update(echo_likelihood_);
 
   // Update the next insertion index.
-  next_insertion_index_ = next_insertion_index_ < (kLookbackFrames - 1)
-                              ? next_insertion_index_ + 1
-                              : 0;
+  next_insertion_index_ = next_insertion_index_ > 0 ? next_insertion_index_ - 1
+                                                    : kLookbackFrames - 1;
 }
 
 void ResidualEchoDetector::Initialize(int /*capture_sample_rate_hz*/,
@@ -188,9 +211,7 @@ void ResidualEchoDetector::Initialize(int /*capture_sample_rate_hz*/,
   render_statistics_.Clear();
   capture_statistics_.Clear();
   recent_likelihood_max_.Clear();
-  for (auto& cov : covariances_) {
-    cov.Clear();
-  }
+  covariances_.Clear();
   echo_likelihood_ = 0.f;
   next_insertion_index_ = 0;
   reliability_ = 0.f;
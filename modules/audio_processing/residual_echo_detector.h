@@ -29,6 +29,10 @@ class AudioBuffer;
 class ResidualEchoDetector : public EchoDetector {
  public:
   ResidualEchoDetector();
+  // Only estimates the covariances for every `delay_stride`-th delay, which
+  // lowers the complexity by the same factor at the cost of resolution. The
+  // default is 1, which covers all delays.
+  explicit ResidualEchoDetector(size_t delay_stride);
   ~ResidualEchoDetector() override;
 
   // This function should be called while holding the render lock.
@@ -64,13 +68,21 @@ class ResidualEchoDetector : public EchoDetector {
   // situation.
   size_t frames_since_zero_buffer_size_ = 0;
 
+  const size_t delay_stride_;
   // Circular buffers containing delayed versions of the power, mean and
-  // standard deviation, for calculating the delayed covariance values.
+  // standard deviation, for calculating the delayed covariance values. The
+  // values are inserted in order of decreasing index and are stored twice,
+  // `kLookbackFrames` elements apart, so that the values for all delays are
+  // contiguous starting at `next_insertion_index_`.
   std::vector<float> render_power_;
   std::vector<float> render_power_mean_;
   std::vector<float> render_power_std_dev_;
-  // Covariance estimates for different delay values.
-  std::vector<NormalizedCovarianceEstimator> covariances_;
+  // The delayed values for the delays covered when `delay_stride_` > 1.
+  std::vector<float> strided_render_power_;
+  std::vector<float> strided_render_power_mean_;
+  std::vector<float> strided_render_power_std_dev_;
+  // Covariance estimates for the delay values 0, `delay_stride_`, ...
+  NormalizedCovarianceEstimatorBank covariances_;
   // Index where next element should be inserted in all of the above circular
   // buffers.
   size_t next_insertion_index_ = 0;
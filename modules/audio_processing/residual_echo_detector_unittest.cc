@@ -44,6 +44,24 @@ TEST(ResidualEchoDetectorTests, Echo) {
   EXPECT_NEAR(1.f, ed_metrics.echo_likelihood.value(), 0.01f);
 }
 
+TEST(ResidualEchoDetectorTests, EchoWithDelayStride) {
+  auto echo_detector = rtc::make_ref_counted<ResidualEchoDetector>(2);
+  echo_detector->SetReliabilityForTest(1.0f);
+  std::vector<float> ones(160, 1.f);
+  std::vector<float> zeros(160, 0.f);
+
+  // In this test the capture signal has a delay of 10 frames w.r.t. the render
+  // signal, which is one of the delays covered with a delay stride of 2.
+  for (int i = 0; i < 1000; i++) {
+    echo_detector->AnalyzeRenderAudio(i % 20 == 0 ? ones : zeros);
+    echo_detector->AnalyzeCaptureAudio(i % 20 == 10 ? ones : zeros);
+  }
+  // We expect to detect echo with near certain likelihood.
+  auto ed_metrics = echo_detector->GetMetrics();
+  ASSERT_TRUE(ed_metrics.echo_likelihood);
+  EXPECT_NEAR(1.f, ed_metrics.echo_likelihood.value(), 0.01f);
+}
+
 TEST(ResidualEchoDetectorTests, NoEcho) {
   auto echo_detector = rtc::make_ref_counted<ResidualEchoDetector>();
   echo_detector->SetReliabilityForTest(1.0f);
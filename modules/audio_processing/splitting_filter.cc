@@ -16,12 +16,212 @@
 #include "common_audio/channel_buffer.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "rtc_base/checks.h"
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
     namespace {
 
         constexpr size_t kSamplesPerBand = 160;
         constexpr size_t kTwoBandFilterSamplesPerFrame = 320;
+        constexpr int kNumLanes = TwoBandsFloatStates::kNumLanes;
+
+        // Coefficients of the three all-pass sections for each lane of the
+        // floating-point filter bank. The lanes hold the even and the odd
+        // polyphase branch of two channels. The values are the Q16 coefficients
+        // of WebRtcSpl_AnalysisQMF and WebRtcSpl_SynthesisQMF, which filter the
+        // even branch with kAllPassFilter2 in the analysis and with
+        // kAllPassFilter1 in the synthesis.
+        constexpr float kQ16 = 1.f / 65536.f;
+        constexpr float kAnalysisCoefficients[3][kNumLanes] = {
+            {21333 * kQ16, 6418 * kQ16, 21333 * kQ16, 6418 * kQ16},
+            {49062 * kQ16, 36982 * kQ16, 49062 * kQ16, 36982 * kQ16},
+            {63010 * kQ16, 57261 * kQ16, 63010 * kQ16, 57261 * kQ16}};
+        constexpr float kSynthesisCoefficients[3][kNumLanes] = {
+            {6418 * kQ16, 21333 * kQ16, 6418 * kQ16, 21333 * kQ16},
+            {36982 * kQ16, 49062 * kQ16, 36982 * kQ16, 49062 * kQ16},
+            {57261 * kQ16, 63010 * kQ16, 57261 * kQ16, 63010 * kQ16}};
+
+        // Silent input and discarded output of the unused lanes when the
+        // number of channels is odd.
+        constexpr float kZeroFrame[kTwoBandFilterSamplesPerFrame] = {};
+
+        bool IsSse2Available() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            return GetCPUInfo(kSSE2) != 0;
+#else
+            return false;
+#endif
+        }
+
+        // Filters one sample of each lane through the three cascaded all-pass
+        // sections y[n] = x[n-1] + a * (x[n] - y[n-1]). The state holds x[-1]
+        // and y[-1] of each section.
+        void AllPassQmfLanes(const float coefficients[3][kNumLanes],
+            float state[TwoBandsFloatStates::kStateSize][kNumLanes],
+            float x[kNumLanes]) {
+            for (int s = 0; s < 3; ++s) {
+                for (int l = 0; l < kNumLanes; ++l) {
+                    const float y = state[2 * s][l] +
+                        coefficients[s][l] * (x[l] - state[2 * s + 1][l]);
+                    state[2 * s][l] = x[l];
+                    state[2 * s + 1][l] = y;
+                    x[l] = y;
+                }
+            }
+        }
+
+        // Splits the full-band frames of two channels into low and high bands.
+        void TwoBandsFloatAnalysisLanes(const float* full_band0,
+            const float* full_band1,
+            float* low_band0,
+            float* high_band0,
+            float* low_band1,
+            float* high_band1,
+            TwoBandsFloatStates* states) {
+            for (size_t n = 0; n < kSamplesPerBand; ++n) {
+                float x[kNumLanes] = {full_band0[2 * n], full_band0[2 * n + 1],
+                                      full_band1[2 * n], full_band1[2 * n + 1]};
+                AllPassQmfLanes(kAnalysisCoefficients, states->analysis_state,
+                    x);
+                low_band0[n] = 0.5f * (x[0] + x[1]);
+                high_band0[n] = 0.5f * (x[1] - x[0]);
+                low_band1[n] = 0.5f * (x[2] + x[3]);
+                high_band1[n] = 0.5f * (x[3] - x[2]);
+            }
+        }
+
+        // Merges the low and high bands of two channels into full-band frames.
+        void TwoBandsFloatSynthesisLanes(const float* low_band0,
+            const float* high_band0,
+            const float* low_band1,
+            const float* high_band1,
+            float* full_band0,
+            float* full_band1,
+            TwoBandsFloatStates* states) {
+            for (size_t n = 0; n < kSamplesPerBand; ++n) {
+                float x[kNumLanes] = {low_band0[n] - high_band0[n],
+                                      low_band0[n] + high_band0[n],
+                                      low_band1[n] - high_band1[n],
+                                      low_band1[n] + high_band1[n]};
+                AllPassQmfLanes(kSynthesisCoefficients,
+                    states->synthesis_state, x);
+                full_band0[2 * n] = x[0];
+                full_band0[2 * n + 1] = x[1];
+                full_band1[2 * n] = x[2];
+                full_band1[2 * n + 1] = x[3];
+            }
+        }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+        // SSE2 version of AllPassQmfLanes, with the state kept in registers.
+        inline __m128 AllPassQmfLanes_SSE2(const __m128 coefficients[3],
+            __m128 state[TwoBandsFloatStates::kStateSize],
+            __m128 x) {
+            for (int s = 0; s < 3; ++s) {
+                const __m128 diff = _mm_sub_ps(x, state[2 * s + 1]);
+                const __m128 y =
+                    _mm_add_ps(state[2 * s], _mm_mul_ps(coefficients[s], diff));
+                state[2 * s] = x;
+                state[2 * s + 1] = y;
+                x = y;
+            }
+            return x;
+        }
+
+        // SSE2 version of TwoBandsFloatAnalysisLanes. The outputs of four
+        // consecutive samples are transposed to band-wise vectors before being
+        // stored.
+        void TwoBandsFloatAnalysisLanes_SSE2(const float* full_band0,
+            const float* full_band1,
+            float* low_band0,
+            float* high_band0,
+            float* low_band1,
+            float* high_band1,
+            TwoBandsFloatStates* states) {
+            static_assert(kSamplesPerBand % 4 == 0, "");
+            __m128 coefficients[3];
+            __m128 state[TwoBandsFloatStates::kStateSize];
+            for (int s = 0; s < 3; ++s) {
+                coefficients[s] = _mm_loadu_ps(kAnalysisCoefficients[s]);
+            }
+            for (int k = 0; k < TwoBandsFloatStates::kStateSize; ++k) {
+                state[k] = _mm_loadu_ps(states->analysis_state[k]);
+            }
+            const __m128 half = _mm_set1_ps(0.5f);
+            // Negates the odd branch lanes of the swapped branches.
+            const __m128 sign = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+            for (size_t n = 0; n < kSamplesPerBand; n += 4) {
+                __m128 y[4];
+                for (size_t j = 0; j < 4; ++j) {
+                    const size_t k = 2 * (n + j);
+                    __m128 x = _mm_loadl_pi(_mm_setzero_ps(),
+                        reinterpret_cast<const __m64*>(&full_band0[k]));
+                    x = _mm_loadh_pi(x,
+                        reinterpret_cast<const __m64*>(&full_band1[k]));
+                    x = AllPassQmfLanes_SSE2(coefficients, state, x);
+                    const __m128 swapped =
+                        _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+                    y[j] = _mm_mul_ps(
+                        half, _mm_add_ps(x, _mm_xor_ps(swapped, sign)));
+                }
+                _MM_TRANSPOSE4_PS(y[0], y[1], y[2], y[3]);
+                _mm_storeu_ps(&low_band0[n], y[0]);
+                _mm_storeu_ps(&high_band0[n], y[1]);
+                _mm_storeu_ps(&low_band1[n], y[2]);
+                _mm_storeu_ps(&high_band1[n], y[3]);
+            }
+            for (int k = 0; k < TwoBandsFloatStates::kStateSize; ++k) {
+                _mm_storeu_ps(states->analysis_state[k], state[k]);
+            }
+        }
+
+        // SSE2 version of TwoBandsFloatSynthesisLanes. The bands of four
+        // consecutive samples are transposed to sample-wise vectors after being
+        // loaded.
+        void TwoBandsFloatSynthesisLanes_SSE2(const float* low_band0,
+            const float* high_band0,
+            const float* low_band1,
+            const float* high_band1,
+            float* full_band0,
+            float* full_band1,
+            TwoBandsFloatStates* states) {
+            __m128 coefficients[3];
+            __m128 state[TwoBandsFloatStates::kStateSize];
+            for (int s = 0; s < 3; ++s) {
+                coefficients[s] = _mm_loadu_ps(kSynthesisCoefficients[s]);
+            }
+            for (int k = 0; k < TwoBandsFloatStates::kStateSize; ++k) {
+                state[k] = _mm_loadu_ps(states->synthesis_state[k]);
+            }
+            // Negates the high band lanes of the swapped bands.
+            const __m128 sign = _mm_set_ps(0.f, -0.f, 0.f, -0.f);
+            for (size_t n = 0; n < kSamplesPerBand; n += 4) {
+                __m128 x[4] = {_mm_loadu_ps(&low_band0[n]),
+                               _mm_loadu_ps(&high_band0[n]),
+                               _mm_loadu_ps(&low_band1[n]),
+                               _mm_loadu_ps(&high_band1[n])};
+                _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+                for (size_t j = 0; j < 4; ++j) {
+                    const __m128 swapped =
+                        _mm_shuffle_ps(x[j], x[j], _MM_SHUFFLE(2, 3, 0, 1));
+                    const __m128 y = AllPassQmfLanes_SSE2(coefficients, state,
+                        _mm_add_ps(x[j], _mm_xor_ps(swapped, sign)));
+                    const size_t k = 2 * (n + j);
+                    _mm_storel_pi(reinterpret_cast<__m64*>(&full_band0[k]), y);
+                    _mm_storeh_pi(reinterpret_cast<__m64*>(&full_band1[k]), y);
+                }
+            }
+            for (int k = 0; k < TwoBandsFloatStates::kStateSize; ++k) {
+                _mm_storeu_ps(states->synthesis_state[k], state[k]);
+            }
+        }
+#endif
 
     }  // namespace
     enum {
@@ -197,9 +397,17 @@ namespace webrtc {
 
     SplittingFilter::SplittingFilter(size_t num_channels,
         size_t num_bands,
-        size_t num_frames)
+        size_t num_frames,
+        bool use_float_two_band_filter)
         : num_bands_(num_bands),
-        two_bands_states_(num_bands_ == 2 ? num_channels : 0),
+        use_float_two_band_filter_(use_float_two_band_filter),
+        use_sse2_(IsSse2Available()),
+        two_bands_states_(num_bands_ == 2 && !use_float_two_band_filter_
+            ? num_channels
+            : 0),
+        two_bands_float_states_(num_bands_ == 2 && use_float_two_band_filter_
+            ? (num_channels + 1) / 2
+            : 0),
         three_band_filter_banks_(num_bands_ == 3 ? num_channels : 0) {
         RTC_CHECK(num_bands_ == 2 || num_bands_ == 3);
     }
@@ -213,7 +421,12 @@ namespace webrtc {
         RTC_DCHECK_EQ(data->num_frames(),
             bands->num_frames_per_band() * bands->num_bands());
         if (bands->num_bands() == 2) {
-            TwoBandsAnalysis(data, bands);
+            if (use_float_two_band_filter_) {
+                TwoBandsFloatAnalysis(data, bands);
+            }
+            else {
+                TwoBandsAnalysis(data, bands);
+            }
         }
         else if (bands->num_bands() == 3) {
             ThreeBandsAnalysis(data, bands);
@@ -227,7 +440,12 @@ namespace webrtc {
         RTC_DCHECK_EQ(data->num_frames(),
             bands->num_frames_per_band() * bands->num_bands());
         if (bands->num_bands() == 2) {
-            TwoBandsSynthesis(bands, data);
+            if (use_float_two_band_filter_) {
+                TwoBandsFloatSynthesis(bands, data);
+            }
+            else {
+                TwoBandsSynthesis(bands, data);
+            }
         }
         else if (bands->num_bands() == 3) {
             ThreeBandsSynthesis(bands, data);
@@ -269,6 +487,75 @@ namespace webrtc {
         }
     }
 
+    void SplittingFilter::TwoBandsFloatAnalysis(
+        const ChannelBuffer<float>* data,
+        ChannelBuffer<float>* bands) {
+        RTC_DCHECK_EQ((data->num_channels() + 1) / 2,
+            two_bands_float_states_.size());
+        RTC_DCHECK_EQ(data->num_frames(), kTwoBandFilterSamplesPerFrame);
+
+        std::array<float, kSamplesPerBand> unused_low_band;
+        std::array<float, kSamplesPerBand> unused_high_band;
+        for (size_t i = 0; i < two_bands_float_states_.size(); ++i) {
+            const size_t ch0 = 2 * i;
+            const size_t ch1 = ch0 + 1;
+            const bool has_ch1 = ch1 < data->num_channels();
+            const float* full_band1 =
+                has_ch1 ? data->channels(0)[ch1] : kZeroFrame;
+            float* low_band1 =
+                has_ch1 ? bands->channels(0)[ch1] : unused_low_band.data();
+            float* high_band1 =
+                has_ch1 ? bands->channels(1)[ch1] : unused_high_band.data();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            if (use_sse2_) {
+                TwoBandsFloatAnalysisLanes_SSE2(
+                    data->channels(0)[ch0], full_band1, bands->channels(0)[ch0],
+                    bands->channels(1)[ch0], low_band1, high_band1,
+                    &two_bands_float_states_[i]);
+                continue;
+            }
+#endif
+            TwoBandsFloatAnalysisLanes(
+                data->channels(0)[ch0], full_band1, bands->channels(0)[ch0],
+                bands->channels(1)[ch0], low_band1, high_band1,
+                &two_bands_float_states_[i]);
+        }
+    }
+
+    void SplittingFilter::TwoBandsFloatSynthesis(
+        const ChannelBuffer<float>* bands,
+        ChannelBuffer<float>* data) {
+        RTC_DCHECK_LE((data->num_channels() + 1) / 2,
+            two_bands_float_states_.size());
+        RTC_DCHECK_EQ(data->num_frames(), kTwoBandFilterSamplesPerFrame);
+
+        std::array<float, kTwoBandFilterSamplesPerFrame> unused_full_band;
+        for (size_t i = 0; 2 * i < data->num_channels(); ++i) {
+            const size_t ch0 = 2 * i;
+            const size_t ch1 = ch0 + 1;
+            const bool has_ch1 = ch1 < data->num_channels();
+            const float* low_band1 =
+                has_ch1 ? bands->channels(0)[ch1] : kZeroFrame;
+            const float* high_band1 =
+                has_ch1 ? bands->channels(1)[ch1] : kZeroFrame;
+            float* full_band1 =
+                has_ch1 ? data->channels(0)[ch1] : unused_full_band.data();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            if (use_sse2_) {
+                TwoBandsFloatSynthesisLanes_SSE2(
+                    bands->channels(0)[ch0], bands->channels(1)[ch0], low_band1,
+                    high_band1, data->channels(0)[ch0], full_band1,
+                    &two_bands_float_states_[i]);
+                continue;
+            }
+#endif
+            TwoBandsFloatSynthesisLanes(
+                bands->channels(0)[ch0], bands->channels(1)[ch0], low_band1,
+                high_band1, data->channels(0)[ch0], full_band1,
+                &two_bands_float_states_[i]);
+        }
+    }
+
     void SplittingFilter::ThreeBandsAnalysis(const ChannelBuffer<float>* data,
         ChannelBuffer<float>* bands) {
         RTC_DCHECK_EQ(three_band_filter_banks_.size(), data->num_channels());
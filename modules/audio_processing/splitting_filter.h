@@ -35,6 +35,16 @@ namespace webrtc {
         int synthesis_state2[kStateSize];
     };
 
+    // States of the floating-point two-band filter bank for a pair of channels.
+    // The all-pass cascades are run on four lanes, holding the even and the odd
+    // polyphase branch of each of the two channels.
+    struct TwoBandsFloatStates {
+        static const int kNumLanes = 4;
+        static const int kStateSize = 6;
+        float analysis_state[kStateSize][kNumLanes] = {};
+        float synthesis_state[kStateSize][kNumLanes] = {};
+    };
+
     // Splitting filter which is able to split into and merge from 2 or 3 frequency
     // bands. The number of channels needs to be provided at construction time.
     //
@@ -42,9 +52,18 @@ namespace webrtc {
     // to merge these bands again. The input and output signals are contained in
     // ChannelBuffers and for the different bands an array of ChannelBuffers is
     // used.
+    //
+    // With `use_float_two_band_filter` set, the two-band split is done using
+    // a floating-point version of the all-pass QMF filter bank, with the same
+    // band responses as the default fixed-point one, which operates directly on
+    // the float samples and processes two channels at a time. The outputs of
+    // the two versions are not bit-exact.
     class SplittingFilter {
     public:
-        SplittingFilter(size_t num_channels, size_t num_bands, size_t num_frames);
+        SplittingFilter(size_t num_channels,
+            size_t num_bands,
+            size_t num_frames,
+            bool use_float_two_band_filter = false);
         ~SplittingFilter();
 
         void Analysis(const ChannelBuffer<float>* data, ChannelBuffer<float>* bands);
@@ -56,6 +75,10 @@ namespace webrtc {
             ChannelBuffer<float>* bands);
         void TwoBandsSynthesis(const ChannelBuffer<float>* bands,
             ChannelBuffer<float>* data);
+        void TwoBandsFloatAnalysis(const ChannelBuffer<float>* data,
+            ChannelBuffer<float>* bands);
+        void TwoBandsFloatSynthesis(const ChannelBuffer<float>* bands,
+            ChannelBuffer<float>* data);
         void ThreeBandsAnalysis(const ChannelBuffer<float>* data,
             ChannelBuffer<float>* bands);
         void ThreeBandsSynthesis(const ChannelBuffer<float>* bands,
@@ -63,7 +86,10 @@ namespace webrtc {
         void InitBuffers();
 
         const size_t num_bands_;
+        const bool use_float_two_band_filter_;
+        const bool use_sse2_;
         std::vector<TwoBandsStates> two_bands_states_;
+        std::vector<TwoBandsFloatStates> two_bands_float_states_;
         std::vector<ThreeBandFilterBank> three_band_filter_banks_;
     };
 
@@ -22,6 +22,7 @@ namespace webrtc {
 namespace {
 
 const size_t kSamplesPer16kHzChannel = 160;
+const size_t kSamplesPer32kHzChannel = 320;
 const size_t kSamplesPer48kHzChannel = 480;
 
 }  // namespace
@@ -100,4 +101,56 @@ TEST(SplittingFilterTest, SplitsIntoThreeBandsAndReconstructs) {
   }
 }
 
+// Verifies that the floating-point two-band filter bank produces the same
+// bands and reconstruction as the fixed-point one, up to the int16 rounding of
+// the latter, for an odd number of channels.
+TEST(SplittingFilterTest, FloatTwoBandsMatchFixedPoint) {
+  static const int kChannels = 3;
+  static const int kSampleRateHz = 32000;
+  static const size_t kNumBands = 2;
+  static const int kFrequenciesHz[kChannels] = {1000, 9000, 15000};
+  static const float kAmplitude = 8192.f;
+  static const size_t kChunks = 10;
+  SplittingFilter fixed_filter(kChannels, kNumBands, kSamplesPer32kHzChannel);
+  SplittingFilter float_filter(kChannels, kNumBands, kSamplesPer32kHzChannel,
+                               /*use_float_two_band_filter=*/true);
+  ChannelBuffer<float> in_data(kSamplesPer32kHzChannel, kChannels);
+  ChannelBuffer<float> fixed_bands(kSamplesPer32kHzChannel, kChannels,
+                                   kNumBands);
+  ChannelBuffer<float> float_bands(kSamplesPer32kHzChannel, kChannels,
+                                   kNumBands);
+  ChannelBuffer<float> fixed_out(kSamplesPer32kHzChannel, kChannels);
+  ChannelBuffer<float> float_out(kSamplesPer32kHzChannel, kChannels);
+  for (size_t i = 0; i < kChunks; ++i) {
+    for (size_t ch = 0; ch < kChannels; ++ch) {
+      for (size_t k = 0; k < kSamplesPer32kHzChannel; ++k) {
+        const size_t t = i * kSamplesPer32kHzChannel + k;
+        in_data.channels()[ch][k] =
+            kAmplitude * sin(2.f * M_PI * kFrequenciesHz[ch] * t /
+                             kSampleRateHz) +
+            kAmplitude / 4 * sin(2.f * M_PI * 4000 * t / kSampleRateHz);
+      }
+    }
+    fixed_filter.Analysis(&in_data, &fixed_bands);
+    float_filter.Analysis(&in_data, &float_bands);
+    for (size_t band = 0; band < kNumBands; ++band) {
+      for (size_t ch = 0; ch < kChannels; ++ch) {
+        for (size_t k = 0; k < kSamplesPer16kHzChannel; ++k) {
+          EXPECT_NEAR(fixed_bands.channels(band)[ch][k],
+                      float_bands.channels(band)[ch][k], 2.f);
+        }
+      }
+    }
+
+    fixed_filter.Synthesis(&fixed_bands, &fixed_out);
+    float_filter.Synthesis(&float_bands, &float_out);
+    for (size_t ch = 0; ch < kChannels; ++ch) {
+      for (size_t k = 0; k < kSamplesPer32kHzChannel; ++k) {
+        EXPECT_NEAR(fixed_out.channels()[ch][k], float_out.channels()[ch][k],
+                    3.f);
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -35,6 +35,11 @@
 #include <array>
 
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 namespace {
@@ -100,48 +105,20 @@ const float kDctModulation[ThreeBandFilterBank::kNumNonZeroFilters][kDctSize] =
      {1.f, -2.f, 1.f},
      {1.73205077f, 0.f, -1.73205077f}};
 
-// Filters the input signal `in` with the filter `filter` using a shift by
-// `in_shift`, taking into account the previous state.
-void FilterCore(
-    rtc::ArrayView<const float, kFilterSize> filter,
-    rtc::ArrayView<const float, ThreeBandFilterBank::kSplitBandSize> in,
-    const int in_shift,
-    rtc::ArrayView<float, ThreeBandFilterBank::kSplitBandSize> out,
-    rtc::ArrayView<float, kMemorySize> state) {
-  constexpr int kMaxInShift = (kStride - 1);
-  RTC_DCHECK_GE(in_shift, 0);
-  RTC_DCHECK_LE(in_shift, kMaxInShift);
-  std::fill(out.begin(), out.end(), 0.f);
-
-  for (int k = 0; k < in_shift; ++k) {
-    for (int i = 0, j = kMemorySize + k - in_shift; i < kFilterSize;
-         ++i, j -= kStride) {
-      out[k] += state[j] * filter[i];
-    }
-  }
+// Size of the filter input buffer, which holds the filter state followed by
+// the subsampled input.
+constexpr int kFilterInputSize =
+    kMemorySize + ThreeBandFilterBank::kSplitBandSize;
 
-  for (int k = in_shift, shift = 0; k < kFilterSize * kStride; ++k, ++shift) {
-    RTC_DCHECK_GE(shift, 0);
-    const int loop_limit = std::min(kFilterSize, 1 + (shift >> kStrideLog2));
-    for (int i = 0, j = shift; i < loop_limit; ++i, j -= kStride) {
-      out[k] += in[j] * filter[i];
-    }
-    for (int i = loop_limit, j = kMemorySize + shift - loop_limit * kStride;
-         i < kFilterSize; ++i, j -= kStride) {
-      out[k] += state[j] * filter[i];
-    }
+// Returns the index of the non-zero filter to use for the polyphase component
+// `index`, or -1 if the filter is zero.
+int NonZeroFilterIndex(int index) {
+  if (index == kZeroFilterIndex1 || index == kZeroFilterIndex2) {
+    return -1;
   }
-
-  for (int k = kFilterSize * kStride, shift = kFilterSize * kStride - in_shift;
-       k < ThreeBandFilterBank::kSplitBandSize; ++k, ++shift) {
-    for (int i = 0, j = shift; i < kFilterSize; ++i, j -= kStride) {
-      out[k] += in[j] * filter[i];
-    }
-  }
-
-  // Update current state.
-  std::copy(in.begin() + ThreeBandFilterBank::kSplitBandSize - kMemorySize,
-            in.end(), state.begin());
+  return index < kZeroFilterIndex1
+             ? index
+             : (index < kZeroFilterIndex2 ? index - 1 : index - 2);
 }
 
 }  // namespace
@@ -159,10 +136,77 @@ ThreeBandFilterBank::ThreeBandFilterBank() {
     state_analysis_[k].fill(0.f);
     state_synthesis_[k].fill(0.f);
   }
+  InitializeCPUSpecificFeatures();
 }
 
 ThreeBandFilterBank::~ThreeBandFilterBank() = default;
 
+// If we know the minimum architecture at compile time, avoid CPU detection.
+void ThreeBandFilterBank::InitializeCPUSpecificFeatures() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kAVX512) != 0) {
+    filter_proc_ = FilterAndAccumulate_AVX512;
+  } else if (GetCPUInfo(kAVX2) != 0 && GetCPUInfo(kFMA3) != 0) {
+    filter_proc_ = FilterAndAccumulate_AVX2;
+  } else if (GetCPUInfo(kSSE2) != 0) {
+    filter_proc_ = FilterAndAccumulate_SSE2;
+  } else {
+    filter_proc_ = FilterAndAccumulate;
+  }
+#else
+  filter_proc_ = FilterAndAccumulate;
+#endif
+}
+
+// The filter taps of the sparse filters are `kStride` samples apart, so the
+// filters are applied directly to a buffer holding the `kMemorySize` last
+// samples of the previous input followed by the current input. The outputs
+// are accumulated in the same order as by a sample-by-sample implementation.
+void ThreeBandFilterBank::FilterAndAccumulate(const float* filter,
+                                              const float* x,
+                                              const float* scaling,
+                                              int num_outputs,
+                                              float* const* out) {
+  for (int k = 0; k < kSplitBandSize; ++k) {
+    float y = 0.f;
+    for (int i = 0; i < kFilterSize; ++i) {
+      y += x[k - kStride * i] * filter[i];
+    }
+    for (int j = 0; j < num_outputs; ++j) {
+      out[j][k] += scaling[j] * y;
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void ThreeBandFilterBank::FilterAndAccumulate_SSE2(const float* filter,
+                                                   const float* x,
+                                                   const float* scaling,
+                                                   int num_outputs,
+                                                   float* const* out) {
+  static_assert(kSplitBandSize % 4 == 0, "");
+  RTC_DCHECK_LE(num_outputs, kNumBands);
+  __m128 f[kFilterSize];
+  for (int i = 0; i < kFilterSize; ++i) {
+    f[i] = _mm_set1_ps(filter[i]);
+  }
+  __m128 g[kNumBands];
+  for (int j = 0; j < num_outputs; ++j) {
+    g[j] = _mm_set1_ps(scaling[j]);
+  }
+  for (int k = 0; k < kSplitBandSize; k += 4) {
+    __m128 y = _mm_setzero_ps();
+    for (int i = 0; i < kFilterSize; ++i) {
+      y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(&x[k - kStride * i]), f[i]));
+    }
+    for (int j = 0; j < num_outputs; ++j) {
+      const __m128 out_j = _mm_loadu_ps(&out[j][k]);
+      _mm_storeu_ps(&out[j][k], _mm_add_ps(out_j, _mm_mul_ps(g[j], y)));
+    }
+  }
+}
+#endif
+
 // The analysis can be separated in these steps:
 //   1. Serial to parallel downsampling by a factor of `kNumBands`.
 //   2. Filtering of `kSparsity` different delayed signals with polyphase
@@ -174,15 +218,18 @@ void ThreeBandFilterBank::Analysis(
     rtc::ArrayView<const rtc::ArrayView<float>, ThreeBandFilterBank::kNumBands>
         out) {
   // Initialize the output to zero.
+  float* out_bands[ThreeBandFilterBank::kNumBands];
   for (int band = 0; band < ThreeBandFilterBank::kNumBands; ++band) {
     RTC_DCHECK_EQ(out[band].size(), kSplitBandSize);
     std::fill(out[band].begin(), out[band].end(), 0);
+    out_bands[band] = out[band].data();
   }
 
   for (int downsampling_index = 0; downsampling_index < kSubSampling;
        ++downsampling_index) {
-    // Downsample to form the filter input.
-    std::array<float, kSplitBandSize> in_subsampled;
+    // Downsample to form the filter input, after the filter state.
+    std::array<float, kFilterInputSize> filter_input;
+    float* in_subsampled = &filter_input[kMemorySize];
     for (int k = 0; k < kSplitBandSize; ++k) {
       in_subsampled[k] =
           in[(kSubSampling - 1) - downsampling_index + kSubSampling * k];
@@ -190,32 +237,23 @@ void ThreeBandFilterBank::Analysis(
 
     for (int in_shift = 0; in_shift < kStride; ++in_shift) {
       // Choose filter, skip zero filters.
-      const int index = downsampling_index + in_shift * kSubSampling;
-      if (index == kZeroFilterIndex1 || index == kZeroFilterIndex2) {
-        continue;
-      }
       const int filter_index =
-          index < kZeroFilterIndex1
-              ? index
-              : (index < kZeroFilterIndex2 ? index - 1 : index - 2);
-
-      rtc::ArrayView<const float, kFilterSize> filter(
-          kFilterCoeffs[filter_index]);
-      rtc::ArrayView<const float, kDctSize> dct_modulation(
-          kDctModulation[filter_index]);
-      rtc::ArrayView<float, kMemorySize> state(state_analysis_[filter_index]);
-
-      // Filter.
-      std::array<float, kSplitBandSize> out_subsampled;
-      FilterCore(filter, in_subsampled, in_shift, out_subsampled, state);
-
-      // Band and modulate the output.
-      for (int band = 0; band < ThreeBandFilterBank::kNumBands; ++band) {
-        float* out_band = out[band].data();
-        for (int n = 0; n < kSplitBandSize; ++n) {
-          out_band[n] += dct_modulation[band] * out_subsampled[n];
-        }
+          NonZeroFilterIndex(downsampling_index + in_shift * kSubSampling);
+      if (filter_index < 0) {
+        continue;
       }
+      std::array<float, kMemorySize>& state = state_analysis_[filter_index];
+
+      // Filter, band and modulate the output.
+      std::copy(state.begin(), state.end(), filter_input.begin());
+      filter_proc_(kFilterCoeffs[filter_index],
+                   &filter_input[kMemorySize - in_shift],
+                   kDctModulation[filter_index], ThreeBandFilterBank::kNumBands,
+                   out_bands);
+
+      // Update current state.
+      std::copy(filter_input.end() - kMemorySize, filter_input.end(),
+                state.begin());
     }
   }
 }
@@ -230,47 +268,52 @@ void ThreeBandFilterBank::Synthesis(
     rtc::ArrayView<const rtc::ArrayView<float>, ThreeBandFilterBank::kNumBands>
         in,
     rtc::ArrayView<float, kFullBandSize> out) {
-  std::fill(out.begin(), out.end(), 0);
+  for (int band = 0; band < ThreeBandFilterBank::kNumBands; ++band) {
+    RTC_DCHECK_EQ(in[band].size(), kSplitBandSize);
+  }
   for (int upsampling_index = 0; upsampling_index < kSubSampling;
        ++upsampling_index) {
+    std::array<float, kSplitBandSize> out_subsampled;
+    out_subsampled.fill(0.f);
+    float* out_subsampled_ptr = out_subsampled.data();
+
     for (int in_shift = 0; in_shift < kStride; ++in_shift) {
       // Choose filter, skip zero filters.
-      const int index = upsampling_index + in_shift * kSubSampling;
-      if (index == kZeroFilterIndex1 || index == kZeroFilterIndex2) {
+      const int filter_index =
+          NonZeroFilterIndex(upsampling_index + in_shift * kSubSampling);
+      if (filter_index < 0) {
         continue;
       }
-      const int filter_index =
-          index < kZeroFilterIndex1
-              ? index
-              : (index < kZeroFilterIndex2 ? index - 1 : index - 2);
-
-      rtc::ArrayView<const float, kFilterSize> filter(
-          kFilterCoeffs[filter_index]);
-      rtc::ArrayView<const float, kDctSize> dct_modulation(
-          kDctModulation[filter_index]);
-      rtc::ArrayView<float, kMemorySize> state(state_synthesis_[filter_index]);
-
-      // Prepare filter input by modulating the banded input.
-      std::array<float, kSplitBandSize> in_subsampled;
-      std::fill(in_subsampled.begin(), in_subsampled.end(), 0.f);
+      const float* dct_modulation = kDctModulation[filter_index];
+      std::array<float, kMemorySize>& state = state_synthesis_[filter_index];
+
+      // Prepare filter input by modulating the banded input, after the filter
+      // state.
+      std::array<float, kFilterInputSize> filter_input;
+      std::copy(state.begin(), state.end(), filter_input.begin());
+      float* in_subsampled = &filter_input[kMemorySize];
+      std::fill(in_subsampled, in_subsampled + kSplitBandSize, 0.f);
       for (int band = 0; band < ThreeBandFilterBank::kNumBands; ++band) {
-        RTC_DCHECK_EQ(in[band].size(), kSplitBandSize);
         const float* in_band = in[band].data();
         for (int n = 0; n < kSplitBandSize; ++n) {
           in_subsampled[n] += dct_modulation[band] * in_band[n];
         }
       }
 
-      // Filter.
-      std::array<float, kSplitBandSize> out_subsampled;
-      FilterCore(filter, in_subsampled, in_shift, out_subsampled, state);
-
-      // Upsample.
+      // Filter and accumulate the upsampling scaled output.
       constexpr float kUpsamplingScaling = kSubSampling;
-      for (int k = 0; k < kSplitBandSize; ++k) {
-        out[upsampling_index + kSubSampling * k] +=
-            kUpsamplingScaling * out_subsampled[k];
-      }
+      filter_proc_(kFilterCoeffs[filter_index],
+                   &filter_input[kMemorySize - in_shift], &kUpsamplingScaling,
+                   1, &out_subsampled_ptr);
+
+      // Update current state.
+      std::copy(filter_input.end() - kMemorySize, filter_input.end(),
+                state.begin());
+    }
+
+    // Upsample.
+    for (int k = 0; k < kSplitBandSize; ++k) {
+      out[upsampling_index + kSubSampling * k] = out_subsampled[k];
     }
   }
 }
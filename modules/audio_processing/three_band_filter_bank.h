@@ -17,6 +17,8 @@
 #include <vector>
 
 #include "api/array_view.h"
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
@@ -65,7 +67,45 @@ class ThreeBandFilterBank final {
   void Synthesis(rtc::ArrayView<const rtc::ArrayView<float>, kNumBands> in,
                  rtc::ArrayView<float, kFullBandSize> out);
 
+  // Filters `x` with one of the sparse polyphase filters, i.e., computes
+  // y[k] = sum_i filter[i] * x[k - kStride * i] for the kSplitBandSize outputs,
+  // and adds y[k] scaled by each of the `num_outputs` values in `scaling` to
+  // the corresponding `out` array. The SIMD versions are bit-exact with the
+  // generic one. Exposed for testing.
+  static void FilterAndAccumulate(const float* filter,
+                                  const float* x,
+                                  const float* scaling,
+                                  int num_outputs,
+                                  float* const* out);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void FilterAndAccumulate_SSE2(const float* filter,
+                                       const float* x,
+                                       const float* scaling,
+                                       int num_outputs,
+                                       float* const* out);
+  static void FilterAndAccumulate_AVX2(const float* filter,
+                                       const float* x,
+                                       const float* scaling,
+                                       int num_outputs,
+                                       float* const* out);
+  static void FilterAndAccumulate_AVX512(const float* filter,
+                                         const float* x,
+                                         const float* scaling,
+                                         int num_outputs,
+                                         float* const* out);
+#endif
+
  private:
+  typedef void (*FilterAndAccumulateProc)(const float*,
+                                          const float*,
+                                          const float*,
+                                          int,
+                                          float* const*);
+
+  // Selects the FilterAndAccumulate version supported by the CPU.
+  void InitializeCPUSpecificFeatures();
+
+  FilterAndAccumulateProc filter_proc_;
   std::array<std::array<float, kMemorySize>, kNumNonZeroFilters>
       state_analysis_;
   std::array<std::array<float, kMemorySize>, kNumNonZeroFilters>
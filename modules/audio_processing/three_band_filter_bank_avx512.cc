@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/three_band_filter_bank.h"
+
+#include <immintrin.h>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+void ThreeBandFilterBank::FilterAndAccumulate_AVX512(const float* filter,
+                                                     const float* x,
+                                                     const float* scaling,
+                                                     int num_outputs,
+                                                     float* const* out) {
+  static_assert(kSplitBandSize % 16 == 0, "");
+  RTC_DCHECK_LE(num_outputs, kNumBands);
+  __m512 f[kFilterSize];
+  for (int i = 0; i < kFilterSize; ++i) {
+    f[i] = _mm512_set1_ps(filter[i]);
+  }
+  __m512 g[kNumBands];
+  for (int j = 0; j < num_outputs; ++j) {
+    g[j] = _mm512_set1_ps(scaling[j]);
+  }
+  for (int k = 0; k < kSplitBandSize; k += 16) {
+    __m512 y = _mm512_setzero_ps();
+    for (int i = 0; i < kFilterSize; ++i) {
+      const __m512 x_i = _mm512_loadu_ps(&x[k - kStride * i]);
+      y = _mm512_add_ps(y, _mm512_mul_ps(x_i, f[i]));
+    }
+    for (int j = 0; j < num_outputs; ++j) {
+      const __m512 out_j = _mm512_loadu_ps(&out[j][k]);
+      _mm512_storeu_ps(&out[j][k],
+                       _mm512_add_ps(out_j, _mm512_mul_ps(g[j], y)));
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/three_band_filter_bank.h"
+
+#include <array>
+
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSplitBandSize = ThreeBandFilterBank::kSplitBandSize;
+constexpr int kNumBands = ThreeBandFilterBank::kNumBands;
+
+typedef void (*FilterAndAccumulateProc)(const float*,
+                                        const float*,
+                                        const float*,
+                                        int,
+                                        float* const*);
+
+// Returns a random value in [-scale, scale).
+float RandomValue(Random* random_generator, float scale) {
+  return scale * (2.f * random_generator->Rand<float>() - 1.f);
+}
+
+// Verifies that `proc` produces the same output as the generic
+// FilterAndAccumulate for all input shifts and numbers of outputs.
+void VerifyBitExactness(FilterAndAccumulateProc proc) {
+  Random random_generator(42U);
+  std::array<float, kMemorySize + kSplitBandSize> x;
+  std::array<float, kFilterSize> filter;
+  std::array<float, kNumBands> scaling;
+  for (int trial = 0; trial < 10; ++trial) {
+    for (float& x_k : x) {
+      x_k = RandomValue(&random_generator, 32768.f);
+    }
+    for (float& f : filter) {
+      f = RandomValue(&random_generator, 0.2f);
+    }
+    for (float& g : scaling) {
+      g = RandomValue(&random_generator, 2.f);
+    }
+    for (int in_shift = 0; in_shift < kStride; ++in_shift) {
+      for (int num_outputs = 1; num_outputs <= kNumBands; ++num_outputs) {
+        std::array<std::array<float, kSplitBandSize>, kNumBands> out;
+        std::array<std::array<float, kSplitBandSize>, kNumBands> out_ref;
+        float* out_ptrs[kNumBands];
+        float* out_ref_ptrs[kNumBands];
+        for (int j = 0; j < kNumBands; ++j) {
+          for (int k = 0; k < kSplitBandSize; ++k) {
+            out[j][k] = out_ref[j][k] = RandomValue(&random_generator, 1.f);
+          }
+          out_ptrs[j] = out[j].data();
+          out_ref_ptrs[j] = out_ref[j].data();
+        }
+        const float* x_shifted = &x[kMemorySize - in_shift];
+        ThreeBandFilterBank::FilterAndAccumulate(filter.data(), x_shifted,
+                                                 scaling.data(), num_outputs,
+                                                 out_ref_ptrs);
+        proc(filter.data(), x_shifted, scaling.data(), num_outputs, out_ptrs);
+        for (int j = 0; j < kNumBands; ++j) {
+          for (int k = 0; k < kSplitBandSize; ++k) {
+            ASSERT_EQ(out_ref[j][k], out[j][k]);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Verifies that the optimized filter kernels are bit-exact with the generic
+// one.
+TEST(ThreeBandFilterBank, FilterAndAccumulateSse2BitExactness) {
+  if (GetCPUInfo(kSSE2) != 0) {
+    VerifyBitExactness(ThreeBandFilterBank::FilterAndAccumulate_SSE2);
+  }
+}
+
+TEST(ThreeBandFilterBank, FilterAndAccumulateAvx2BitExactness) {
+  if (GetCPUInfo(kAVX2) != 0 && GetCPUInfo(kFMA3) != 0) {
+    VerifyBitExactness(ThreeBandFilterBank::FilterAndAccumulate_AVX2);
+  }
+}
+
+TEST(ThreeBandFilterBank, FilterAndAccumulateAvx512BitExactness) {
+  if (GetCPUInfo(kAVX512) != 0) {
+    VerifyBitExactness(ThreeBandFilterBank::FilterAndAccumulate_AVX512);
+  }
+}
+#endif
+
+}  // namespace webrtc
@@ -11,9 +11,57 @@
 
 #include <algorithm>
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
+namespace {
+
+// Number of samples that each biquad is applied on before the next biquad in
+// the cascade is applied on them.
+constexpr size_t kBlockSize = 16;
+
+// Number of channels that the states are padded to.
+constexpr size_t kStateAlignment = 8;
+
+// Applies one biquad on `num_samples` samples, reading and updating the filter
+// state x[0], x[1], y[0], y[1] stored `stride` values apart. The arithmetic
+// is done in the same order as in CascadedBiQuadFilter::ApplyBiQuad.
+void ApplyStridedBiQuad(
+    const CascadedBiQuadFilter::BiQuadCoefficients& coefficients,
+    size_t stride,
+    float* state,
+    float* y,
+    size_t num_samples) {
+  const float c_a_0 = coefficients.a[0];
+  const float c_a_1 = coefficients.a[1];
+  const float c_b_0 = coefficients.b[0];
+  const float c_b_1 = coefficients.b[1];
+  const float c_b_2 = coefficients.b[2];
+  float m_x_0 = state[0];
+  float m_x_1 = state[stride];
+  float m_y_0 = state[2 * stride];
+  float m_y_1 = state[3 * stride];
+  for (size_t k = 0; k < num_samples; ++k) {
+    const float tmp = y[k];
+    y[k] = c_b_0 * tmp + c_b_1 * m_x_0 + c_b_2 * m_x_1 - c_a_0 * m_y_0 -
+           c_a_1 * m_y_1;
+    m_x_1 = m_x_0;
+    m_x_0 = tmp;
+    m_y_1 = m_y_0;
+    m_y_0 = y[k];
+  }
+  state[0] = m_x_0;
+  state[stride] = m_x_1;
+  state[2 * stride] = m_y_0;
+  state[3 * stride] = m_y_1;
+}
+
+}  // namespace
 
 CascadedBiQuadFilter::BiQuadParam::BiQuadParam(std::complex<float> zero,
                                                std::complex<float> pole,
@@ -73,10 +121,17 @@ CascadedBiQuadFilter::~CascadedBiQuadFilter() = default;
 
 void CascadedBiQuadFilter::Process(rtc::ArrayView<const float> x,
                                    rtc::ArrayView<float> y) {
-  if (biquads_.size() > 0) {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  if (biquads_.size() == 1) {
     ApplyBiQuad(x, y, &biquads_[0]);
-    for (size_t k = 1; k < biquads_.size(); ++k) {
-      ApplyBiQuad(y, y, &biquads_[k]);
+  } else if (biquads_.size() > 1) {
+    for (size_t k = 0; k < x.size(); k += kBlockSize) {
+      const size_t block_size = std::min(kBlockSize, x.size() - k);
+      rtc::ArrayView<float> y_block = y.subview(k, block_size);
+      ApplyBiQuad(x.subview(k, block_size), y_block, &biquads_[0]);
+      for (size_t b = 1; b < biquads_.size(); ++b) {
+        ApplyBiQuad(y_block, y_block, &biquads_[b]);
+      }
     }
   } else {
     std::copy(x.begin(), x.end(), y.begin());
@@ -84,8 +139,16 @@ void CascadedBiQuadFilter::Process(rtc::ArrayView<const float> x,
 }
 
 void CascadedBiQuadFilter::Process(rtc::ArrayView<float> y) {
-  for (auto& biquad : biquads_) {
-    ApplyBiQuad(y, y, &biquad);
+  if (biquads_.size() == 1) {
+    ApplyBiQuad(y, y, &biquads_[0]);
+    return;
+  }
+  for (size_t k = 0; k < y.size(); k += kBlockSize) {
+    rtc::ArrayView<float> y_block =
+        y.subview(k, std::min(kBlockSize, y.size() - k));
+    for (auto& biquad : biquads_) {
+      ApplyBiQuad(y_block, y_block, &biquad);
+    }
   }
 }
 
@@ -123,4 +186,162 @@ void CascadedBiQuadFilter::ApplyBiQuad(rtc::ArrayView<const float> x,
   biquad->y[1] = m_y_1;
 }
 
+MultiChannelCascadedBiQuadFilter::MultiChannelCascadedBiQuadFilter(
+    const CascadedBiQuadFilter::BiQuadCoefficients& coefficients,
+    size_t num_biquads,
+    size_t num_channels)
+    : num_channels_(num_channels),
+      stride_((num_channels + kStateAlignment - 1) / kStateAlignment *
+              kStateAlignment),
+      coefficients_(num_biquads, coefficients),
+      state_(4 * num_biquads * stride_, 0.f) {
+  InitializeCPUSpecificFeatures();
+}
+
+MultiChannelCascadedBiQuadFilter::MultiChannelCascadedBiQuadFilter(
+    const std::vector<CascadedBiQuadFilter::BiQuadParam>& biquad_params,
+    size_t num_channels)
+    : num_channels_(num_channels),
+      stride_((num_channels + kStateAlignment - 1) / kStateAlignment *
+              kStateAlignment),
+      state_(4 * biquad_params.size() * stride_, 0.f) {
+  for (const auto& param : biquad_params) {
+    coefficients_.push_back(CascadedBiQuadFilter::BiQuad(param).coefficients);
+  }
+  InitializeCPUSpecificFeatures();
+}
+
+MultiChannelCascadedBiQuadFilter::~MultiChannelCascadedBiQuadFilter() =
+    default;
+
+void MultiChannelCascadedBiQuadFilter::InitializeCPUSpecificFeatures() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kAVX2) != 0 && GetCPUInfo(kFMA3) != 0) {
+    eight_channel_proc_ = ProcessEightChannels_AVX2;
+  }
+  if (GetCPUInfo(kSSE2) != 0) {
+    four_channel_proc_ = ProcessFourChannels_SSE2;
+  }
+#endif
+}
+
+void MultiChannelCascadedBiQuadFilter::Process(
+    rtc::ArrayView<float* const> channels,
+    size_t num_frames) {
+  RTC_DCHECK_EQ(channels.size(), num_channels_);
+  if (coefficients_.empty()) {
+    return;
+  }
+
+  // Full groups of channels are filtered in place. A remainder of more than
+  // one channel is filtered as a group as well, with the missing channels
+  // replaced by a zero signal. The states of these padding channels lie in
+  // the padding of the state arrays and stay zero.
+  size_t ch = 0;
+  float* group[8];
+  auto process_groups = [&](ProcessGroupProc proc, size_t group_size,
+                            size_t min_num_channels) {
+    while (num_channels_ - ch >= min_num_channels) {
+      for (size_t k = 0; k < group_size; ++k) {
+        group[k] = ch + k < num_channels_ ? channels[ch + k] : scratch_.data();
+      }
+      proc(coefficients_, stride_, &state_[ch], group, num_frames);
+      ch = std::min(ch + group_size, num_channels_);
+    }
+  };
+  if (num_channels_ > 1 && scratch_.size() < num_frames) {
+    scratch_.resize(num_frames, 0.f);
+  }
+  if (eight_channel_proc_) {
+    process_groups(eight_channel_proc_, 8, 5);
+  }
+  if (four_channel_proc_) {
+    process_groups(four_channel_proc_, 4, 2);
+  }
+
+  const size_t num_vectorized_frames = ch > 0 ? num_frames & ~size_t{3} : 0;
+  for (size_t k = 0; k < num_channels_; ++k) {
+    ApplyBiQuads(&state_[k], channels[k], k < ch ? num_vectorized_frames : 0,
+                 num_frames);
+  }
+}
+
+void MultiChannelCascadedBiQuadFilter::ProcessChannel(
+    size_t channel,
+    rtc::ArrayView<float> y) {
+  RTC_DCHECK_LT(channel, num_channels_);
+  ApplyBiQuads(&state_[channel], y.data(), 0, y.size());
+}
+
+void MultiChannelCascadedBiQuadFilter::Reset() {
+  std::fill(state_.begin(), state_.end(), 0.f);
+}
+
+void MultiChannelCascadedBiQuadFilter::ApplyBiQuads(float* state,
+                                                    float* y,
+                                                    size_t begin,
+                                                    size_t end) {
+  for (size_t k = begin; k < end; k += kBlockSize) {
+    const size_t block_size = std::min(kBlockSize, end - k);
+    for (size_t b = 0; b < coefficients_.size(); ++b) {
+      ApplyStridedBiQuad(coefficients_[b], stride_, &state[4 * b * stride_],
+                         &y[k], block_size);
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void MultiChannelCascadedBiQuadFilter::ProcessFourChannels_SSE2(
+    rtc::ArrayView<const CascadedBiQuadFilter::BiQuadCoefficients>
+        coefficients,
+    size_t stride,
+    float* state,
+    float* const* channels,
+    size_t num_frames) {
+  for (size_t k = 0; k + 4 <= num_frames; k += 4) {
+    // Transpose the block so that v[i] holds sample k + i of the 4 channels.
+    __m128 v[4];
+    for (int i = 0; i < 4; ++i) {
+      v[i] = _mm_loadu_ps(&channels[i][k]);
+    }
+    _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+
+    for (size_t b = 0; b < coefficients.size(); ++b) {
+      const __m128 c_a_0 = _mm_set1_ps(coefficients[b].a[0]);
+      const __m128 c_a_1 = _mm_set1_ps(coefficients[b].a[1]);
+      const __m128 c_b_0 = _mm_set1_ps(coefficients[b].b[0]);
+      const __m128 c_b_1 = _mm_set1_ps(coefficients[b].b[1]);
+      const __m128 c_b_2 = _mm_set1_ps(coefficients[b].b[2]);
+      float* s = &state[4 * b * stride];
+      __m128 m_x_0 = _mm_loadu_ps(&s[0]);
+      __m128 m_x_1 = _mm_loadu_ps(&s[stride]);
+      __m128 m_y_0 = _mm_loadu_ps(&s[2 * stride]);
+      __m128 m_y_1 = _mm_loadu_ps(&s[3 * stride]);
+      for (int i = 0; i < 4; ++i) {
+        const __m128 tmp = v[i];
+        __m128 y = _mm_mul_ps(c_b_0, tmp);
+        y = _mm_add_ps(y, _mm_mul_ps(c_b_1, m_x_0));
+        y = _mm_add_ps(y, _mm_mul_ps(c_b_2, m_x_1));
+        y = _mm_sub_ps(y, _mm_mul_ps(c_a_0, m_y_0));
+        y = _mm_sub_ps(y, _mm_mul_ps(c_a_1, m_y_1));
+        m_x_1 = m_x_0;
+        m_x_0 = tmp;
+        m_y_1 = m_y_0;
+        m_y_0 = y;
+        v[i] = y;
+      }
+      _mm_storeu_ps(&s[0], m_x_0);
+      _mm_storeu_ps(&s[stride], m_x_1);
+      _mm_storeu_ps(&s[2 * stride], m_y_0);
+      _mm_storeu_ps(&s[3 * stride], m_y_1);
+    }
+
+    _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+    for (int i = 0; i < 4; ++i) {
+      _mm_storeu_ps(&channels[i][k], v[i]);
+    }
+  }
+}
+#endif
+
 }  // namespace webrtc
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "api/array_view.h"
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
@@ -61,6 +62,10 @@ class CascadedBiQuadFilter {
   CascadedBiQuadFilter& operator=(const CascadedBiQuadFilter&) = delete;
 
   // Applies the biquads on the values in x in order to form the output in y.
+  // When there is more than one biquad, the biquads are applied on short
+  // blocks of samples in turn so that the recursions of the different biquads
+  // can overlap in the CPU pipeline. The output is the same as when applying
+  // the biquads one by one on the whole signal.
   void Process(rtc::ArrayView<const float> x, rtc::ArrayView<float> y);
   // Applies the biquads on the values in y in an in-place manner.
   void Process(rtc::ArrayView<float> y);
@@ -75,6 +80,84 @@ class CascadedBiQuadFilter {
   std::vector<BiQuad> biquads_;
 };
 
+// Applies the same cascade of biquads on several channels. Groups of up to 8
+// or 4 channels are filtered together using AVX2 or SSE2, with all the biquads
+// applied on each block of 4 samples before moving on to the next block. The
+// output is bit-exact with that of one CascadedBiQuadFilter per channel.
+class MultiChannelCascadedBiQuadFilter {
+ public:
+  MultiChannelCascadedBiQuadFilter(
+      const CascadedBiQuadFilter::BiQuadCoefficients& coefficients,
+      size_t num_biquads,
+      size_t num_channels);
+  MultiChannelCascadedBiQuadFilter(
+      const std::vector<CascadedBiQuadFilter::BiQuadParam>& biquad_params,
+      size_t num_channels);
+  ~MultiChannelCascadedBiQuadFilter();
+  MultiChannelCascadedBiQuadFilter(const MultiChannelCascadedBiQuadFilter&) =
+      delete;
+  MultiChannelCascadedBiQuadFilter& operator=(
+      const MultiChannelCascadedBiQuadFilter&) = delete;
+
+  // Applies the biquads in-place on the first `num_frames` samples of each of
+  // the `num_channels()` arrays in `channels`.
+  void Process(rtc::ArrayView<float* const> channels, size_t num_frames);
+  // Applies the biquads in-place on the values in `y`, using the filter state
+  // of `channel`.
+  void ProcessChannel(size_t channel, rtc::ArrayView<float> y);
+  // Resets the filter states of all channels.
+  void Reset();
+
+  size_t num_channels() const { return num_channels_; }
+
+  // Filters the first `num_frames` / 4 blocks of 4 samples of 4 (SSE2) or 8
+  // (AVX2) channels. The state of channel `ch` of biquad `b` is stored as
+  // x[0], x[1], y[0], y[1] at state[(4 * b + j) * stride + ch], j = 0..3.
+  // Exposed for testing.
+  typedef void (*ProcessGroupProc)(
+      rtc::ArrayView<const CascadedBiQuadFilter::BiQuadCoefficients>
+          coefficients,
+      size_t stride,
+      float* state,
+      float* const* channels,
+      size_t num_frames);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void ProcessFourChannels_SSE2(
+      rtc::ArrayView<const CascadedBiQuadFilter::BiQuadCoefficients>
+          coefficients,
+      size_t stride,
+      float* state,
+      float* const* channels,
+      size_t num_frames);
+  static void ProcessEightChannels_AVX2(
+      rtc::ArrayView<const CascadedBiQuadFilter::BiQuadCoefficients>
+          coefficients,
+      size_t stride,
+      float* state,
+      float* const* channels,
+      size_t num_frames);
+#endif
+
+ private:
+  // Selects the group sizes supported by the CPU.
+  void InitializeCPUSpecificFeatures();
+
+  // Applies the biquads on samples `begin` to `end` of the channel whose
+  // state starts at `state`.
+  void ApplyBiQuads(float* state, float* y, size_t begin, size_t end);
+
+  const size_t num_channels_;
+  // Distance between the states of the same channel, padded to a multiple of
+  // 8 so that all SIMD groups can be loaded with unaligned loads.
+  const size_t stride_;
+  std::vector<CascadedBiQuadFilter::BiQuadCoefficients> coefficients_;
+  std::vector<float> state_;
+  // Zero signal used for the missing channels of partially filled groups.
+  std::vector<float> scratch_;
+  ProcessGroupProc eight_channel_proc_ = nullptr;
+  ProcessGroupProc four_channel_proc_ = nullptr;
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_UTILITY_CASCADED_BIQUAD_FILTER_H_
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/utility/cascaded_biquad_filter.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+void MultiChannelCascadedBiQuadFilter::ProcessEightChannels_AVX2(
+    rtc::ArrayView<const CascadedBiQuadFilter::BiQuadCoefficients>
+        coefficients,
+    size_t stride,
+    float* state,
+    float* const* channels,
+    size_t num_frames) {
+  for (size_t k = 0; k + 4 <= num_frames; k += 4) {
+    // Transpose the block so that v[i] holds sample k + i of the 8 channels.
+    __m128 lo[4];
+    __m128 hi[4];
+    for (int i = 0; i < 4; ++i) {
+      lo[i] = _mm_loadu_ps(&channels[i][k]);
+      hi[i] = _mm_loadu_ps(&channels[i + 4][k]);
+    }
+    _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+    _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+    __m256 v[4];
+    for (int i = 0; i < 4; ++i) {
+      v[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo[i]), hi[i], 1);
+    }
+
+    for (size_t b = 0; b < coefficients.size(); ++b) {
+      const __m256 c_a_0 = _mm256_set1_ps(coefficients[b].a[0]);
+      const __m256 c_a_1 = _mm256_set1_ps(coefficients[b].a[1]);
+      const __m256 c_b_0 = _mm256_set1_ps(coefficients[b].b[0]);
+      const __m256 c_b_1 = _mm256_set1_ps(coefficients[b].b[1]);
+      const __m256 c_b_2 = _mm256_set1_ps(coefficients[b].b[2]);
+      float* s = &state[4 * b * stride];
+      __m256 m_x_0 = _mm256_loadu_ps(&s[0]);
+      __m256 m_x_1 = _mm256_loadu_ps(&s[stride]);
+      __m256 m_y_0 = _mm256_loadu_ps(&s[2 * stride]);
+      __m256 m_y_1 = _mm256_loadu_ps(&s[3 * stride]);
+      // The products are not fused with the sums in order to stay bit-exact
+      // with the scalar version.
+      for (int i = 0; i < 4; ++i) {
+        const __m256 tmp = v[i];
+        __m256 y = _mm256_mul_ps(c_b_0, tmp);
+        y = _mm256_add_ps(y, _mm256_mul_ps(c_b_1, m_x_0));
+        y = _mm256_add_ps(y, _mm256_mul_ps(c_b_2, m_x_1));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(c_a_0, m_y_0));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(c_a_1, m_y_1));
+        m_x_1 = m_x_0;
+        m_x_0 = tmp;
+        m_y_1 = m_y_0;
+        m_y_0 = y;
+        v[i] = y;
+      }
+      _mm256_storeu_ps(&s[0], m_x_0);
+      _mm256_storeu_ps(&s[stride], m_x_1);
+      _mm256_storeu_ps(&s[2 * stride], m_y_0);
+      _mm256_storeu_ps(&s[3 * stride], m_y_1);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+      lo[i] = _mm256_castps256_ps128(v[i]);
+      hi[i] = _mm256_extractf128_ps(v[i], 1);
+    }
+    _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+    _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+    for (int i = 0; i < 4; ++i) {
+      _mm_storeu_ps(&channels[i][k], lo[i]);
+      _mm_storeu_ps(&channels[i + 4][k], hi[i]);
+    }
+  }
+}
+
+}  // namespace webrtc
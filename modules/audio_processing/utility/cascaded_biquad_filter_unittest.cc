@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/utility/cascaded_biquad_filter.h"
 
+#include <cmath>
+#include <memory>
 #include <vector>
 
 #include "test/gtest.h"
@@ -40,6 +42,27 @@ std::vector<float> CreateInputWithIncreasingValues(size_t vector_length) {
   return v;
 }
 
+std::vector<CascadedBiQuadFilter::BiQuadParam> CreateBiQuadParams() {
+  return {CascadedBiQuadFilter::BiQuadParam({-1.0f, 0.0f},
+                                            {0.23146901f, 0.39514232f},
+                                            0.1866943331163784f),
+          CascadedBiQuadFilter::BiQuadParam({1.0f, 0.0f},
+                                            {0.72712179f, 0.21296904f},
+                                            0.75707637533388494f),
+          CascadedBiQuadFilter::BiQuadParam({1.0f, 0.0f},
+                                            {1.11022302e-16f, 0.71381051f},
+                                            0.2452372752527856f, true)};
+}
+
+// Creates a different deterministic signal for each channel.
+std::vector<float> CreateChannelInput(size_t channel, size_t length) {
+  std::vector<float> v(length);
+  for (size_t k = 0; k < v.size(); ++k) {
+    v[k] = 1000.f * std::sin(0.01f * (channel + 1) * k) + 10.f * channel;
+  }
+  return v;
+}
+
 }  // namespace
 
 // Verifies that the filter applies an effect which removes the input signal.
@@ -112,6 +135,85 @@ TEST(CascadedBiquadFilterDeathTest, InputSizeCheckVerification) {
 }
 #endif
 
+// Verifies that applying the biquads in blocks gives the same output as
+// applying them one by one on the whole signal.
+TEST(CascadedBiquadFilter, CascadeMatchesSeparateBiQuads) {
+  const auto params = CreateBiQuadParams();
+  CascadedBiQuadFilter cascade(params);
+  std::vector<std::unique_ptr<CascadedBiQuadFilter>> separate;
+  for (const auto& param : params) {
+    separate.push_back(std::make_unique<CascadedBiQuadFilter>(
+        std::vector<CascadedBiQuadFilter::BiQuadParam>(1, param)));
+  }
+
+  for (size_t length : {37, 160, 1, 64}) {
+    const std::vector<float> x = CreateChannelInput(0, length);
+    std::vector<float> y(length);
+    cascade.Process(x, y);
+    std::vector<float> y_separate = x;
+    for (auto& filter : separate) {
+      filter->Process(y_separate);
+    }
+    EXPECT_EQ(y, y_separate);
+  }
+}
+
+// Verifies that the multi-channel filter is bit-exact with one filter per
+// channel for channel counts that use all the vectorized group sizes and the
+// scalar remainder, and for frame counts that are not multiples of 4.
+TEST(MultiChannelCascadedBiquadFilter, MatchesSingleChannelFilters) {
+  for (size_t num_channels : {1, 2, 3, 4, 5, 8, 9, 12, 15}) {
+    SCOPED_TRACE(num_channels);
+    MultiChannelCascadedBiQuadFilter filter(CreateBiQuadParams(),
+                                            num_channels);
+    ASSERT_EQ(filter.num_channels(), num_channels);
+    std::vector<std::unique_ptr<CascadedBiQuadFilter>> reference;
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      reference.push_back(
+          std::make_unique<CascadedBiQuadFilter>(CreateBiQuadParams()));
+    }
+
+    for (size_t num_frames : {160, 37, 3, 64}) {
+      std::vector<std::vector<float>> y(num_channels);
+      std::vector<float*> channels(num_channels);
+      for (size_t ch = 0; ch < num_channels; ++ch) {
+        y[ch] = CreateChannelInput(ch, num_frames);
+        channels[ch] = y[ch].data();
+      }
+      filter.Process(channels, num_frames);
+      for (size_t ch = 0; ch < num_channels; ++ch) {
+        std::vector<float> y_reference = CreateChannelInput(ch, num_frames);
+        reference[ch]->Process(y_reference);
+        EXPECT_EQ(y[ch], y_reference);
+      }
+    }
+  }
+}
+
+// Verifies that the single-channel processing and the resets of the
+// multi-channel filter are consistent with those of a single-channel filter.
+TEST(MultiChannelCascadedBiquadFilter, ProcessChannelAndReset) {
+  constexpr size_t kNumChannels = 6;
+  MultiChannelCascadedBiQuadFilter filter(kHighPassFilterCoefficients, 2,
+                                          kNumChannels);
+  CascadedBiQuadFilter reference(kHighPassFilterCoefficients, 2);
+  for (int k = 0; k < 3; ++k) {
+    std::vector<float> y = CreateChannelInput(k, 100);
+    std::vector<float> y_reference = y;
+    filter.ProcessChannel(kNumChannels - 1, y);
+    reference.Process(y_reference);
+    EXPECT_EQ(y, y_reference);
+  }
+
+  filter.Reset();
+  reference.Reset();
+  std::vector<float> y = CreateChannelInput(4, 50);
+  std::vector<float> y_reference = y;
+  filter.ProcessChannel(kNumChannels - 1, y);
+  reference.Process(y_reference);
+  EXPECT_EQ(y, y_reference);
+}
+
 // Verifies the conversion from zero, pole, gain to filter coefficients for
 // lowpass filter.
 TEST(CascadedBiquadFilter, BiQuadParamLowPass) {
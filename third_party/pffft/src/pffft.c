@@ -62,7 +62,9 @@
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
+#if defined(_MSC_VER)
 #include <corecrt_math_defines.h>
+#endif
 
 /* detect compiler flavour */
 #if defined(_MSC_VER)